@@ -0,0 +1,386 @@
+//! @file
+//! @brief Logger module - Benchmark.
+//! @author Mariusz Ornowski (mariusz.ornowski@ict-project.pl)
+//! @version 1.0
+//! @date 2012-2021
+//! @copyright ICT-Project Mariusz Ornowski (ict-project.pl)
+/* **************************************************************
+Copyright (c) 2012-2021, ICT-Project Mariusz Ornowski (ict-project.pl)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+1. Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+3. Neither the name of the ICT-Project Mariusz Ornowski nor the names
+of its contributors may be used to endorse or promote products
+derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**************************************************************/
+//============================================
+#include "logger.hpp"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <filesystem>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+//============================================
+typedef std::function<void(std::size_t)> bench_fun_t;
+//! Opis testu.
+struct bench_t {
+  //! Nazwa testu (klucz w wynikach JSON).
+  std::string name;
+  //! Funkcja wykonująca zadaną liczbę operacji (jedna operacja to jedna linia lub jedna warstwa).
+  bench_fun_t fun;
+  //! Informacja, czy test jest wykonywany dla 1..N wątków.
+  bool scaling;
+  //! Ustawia wyjścia przed testem.
+  std::function<void()> setup;
+  //! Usuwa wyjścia po teście.
+  std::function<void()> teardown;
+};
+//! Wynik testu.
+struct result_t {
+  std::string name;
+  std::size_t threads;
+  //! Czas jednej operacji w wątku (ns).
+  double ns;
+  //! Liczba operacji na sekundę (wszystkie wątki).
+  double rate;
+};
+//! Bufor strumienia, który porzuca dane.
+class null_buffer:public std::streambuf {
+protected:
+  int overflow(int c){return(traits_type::not_eof(c));}
+  std::streamsize xsputn(const char *,std::streamsize n){return(n);}
+};
+//! Bufor strumienia, który porzuca dane, ale co 1024 zapisy zatrzymuje się na 200 us (np. zapis przez sieć).
+class stalling_buffer:public std::streambuf {
+private:
+  std::size_t writes=0;
+protected:
+  int overflow(int c){return(traits_type::not_eof(c));}
+  std::streamsize xsputn(const char *,std::streamsize n){
+    if (!(++writes%1024)) std::this_thread::sleep_for(std::chrono::microseconds(200));
+    return(n);
+  }
+};
+//! Wykonuje test w zadanej liczbie wątków i podaje czas wykonania (ns).
+static double run(std::size_t threads,std::size_t ops,const bench_fun_t & fun){
+  std::vector<std::thread> pool;
+  std::atomic<std::size_t> ready(0);
+  std::atomic<bool> go(false);
+  for (std::size_t t=0;t<threads;t++) pool.emplace_back([&fun,&ready,&go,ops]{
+    LOGGER_THREAD;
+    ready++;
+    while (!go.load()) std::this_thread::yield();
+    fun(ops);
+  });
+  while (ready.load()<threads) std::this_thread::yield();
+  //Pomiar nie obejmuje tworzenia wątków.
+  std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+  go.store(true);
+  for (std::thread & t: pool) t.join();
+  return(double(std::chrono::nanoseconds(std::chrono::steady_clock::now()-start).count()));
+}
+//! Linia zapisywana do wyjść.
+static void enabled(std::size_t ops){
+  for (std::size_t k=0;k<ops;k++){
+    LOGGER_INFO<<"Test "<<k<<std::endl;
+  }
+}
+//! Linia strukturalna zapisywana do wyjść.
+static void enabled_kv(std::size_t ops){
+  for (std::size_t k=0;k<ops;k++){
+    LOGGER_INFO_KV("Test","k",k,"name","bench");
+  }
+}
+//! Linia z ciągiem formatującym zapisywana do wyjść.
+static void enabled_f(std::size_t ops){
+  for (std::size_t k=0;k<ops;k++){
+    LOGGER_INFO_F("Test {}",k);
+  }
+}
+//! Linie na poziomie, który nie jest aktywny w warstwie.
+static void inactive(std::size_t ops){
+  LOGGER_L(ict::logger::notices,ict::logger::none,ict::logger::none);
+  for (std::size_t k=0;k<ops;k++){
+    LOGGER_DEBUG<<"Test "<<k<<std::endl;
+  }
+}
+//! Linie pomijane przez ograniczenie liczby linii na sekundę (przechodzi tylko pierwsza).
+static void rate_limited(std::size_t ops){
+  for (std::size_t k=0;k<ops;k++){
+    LOGGER_INFO_RATE(1)<<"Test "<<k<<std::endl;
+  }
+}
+//! Linie wyłączone w czasie kompilacji.
+static void compiled_out(std::size_t ops){
+  #include "disable-debug.hpp"
+  for (std::size_t k=0;k<ops;k++){
+    LOGGER_DEBUG<<"Test "<<k<<std::endl;
+  }
+  #include "enable-debug.hpp"
+}
+//! Warstwa, w której linie są buforowane i porzucane.
+static void layer(std::size_t ops){
+  for (std::size_t k=0;k<ops;k++){
+    LOGGER_LAYER;
+    LOGGER_DEBUG<<"Test "<<k<<std::endl;
+  }
+}
+//! Warstwa, w której nic nie jest logowane.
+static void layer_idle(std::size_t ops){
+  for (std::size_t k=0;k<ops;k++){
+    LOGGER_LAYER;
+  }
+}
+//! Warstwa z linią buforowaną z ciągiem formatującym (odroczoną), która nie jest zrzucana.
+static void layer_f(std::size_t ops){
+  for (std::size_t k=0;k<ops;k++){
+    LOGGER_LAYER;
+    LOGGER_DEBUG_F("Test {} of {} ({})",k,ops,0.5);
+  }
+}
+//! Warstwa z linią buforowaną ze strumienia (ta sama treść), która nie jest zrzucana.
+static void layer_stream(std::size_t ops){
+  for (std::size_t k=0;k<ops;k++){
+    LOGGER_LAYER;
+    LOGGER_DEBUG<<"Test "<<k<<" of "<<ops<<" ("<<0.5<<")"<<std::endl;
+  }
+}
+//! Warstwa, której bufor jest zrzucany (4 linie buforowane i błąd).
+static void layer_dump(std::size_t ops){
+  for (std::size_t k=0;k<ops;k++){
+    LOGGER_LAYER;
+    for (int i=0;i<4;i++) LOGGER_DEBUG<<"Test "<<k<<std::endl;
+    LOGGER_ERR<<"Test "<<k<<std::endl;
+  }
+}
+//! Odbiornik syslog (gniazdo lokalne i wątek, który je opróżnia).
+class SyslogReceiver {
+private:
+  std::string path;
+  int fd=-1;
+  std::atomic<bool> stop{false};
+  std::thread thread;
+public:
+  explicit SyslogReceiver(const std::string & path_in):path(path_in){
+    struct sockaddr_un addr;
+    struct timeval timeout{0,100000};
+    std::memset(&addr,0,sizeof(addr));
+    addr.sun_family=AF_UNIX;
+    std::strncpy(addr.sun_path,path.c_str(),sizeof(addr.sun_path)-1);
+    ::unlink(path.c_str());
+    fd=::socket(AF_UNIX,SOCK_DGRAM|SOCK_CLOEXEC,0);
+    if ((fd<0)||::bind(fd,(const struct sockaddr *)&addr,sizeof(addr))) return;
+    ::setsockopt(fd,SOL_SOCKET,SO_RCVTIMEO,&timeout,sizeof(timeout));
+    thread=std::thread([this]{
+      char buffer[4096];
+      while (!stop.load()) ::recv(fd,buffer,sizeof(buffer),0);
+    });
+  }
+  ~SyslogReceiver(){
+    stop.store(true);
+    if (thread.joinable()) thread.join();
+    if (0<=fd) ::close(fd);
+    ::unlink(path.c_str());
+  }
+};
+//! Czeka (najwyżej minutę), aż wszystkie pliki po rotacji w katalogu zostaną skompresowane.
+static void wait_compressed(const std::filesystem::path & dir){
+  for (int k=0;k<600;k++){
+    bool pending(false);
+    for (const std::filesystem::directory_entry & e: std::filesystem::directory_iterator(dir)){
+      const std::string name(e.path().filename().native());
+      if ((name!="bench.log")&&(name.size()>3)&&(name.compare(name.size()-3,3,".gz")!=0)) pending=true;
+    }
+    if (!pending) return;
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+}
+//! Zapisuje wyniki w postaci JSON.
+static void json(std::ostream & out,std::size_t ops,std::size_t repeat,const std::vector<result_t> & results,const ict::logger::stats_t & st){
+  out<<"{"<<std::endl;
+  out<<"  \"ops\": "<<ops<<","<<std::endl;
+  out<<"  \"repeat\": "<<repeat<<","<<std::endl;
+  out<<"  \"hardware_concurrency\": "<<std::thread::hardware_concurrency()<<","<<std::endl;
+  out<<"  \"results\": ["<<std::endl;
+  for (std::size_t k=0;k<results.size();k++){
+    const result_t & r(results[k]);
+    out<<"    {\"name\": \""<<r.name<<"\", \"threads\": "<<r.threads;
+    out<<std::fixed<<std::setprecision(1)<<", \"ns_per_op\": "<<r.ns<<", \"ops_per_s\": "<<std::setprecision(0)<<r.rate<<"}";
+    out<<((k+1<results.size())?",":"")<<std::endl;
+  }
+  out<<"  ],"<<std::endl;
+  out<<"  \"compression\": {\"files\": "<<st.compressed<<", \"in_bytes\": "<<st.compress_in<<", \"out_bytes\": "<<st.compress_out;
+  out<<std::fixed<<std::setprecision(2)<<", \"ratio\": "<<(st.compress_out?double(st.compress_in)/st.compress_out:0.0);
+  out<<std::setprecision(1)<<", \"cpu_ns_per_byte\": "<<(st.compress_in?double(st.compress_cpu)/st.compress_in:0.0)<<"}"<<std::endl;
+  out<<"}"<<std::endl;
+}
+//! Wykonuje wszystkie testy i zapisuje wyniki w postaci JSON (na standardowe wyjście lub do pliku podanego w opcji -o).
+int main(int argc,const char **argv){
+  std::size_t max_threads(2*std::thread::hardware_concurrency());
+  std::size_t ops(100000);
+  std::size_t repeat(3);
+  std::string output;
+  for (int k=1;k<argc;k++){
+    const std::string arg(argv[k]);
+    if ((k+1<argc)&&(arg=="-t")) max_threads=std::strtoull(argv[++k],nullptr,10);
+    else if ((k+1<argc)&&(arg=="-n")) ops=std::strtoull(argv[++k],nullptr,10);
+    else if ((k+1<argc)&&(arg=="-r")) repeat=std::strtoull(argv[++k],nullptr,10);
+    else if ((k+1<argc)&&(arg=="-o")) output=argv[++k];
+    else {
+      std::cerr<<"usage: "<<argv[0]<<" [-t max_threads] [-n ops] [-r repeat] [-o file.json]"<<std::endl;
+      return(2);
+    }
+  }
+  if (max_threads<4) max_threads=4;
+  if (!ops) ops=1;
+  if (!repeat) repeat=1;
+  const std::filesystem::path dir(std::filesystem::temp_directory_path()/("libict-logger-bench-"+std::to_string(::getpid())));
+  const std::string file((dir/"bench.log").native());
+  const std::string recorder((dir/"bench.rec").native());
+  const std::string socket((dir/"bench.sock").native());
+  const std::filesystem::path rotate_dir(dir/"rotate");
+  const std::filesystem::path gz_dir(dir/"gz");
+  ict::logger::output::file_options_t rotate;
+  ict::logger::output::file_options_t gz;
+  rotate.max_size=1024*1024;
+  gz.max_size=1024*1024;
+  gz.compress=6;
+  std::filesystem::create_directories(rotate_dir);
+  std::filesystem::create_directories(gz_dir);
+  null_buffer null;
+  std::ostream null_stream(&null);
+  stalling_buffer stalling;
+  std::ostream stalling_stream(&stalling);
+  ict::logger::output::flush_policy_t queued;
+  queued.queue=4096;
+  ict::logger::output::flush_policy_t shedding(queued);
+  shedding.overload=ict::logger::output::overload_drop_severity;
+  std::stringstream string_stream;
+  std::unique_ptr<SyslogReceiver> receiver;
+  ict::logger::output::syslog_options_t syslog;
+  syslog.path=socket;
+  LOGGER_SET(std::cerr,ict::logger::none);
+  LOGGER_SET(std::cout,ict::logger::none);
+  auto none=[]{};
+  auto null_set=[&null_stream]{LOGGER_SET(null_stream);};
+  auto null_unset=[&null_stream]{LOGGER_SET(null_stream,ict::logger::none);};
+  const std::vector<bench_t> benches({
+    {"enabled_line",enabled,true,null_set,null_unset},
+    {"disabled_line",inactive,true,null_set,null_unset},
+    {"compiled_out_line",compiled_out,false,null_set,null_unset},
+    {"rate_limited_line",rate_limited,true,null_set,null_unset},
+    {"layer_idle",layer_idle,true,null_set,null_unset},
+    {"layer",layer,true,null_set,null_unset},
+    {"layer_stream",layer_stream,false,null_set,null_unset},
+    {"layer_f",layer_f,false,null_set,null_unset},
+    {"layer_f_immediate",layer_f,false,
+      [&null_stream]{LOGGER_SET(null_stream);LOGGER_DEFERRED(false);},
+      [&null_stream]{LOGGER_DEFERRED(true);LOGGER_SET(null_stream,ict::logger::none);}},
+    {"layer_dump",layer_dump,true,null_set,null_unset},
+    {"sink_none",enabled,false,none,none},
+    {"sink_null_stream",enabled,false,null_set,null_unset},
+    {"sink_stringstream",enabled,false,
+      [&string_stream]{string_stream.str("");LOGGER_SET(string_stream);},
+      [&string_stream]{LOGGER_SET(string_stream,ict::logger::none);string_stream.str("");}},
+    {"sink_stalling",enabled,false,
+      [&null_stream,&stalling_stream]{LOGGER_SET(null_stream);LOGGER_SET(stalling_stream);},
+      [&null_stream,&stalling_stream]{LOGGER_SET(stalling_stream,ict::logger::none);LOGGER_SET(null_stream,ict::logger::none);}},
+    {"sink_stalling_queue",enabled,false,
+      [&null_stream,&stalling_stream,&queued]{LOGGER_SET(null_stream);LOGGER_SET(stalling_stream,ict::logger::all,queued);},
+      [&null_stream,&stalling_stream]{LOGGER_SET(stalling_stream,ict::logger::none);LOGGER_SET(null_stream,ict::logger::none);}},
+    {"sink_stalling_drop",enabled,false,
+      [&null_stream,&stalling_stream,&shedding]{LOGGER_SET(null_stream);LOGGER_SET(stalling_stream,ict::logger::all,shedding);},
+      [&null_stream,&stalling_stream]{LOGGER_SET(stalling_stream,ict::logger::none);LOGGER_SET(null_stream,ict::logger::none);}},
+    {"sink_binary",enabled,false,
+      [&null_stream]{LOGGER_BINARY(null_stream);},
+      [&null_stream]{LOGGER_BINARY(null_stream,ict::logger::none);}},
+    {"sink_json",enabled,false,
+      [&null_stream]{LOGGER_JSON(null_stream);},
+      [&null_stream]{LOGGER_JSON(null_stream,ict::logger::none);}},
+    {"sink_json_f",enabled_f,false,
+      [&null_stream]{LOGGER_JSON(null_stream);},
+      [&null_stream]{LOGGER_JSON(null_stream,ict::logger::none);}},
+    {"sink_json_kv",enabled_kv,false,
+      [&null_stream]{LOGGER_JSON(null_stream);},
+      [&null_stream]{LOGGER_JSON(null_stream,ict::logger::none);}},
+    {"sink_file",enabled,false,
+      [&file]{std::filesystem::remove(file);LOGGER_FILE(file);},
+      [&file]{LOGGER_FILE(file,ict::logger::none);std::filesystem::remove(file);}},
+    {"sink_file_rotate",enabled,false,
+      [&rotate_dir,&rotate]{LOGGER_FILE((rotate_dir/"bench.log").native(),ict::logger::all,rotate);},
+      [&rotate_dir]{LOGGER_FILE((rotate_dir/"bench.log").native(),ict::logger::none);}},
+    {"sink_file_rotate_gz",enabled,false,
+      [&gz_dir,&gz]{LOGGER_FILE((gz_dir/"bench.log").native(),ict::logger::all,gz);},
+      [&gz_dir]{LOGGER_FILE((gz_dir/"bench.log").native(),ict::logger::none);}},
+    {"sink_recorder",enabled,false,
+      [&recorder]{LOGGER_RECORDER(recorder);},
+      [&recorder]{LOGGER_RECORDER(recorder,ict::logger::none);std::filesystem::remove(recorder);}},
+    {"sink_syslog",enabled,false,
+      [&receiver,&socket,&syslog]{receiver.reset(new SyslogReceiver(socket));LOGGER_SYSLOG("bench",ict::logger::all,syslog);},
+      [&receiver]{LOGGER_SYSLOG("bench",ict::logger::none);receiver.reset();}}
+  });
+  std::vector<result_t> results;
+  for (const bench_t & b: benches){
+    for (std::size_t threads=1;threads<=(b.scaling?max_threads:1);threads*=2){
+      double best(0);
+      b.setup();
+      run(threads,ops/10+1,b.fun);//Rozgrzewka.
+      for (std::size_t r=0;r<repeat;r++){//Najkrótszy z powtórzonych pomiarów.
+        const double time(run(threads,ops,b.fun));
+        if (!r||(time<best)) best=time;
+      }
+      b.teardown();
+      results.push_back({b.name,threads,best/ops,threads*ops*1e9/best});
+      std::cerr<<std::setw(20)<<b.name<<std::setw(6)<<threads<<std::setw(12)<<std::fixed<<std::setprecision(1)<<(best/ops)<<" ns"<<std::endl;
+    }
+  }
+  //Kompresja plików po rotacji (sink_file_rotate_gz) jest wykonywana w tle - pomiar po jej zakończeniu.
+  wait_compressed(gz_dir);
+  const ict::logger::stats_t st(ict::logger::stats());
+  std::cerr<<std::setw(20)<<"compression"<<std::setw(6)<<st.compressed<<std::setw(12)<<std::fixed<<std::setprecision(2);
+  std::cerr<<(st.compress_out?double(st.compress_in)/st.compress_out:0.0)<<" ratio"<<std::setw(8)<<std::setprecision(1)<<(st.compress_in?double(st.compress_cpu)/st.compress_in:0.0)<<" ns/B"<<std::endl;
+  std::filesystem::remove_all(dir);
+  if (output.empty()){
+    json(std::cout,ops,repeat,results,st);
+  } else {
+    std::ofstream out(output);
+    json(out,ops,repeat,results,st);
+    if (!out) {
+      std::cerr<<output<<": cannot write file"<<std::endl;
+      return(1);
+    }
+  }
+  return(0);
+}
+//===========================================
@@ -1,5 +1,31 @@
+#include "levels.hpp"
 #ifdef LOGGER_CRIT
 #undef LOGGER_CRIT
 #endif
+#ifdef LOGGER_CRIT_EVERY_N
+#undef LOGGER_CRIT_EVERY_N
+#endif
+#ifdef LOGGER_CRIT_FIRST_N
+#undef LOGGER_CRIT_FIRST_N
+#endif
+#ifdef LOGGER_CRIT_RATE
+#undef LOGGER_CRIT_RATE
+#endif
+#ifdef LOGGER_CRIT_KV
+#undef LOGGER_CRIT_KV
+#endif
+#ifdef LOGGER_CRIT_F
+#undef LOGGER_CRIT_F
+#endif
 //!Strumień wejściowy (char) dla poziomu CRITICAL w najwyższej warstwie logowania dla danego wątku.
-#define LOGGER_CRIT ict::logger::input::dummy()
\ No newline at end of file
+#define LOGGER_CRIT __LOGGER_DISABLED__
+//!Strumień wejściowy (char) dla poziomu CRITICAL co n-te wywołanie - wyłączony.
+#define LOGGER_CRIT_EVERY_N(n) __LOGGER_DISABLED__
+//!Strumień wejściowy (char) dla poziomu CRITICAL tylko dla n pierwszych wywołań - wyłączony.
+#define LOGGER_CRIT_FIRST_N(n) __LOGGER_DISABLED__
+//!Strumień wejściowy (char) dla poziomu CRITICAL z ograniczeniem liczby linii na sekundę - wyłączony.
+#define LOGGER_CRIT_RATE(per_sec) __LOGGER_DISABLED__
+//!Linia strukturalna dla poziomu CRITICAL - wyłączona.
+#define LOGGER_CRIT_KV(...) __LOGGER_DISABLED__
+//!Linia z ciągiem formatującym dla poziomu CRITICAL - wyłączona.
+#define LOGGER_CRIT_F(...) __LOGGER_DISABLED__
\ No newline at end of file
@@ -1,5 +1,31 @@
+#include "levels.hpp"
 #ifdef LOGGER_DEBUG
 #undef LOGGER_DEBUG
 #endif
+#ifdef LOGGER_DEBUG_EVERY_N
+#undef LOGGER_DEBUG_EVERY_N
+#endif
+#ifdef LOGGER_DEBUG_FIRST_N
+#undef LOGGER_DEBUG_FIRST_N
+#endif
+#ifdef LOGGER_DEBUG_RATE
+#undef LOGGER_DEBUG_RATE
+#endif
+#ifdef LOGGER_DEBUG_KV
+#undef LOGGER_DEBUG_KV
+#endif
+#ifdef LOGGER_DEBUG_F
+#undef LOGGER_DEBUG_F
+#endif
 //!Strumień wejściowy (char) dla poziomu DEBUG w najwyższej warstwie logowania dla danego wątku.
-#define LOGGER_DEBUG ict::logger::input::dummy()
\ No newline at end of file
+#define LOGGER_DEBUG __LOGGER_DISABLED__
+//!Strumień wejściowy (char) dla poziomu DEBUG co n-te wywołanie - wyłączony.
+#define LOGGER_DEBUG_EVERY_N(n) __LOGGER_DISABLED__
+//!Strumień wejściowy (char) dla poziomu DEBUG tylko dla n pierwszych wywołań - wyłączony.
+#define LOGGER_DEBUG_FIRST_N(n) __LOGGER_DISABLED__
+//!Strumień wejściowy (char) dla poziomu DEBUG z ograniczeniem liczby linii na sekundę - wyłączony.
+#define LOGGER_DEBUG_RATE(per_sec) __LOGGER_DISABLED__
+//!Linia strukturalna dla poziomu DEBUG - wyłączona.
+#define LOGGER_DEBUG_KV(...) __LOGGER_DISABLED__
+//!Linia z ciągiem formatującym dla poziomu DEBUG - wyłączona.
+#define LOGGER_DEBUG_F(...) __LOGGER_DISABLED__
\ No newline at end of file
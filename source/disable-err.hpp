@@ -1,5 +1,31 @@
+#include "levels.hpp"
 #ifdef LOGGER_ERR
 #undef LOGGER_ERR
 #endif
+#ifdef LOGGER_ERR_EVERY_N
+#undef LOGGER_ERR_EVERY_N
+#endif
+#ifdef LOGGER_ERR_FIRST_N
+#undef LOGGER_ERR_FIRST_N
+#endif
+#ifdef LOGGER_ERR_RATE
+#undef LOGGER_ERR_RATE
+#endif
+#ifdef LOGGER_ERR_KV
+#undef LOGGER_ERR_KV
+#endif
+#ifdef LOGGER_ERR_F
+#undef LOGGER_ERR_F
+#endif
 //!Strumień wejściowy (char) dla poziomu ERROR w najwyższej warstwie logowania dla danego wątku.
-#define LOGGER_ERR ict::logger::input::dummy()
\ No newline at end of file
+#define LOGGER_ERR __LOGGER_DISABLED__
+//!Strumień wejściowy (char) dla poziomu ERROR co n-te wywołanie - wyłączony.
+#define LOGGER_ERR_EVERY_N(n) __LOGGER_DISABLED__
+//!Strumień wejściowy (char) dla poziomu ERROR tylko dla n pierwszych wywołań - wyłączony.
+#define LOGGER_ERR_FIRST_N(n) __LOGGER_DISABLED__
+//!Strumień wejściowy (char) dla poziomu ERROR z ograniczeniem liczby linii na sekundę - wyłączony.
+#define LOGGER_ERR_RATE(per_sec) __LOGGER_DISABLED__
+//!Linia strukturalna dla poziomu ERROR - wyłączona.
+#define LOGGER_ERR_KV(...) __LOGGER_DISABLED__
+//!Linia z ciągiem formatującym dla poziomu ERROR - wyłączona.
+#define LOGGER_ERR_F(...) __LOGGER_DISABLED__
\ No newline at end of file
@@ -1,5 +1,31 @@
+#include "levels.hpp"
 #ifdef LOGGER_INFO
 #undef LOGGER_INFO
 #endif
+#ifdef LOGGER_INFO_EVERY_N
+#undef LOGGER_INFO_EVERY_N
+#endif
+#ifdef LOGGER_INFO_FIRST_N
+#undef LOGGER_INFO_FIRST_N
+#endif
+#ifdef LOGGER_INFO_RATE
+#undef LOGGER_INFO_RATE
+#endif
+#ifdef LOGGER_INFO_KV
+#undef LOGGER_INFO_KV
+#endif
+#ifdef LOGGER_INFO_F
+#undef LOGGER_INFO_F
+#endif
 //!Strumień wejściowy (char) dla poziomu INFO w najwyższej warstwie logowania dla danego wątku.
-#define LOGGER_INFO ict::logger::input::dummy()
\ No newline at end of file
+#define LOGGER_INFO __LOGGER_DISABLED__
+//!Strumień wejściowy (char) dla poziomu INFO co n-te wywołanie - wyłączony.
+#define LOGGER_INFO_EVERY_N(n) __LOGGER_DISABLED__
+//!Strumień wejściowy (char) dla poziomu INFO tylko dla n pierwszych wywołań - wyłączony.
+#define LOGGER_INFO_FIRST_N(n) __LOGGER_DISABLED__
+//!Strumień wejściowy (char) dla poziomu INFO z ograniczeniem liczby linii na sekundę - wyłączony.
+#define LOGGER_INFO_RATE(per_sec) __LOGGER_DISABLED__
+//!Linia strukturalna dla poziomu INFO - wyłączona.
+#define LOGGER_INFO_KV(...) __LOGGER_DISABLED__
+//!Linia z ciągiem formatującym dla poziomu INFO - wyłączona.
+#define LOGGER_INFO_F(...) __LOGGER_DISABLED__
\ No newline at end of file
@@ -1,5 +1,31 @@
+#include "levels.hpp"
 #ifdef LOGGER_NOTICE
 #undef LOGGER_NOTICE
 #endif
+#ifdef LOGGER_NOTICE_EVERY_N
+#undef LOGGER_NOTICE_EVERY_N
+#endif
+#ifdef LOGGER_NOTICE_FIRST_N
+#undef LOGGER_NOTICE_FIRST_N
+#endif
+#ifdef LOGGER_NOTICE_RATE
+#undef LOGGER_NOTICE_RATE
+#endif
+#ifdef LOGGER_NOTICE_KV
+#undef LOGGER_NOTICE_KV
+#endif
+#ifdef LOGGER_NOTICE_F
+#undef LOGGER_NOTICE_F
+#endif
 //!Strumień wejściowy (char) dla poziomu NOTICE_ w najwyższej warstwie logowania dla danego wątku.
-#define LOGGER_NOTICE ict::logger::input::dummy()
\ No newline at end of file
+#define LOGGER_NOTICE __LOGGER_DISABLED__
+//!Strumień wejściowy (char) dla poziomu NOTICE co n-te wywołanie - wyłączony.
+#define LOGGER_NOTICE_EVERY_N(n) __LOGGER_DISABLED__
+//!Strumień wejściowy (char) dla poziomu NOTICE tylko dla n pierwszych wywołań - wyłączony.
+#define LOGGER_NOTICE_FIRST_N(n) __LOGGER_DISABLED__
+//!Strumień wejściowy (char) dla poziomu NOTICE z ograniczeniem liczby linii na sekundę - wyłączony.
+#define LOGGER_NOTICE_RATE(per_sec) __LOGGER_DISABLED__
+//!Linia strukturalna dla poziomu NOTICE - wyłączona.
+#define LOGGER_NOTICE_KV(...) __LOGGER_DISABLED__
+//!Linia z ciągiem formatującym dla poziomu NOTICE - wyłączona.
+#define LOGGER_NOTICE_F(...) __LOGGER_DISABLED__
\ No newline at end of file
@@ -1,5 +1,31 @@
+#include "levels.hpp"
 #ifdef LOGGER_WARN
 #undef LOGGER_WARN
 #endif
+#ifdef LOGGER_WARN_EVERY_N
+#undef LOGGER_WARN_EVERY_N
+#endif
+#ifdef LOGGER_WARN_FIRST_N
+#undef LOGGER_WARN_FIRST_N
+#endif
+#ifdef LOGGER_WARN_RATE
+#undef LOGGER_WARN_RATE
+#endif
+#ifdef LOGGER_WARN_KV
+#undef LOGGER_WARN_KV
+#endif
+#ifdef LOGGER_WARN_F
+#undef LOGGER_WARN_F
+#endif
 //!Strumień wejściowy (char) dla poziomu WARNING_ w najwyższej warstwie logowania dla danego wątku.
-#define LOGGER_WARN ict::logger::input::dummy()
\ No newline at end of file
+#define LOGGER_WARN __LOGGER_DISABLED__
+//!Strumień wejściowy (char) dla poziomu WARNING co n-te wywołanie - wyłączony.
+#define LOGGER_WARN_EVERY_N(n) __LOGGER_DISABLED__
+//!Strumień wejściowy (char) dla poziomu WARNING tylko dla n pierwszych wywołań - wyłączony.
+#define LOGGER_WARN_FIRST_N(n) __LOGGER_DISABLED__
+//!Strumień wejściowy (char) dla poziomu WARNING z ograniczeniem liczby linii na sekundę - wyłączony.
+#define LOGGER_WARN_RATE(per_sec) __LOGGER_DISABLED__
+//!Linia strukturalna dla poziomu WARNING - wyłączona.
+#define LOGGER_WARN_KV(...) __LOGGER_DISABLED__
+//!Linia z ciągiem formatującym dla poziomu WARNING - wyłączona.
+#define LOGGER_WARN_F(...) __LOGGER_DISABLED__
\ No newline at end of file
@@ -1,5 +1,46 @@
+#include "levels.hpp"
 #ifdef LOGGER_CRIT
 #undef LOGGER_CRIT
 #endif
+#ifdef LOGGER_CRIT_EVERY_N
+#undef LOGGER_CRIT_EVERY_N
+#endif
+#ifdef LOGGER_CRIT_FIRST_N
+#undef LOGGER_CRIT_FIRST_N
+#endif
+#ifdef LOGGER_CRIT_RATE
+#undef LOGGER_CRIT_RATE
+#endif
+#ifdef LOGGER_CRIT_KV
+#undef LOGGER_CRIT_KV
+#endif
+#ifdef LOGGER_CRIT_F
+#undef LOGGER_CRIT_F
+#endif
+#if LOGGER_MIN_LEVEL>LOGGER_LEVEL_CRIT
+//!Strumień wejściowy (char) dla poziomu CRITICAL - wyłączony w czasie kompilacji (LOGGER_MIN_LEVEL).
+#define LOGGER_CRIT __LOGGER_DISABLED__
+//!Strumień wejściowy (char) dla poziomu CRITICAL co n-te wywołanie - wyłączony.
+#define LOGGER_CRIT_EVERY_N(n) __LOGGER_DISABLED__
+//!Strumień wejściowy (char) dla poziomu CRITICAL tylko dla n pierwszych wywołań - wyłączony.
+#define LOGGER_CRIT_FIRST_N(n) __LOGGER_DISABLED__
+//!Strumień wejściowy (char) dla poziomu CRITICAL z ograniczeniem liczby linii na sekundę - wyłączony.
+#define LOGGER_CRIT_RATE(per_sec) __LOGGER_DISABLED__
+//!Linia strukturalna dla poziomu CRITICAL - wyłączona.
+#define LOGGER_CRIT_KV(...) __LOGGER_DISABLED__
+//!Linia z ciągiem formatującym dla poziomu CRITICAL - wyłączona.
+#define LOGGER_CRIT_F(...) __LOGGER_DISABLED__
+#else
 //!Strumień wejściowy (char) dla poziomu CRITICAL w najwyższej warstwie logowania dla danego wątku.
-#define LOGGER_CRIT ict::logger::input::ostream(ict::logger::critical)
\ No newline at end of file
+#define LOGGER_CRIT __LOGGER_STREAM__(ict::logger::critical)
+//!Strumień wejściowy (char) dla poziomu CRITICAL co n-te wywołanie w danym miejscu w kodzie (pozostałe wywołania są pomijane razem z argumentami).
+#define LOGGER_CRIT_EVERY_N(n) __LOGGER_EVERY_N__(ict::logger::critical,n)
+//!Strumień wejściowy (char) dla poziomu CRITICAL tylko dla n pierwszych wywołań w danym miejscu w kodzie.
+#define LOGGER_CRIT_FIRST_N(n) __LOGGER_FIRST_N__(ict::logger::critical,n)
+//!Strumień wejściowy (char) dla poziomu CRITICAL z ograniczeniem liczby linii na sekundę w danym miejscu w kodzie.
+#define LOGGER_CRIT_RATE(per_sec) __LOGGER_RATE__(ict::logger::critical,per_sec)
+//!Linia strukturalna dla poziomu CRITICAL (treść i pary nazwa-wartość) w najwyższej warstwie logowania dla danego wątku.
+#define LOGGER_CRIT_KV(...) __LOGGER_KV__(ict::logger::critical,__VA_ARGS__)
+//!Linia z ciągiem formatującym ({} - miejsce na argument, sprawdzane w czasie kompilacji) dla poziomu CRITICAL w najwyższej warstwie logowania dla danego wątku.
+#define LOGGER_CRIT_F(...) __LOGGER_FORMAT__(ict::logger::critical,__VA_ARGS__)
+#endif
\ No newline at end of file
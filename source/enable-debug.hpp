@@ -1,5 +1,46 @@
+#include "levels.hpp"
 #ifdef LOGGER_DEBUG
 #undef LOGGER_DEBUG
 #endif
+#ifdef LOGGER_DEBUG_EVERY_N
+#undef LOGGER_DEBUG_EVERY_N
+#endif
+#ifdef LOGGER_DEBUG_FIRST_N
+#undef LOGGER_DEBUG_FIRST_N
+#endif
+#ifdef LOGGER_DEBUG_RATE
+#undef LOGGER_DEBUG_RATE
+#endif
+#ifdef LOGGER_DEBUG_KV
+#undef LOGGER_DEBUG_KV
+#endif
+#ifdef LOGGER_DEBUG_F
+#undef LOGGER_DEBUG_F
+#endif
+#if LOGGER_MIN_LEVEL>LOGGER_LEVEL_DEBUG
+//!Strumień wejściowy (char) dla poziomu DEBUG - wyłączony w czasie kompilacji (LOGGER_MIN_LEVEL).
+#define LOGGER_DEBUG __LOGGER_DISABLED__
+//!Strumień wejściowy (char) dla poziomu DEBUG co n-te wywołanie - wyłączony.
+#define LOGGER_DEBUG_EVERY_N(n) __LOGGER_DISABLED__
+//!Strumień wejściowy (char) dla poziomu DEBUG tylko dla n pierwszych wywołań - wyłączony.
+#define LOGGER_DEBUG_FIRST_N(n) __LOGGER_DISABLED__
+//!Strumień wejściowy (char) dla poziomu DEBUG z ograniczeniem liczby linii na sekundę - wyłączony.
+#define LOGGER_DEBUG_RATE(per_sec) __LOGGER_DISABLED__
+//!Linia strukturalna dla poziomu DEBUG - wyłączona.
+#define LOGGER_DEBUG_KV(...) __LOGGER_DISABLED__
+//!Linia z ciągiem formatującym dla poziomu DEBUG - wyłączona.
+#define LOGGER_DEBUG_F(...) __LOGGER_DISABLED__
+#else
 //!Strumień wejściowy (char) dla poziomu DEBUG w najwyższej warstwie logowania dla danego wątku.
-#define LOGGER_DEBUG ict::logger::input::ostream(ict::logger::debug)
\ No newline at end of file
+#define LOGGER_DEBUG __LOGGER_STREAM__(ict::logger::debug)
+//!Strumień wejściowy (char) dla poziomu DEBUG co n-te wywołanie w danym miejscu w kodzie (pozostałe wywołania są pomijane razem z argumentami).
+#define LOGGER_DEBUG_EVERY_N(n) __LOGGER_EVERY_N__(ict::logger::debug,n)
+//!Strumień wejściowy (char) dla poziomu DEBUG tylko dla n pierwszych wywołań w danym miejscu w kodzie.
+#define LOGGER_DEBUG_FIRST_N(n) __LOGGER_FIRST_N__(ict::logger::debug,n)
+//!Strumień wejściowy (char) dla poziomu DEBUG z ograniczeniem liczby linii na sekundę w danym miejscu w kodzie.
+#define LOGGER_DEBUG_RATE(per_sec) __LOGGER_RATE__(ict::logger::debug,per_sec)
+//!Linia strukturalna dla poziomu DEBUG (treść i pary nazwa-wartość) w najwyższej warstwie logowania dla danego wątku.
+#define LOGGER_DEBUG_KV(...) __LOGGER_KV__(ict::logger::debug,__VA_ARGS__)
+//!Linia z ciągiem formatującym ({} - miejsce na argument, sprawdzane w czasie kompilacji) dla poziomu DEBUG w najwyższej warstwie logowania dla danego wątku.
+#define LOGGER_DEBUG_F(...) __LOGGER_FORMAT__(ict::logger::debug,__VA_ARGS__)
+#endif
\ No newline at end of file
@@ -1,5 +1,46 @@
+#include "levels.hpp"
 #ifdef LOGGER_ERR
 #undef LOGGER_ERR
 #endif
+#ifdef LOGGER_ERR_EVERY_N
+#undef LOGGER_ERR_EVERY_N
+#endif
+#ifdef LOGGER_ERR_FIRST_N
+#undef LOGGER_ERR_FIRST_N
+#endif
+#ifdef LOGGER_ERR_RATE
+#undef LOGGER_ERR_RATE
+#endif
+#ifdef LOGGER_ERR_KV
+#undef LOGGER_ERR_KV
+#endif
+#ifdef LOGGER_ERR_F
+#undef LOGGER_ERR_F
+#endif
+#if LOGGER_MIN_LEVEL>LOGGER_LEVEL_ERR
+//!Strumień wejściowy (char) dla poziomu ERROR - wyłączony w czasie kompilacji (LOGGER_MIN_LEVEL).
+#define LOGGER_ERR __LOGGER_DISABLED__
+//!Strumień wejściowy (char) dla poziomu ERROR co n-te wywołanie - wyłączony.
+#define LOGGER_ERR_EVERY_N(n) __LOGGER_DISABLED__
+//!Strumień wejściowy (char) dla poziomu ERROR tylko dla n pierwszych wywołań - wyłączony.
+#define LOGGER_ERR_FIRST_N(n) __LOGGER_DISABLED__
+//!Strumień wejściowy (char) dla poziomu ERROR z ograniczeniem liczby linii na sekundę - wyłączony.
+#define LOGGER_ERR_RATE(per_sec) __LOGGER_DISABLED__
+//!Linia strukturalna dla poziomu ERROR - wyłączona.
+#define LOGGER_ERR_KV(...) __LOGGER_DISABLED__
+//!Linia z ciągiem formatującym dla poziomu ERROR - wyłączona.
+#define LOGGER_ERR_F(...) __LOGGER_DISABLED__
+#else
 //!Strumień wejściowy (char) dla poziomu ERROR w najwyższej warstwie logowania dla danego wątku.
-#define LOGGER_ERR ict::logger::input::ostream(ict::logger::error)
\ No newline at end of file
+#define LOGGER_ERR __LOGGER_STREAM__(ict::logger::error)
+//!Strumień wejściowy (char) dla poziomu ERROR co n-te wywołanie w danym miejscu w kodzie (pozostałe wywołania są pomijane razem z argumentami).
+#define LOGGER_ERR_EVERY_N(n) __LOGGER_EVERY_N__(ict::logger::error,n)
+//!Strumień wejściowy (char) dla poziomu ERROR tylko dla n pierwszych wywołań w danym miejscu w kodzie.
+#define LOGGER_ERR_FIRST_N(n) __LOGGER_FIRST_N__(ict::logger::error,n)
+//!Strumień wejściowy (char) dla poziomu ERROR z ograniczeniem liczby linii na sekundę w danym miejscu w kodzie.
+#define LOGGER_ERR_RATE(per_sec) __LOGGER_RATE__(ict::logger::error,per_sec)
+//!Linia strukturalna dla poziomu ERROR (treść i pary nazwa-wartość) w najwyższej warstwie logowania dla danego wątku.
+#define LOGGER_ERR_KV(...) __LOGGER_KV__(ict::logger::error,__VA_ARGS__)
+//!Linia z ciągiem formatującym ({} - miejsce na argument, sprawdzane w czasie kompilacji) dla poziomu ERROR w najwyższej warstwie logowania dla danego wątku.
+#define LOGGER_ERR_F(...) __LOGGER_FORMAT__(ict::logger::error,__VA_ARGS__)
+#endif
\ No newline at end of file
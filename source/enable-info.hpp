@@ -1,5 +1,46 @@
+#include "levels.hpp"
 #ifdef LOGGER_INFO
 #undef LOGGER_INFO
 #endif
+#ifdef LOGGER_INFO_EVERY_N
+#undef LOGGER_INFO_EVERY_N
+#endif
+#ifdef LOGGER_INFO_FIRST_N
+#undef LOGGER_INFO_FIRST_N
+#endif
+#ifdef LOGGER_INFO_RATE
+#undef LOGGER_INFO_RATE
+#endif
+#ifdef LOGGER_INFO_KV
+#undef LOGGER_INFO_KV
+#endif
+#ifdef LOGGER_INFO_F
+#undef LOGGER_INFO_F
+#endif
+#if LOGGER_MIN_LEVEL>LOGGER_LEVEL_INFO
+//!Strumień wejściowy (char) dla poziomu INFO - wyłączony w czasie kompilacji (LOGGER_MIN_LEVEL).
+#define LOGGER_INFO __LOGGER_DISABLED__
+//!Strumień wejściowy (char) dla poziomu INFO co n-te wywołanie - wyłączony.
+#define LOGGER_INFO_EVERY_N(n) __LOGGER_DISABLED__
+//!Strumień wejściowy (char) dla poziomu INFO tylko dla n pierwszych wywołań - wyłączony.
+#define LOGGER_INFO_FIRST_N(n) __LOGGER_DISABLED__
+//!Strumień wejściowy (char) dla poziomu INFO z ograniczeniem liczby linii na sekundę - wyłączony.
+#define LOGGER_INFO_RATE(per_sec) __LOGGER_DISABLED__
+//!Linia strukturalna dla poziomu INFO - wyłączona.
+#define LOGGER_INFO_KV(...) __LOGGER_DISABLED__
+//!Linia z ciągiem formatującym dla poziomu INFO - wyłączona.
+#define LOGGER_INFO_F(...) __LOGGER_DISABLED__
+#else
 //!Strumień wejściowy (char) dla poziomu INFO w najwyższej warstwie logowania dla danego wątku.
-#define LOGGER_INFO ict::logger::input::ostream(ict::logger::info)
\ No newline at end of file
+#define LOGGER_INFO __LOGGER_STREAM__(ict::logger::info)
+//!Strumień wejściowy (char) dla poziomu INFO co n-te wywołanie w danym miejscu w kodzie (pozostałe wywołania są pomijane razem z argumentami).
+#define LOGGER_INFO_EVERY_N(n) __LOGGER_EVERY_N__(ict::logger::info,n)
+//!Strumień wejściowy (char) dla poziomu INFO tylko dla n pierwszych wywołań w danym miejscu w kodzie.
+#define LOGGER_INFO_FIRST_N(n) __LOGGER_FIRST_N__(ict::logger::info,n)
+//!Strumień wejściowy (char) dla poziomu INFO z ograniczeniem liczby linii na sekundę w danym miejscu w kodzie.
+#define LOGGER_INFO_RATE(per_sec) __LOGGER_RATE__(ict::logger::info,per_sec)
+//!Linia strukturalna dla poziomu INFO (treść i pary nazwa-wartość) w najwyższej warstwie logowania dla danego wątku.
+#define LOGGER_INFO_KV(...) __LOGGER_KV__(ict::logger::info,__VA_ARGS__)
+//!Linia z ciągiem formatującym ({} - miejsce na argument, sprawdzane w czasie kompilacji) dla poziomu INFO w najwyższej warstwie logowania dla danego wątku.
+#define LOGGER_INFO_F(...) __LOGGER_FORMAT__(ict::logger::info,__VA_ARGS__)
+#endif
\ No newline at end of file
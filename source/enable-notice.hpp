@@ -1,5 +1,46 @@
+#include "levels.hpp"
 #ifdef LOGGER_NOTICE
 #undef LOGGER_NOTICE
 #endif
-//!Strumień wejściowy (char) dla poziomu NOTICE_ w najwyższej warstwie logowania dla danego wątku.
-#define LOGGER_NOTICE ict::logger::input::ostream(ict::logger::notice)
\ No newline at end of file
+#ifdef LOGGER_NOTICE_EVERY_N
+#undef LOGGER_NOTICE_EVERY_N
+#endif
+#ifdef LOGGER_NOTICE_FIRST_N
+#undef LOGGER_NOTICE_FIRST_N
+#endif
+#ifdef LOGGER_NOTICE_RATE
+#undef LOGGER_NOTICE_RATE
+#endif
+#ifdef LOGGER_NOTICE_KV
+#undef LOGGER_NOTICE_KV
+#endif
+#ifdef LOGGER_NOTICE_F
+#undef LOGGER_NOTICE_F
+#endif
+#if LOGGER_MIN_LEVEL>LOGGER_LEVEL_NOTICE
+//!Strumień wejściowy (char) dla poziomu NOTICE - wyłączony w czasie kompilacji (LOGGER_MIN_LEVEL).
+#define LOGGER_NOTICE __LOGGER_DISABLED__
+//!Strumień wejściowy (char) dla poziomu NOTICE co n-te wywołanie - wyłączony.
+#define LOGGER_NOTICE_EVERY_N(n) __LOGGER_DISABLED__
+//!Strumień wejściowy (char) dla poziomu NOTICE tylko dla n pierwszych wywołań - wyłączony.
+#define LOGGER_NOTICE_FIRST_N(n) __LOGGER_DISABLED__
+//!Strumień wejściowy (char) dla poziomu NOTICE z ograniczeniem liczby linii na sekundę - wyłączony.
+#define LOGGER_NOTICE_RATE(per_sec) __LOGGER_DISABLED__
+//!Linia strukturalna dla poziomu NOTICE - wyłączona.
+#define LOGGER_NOTICE_KV(...) __LOGGER_DISABLED__
+//!Linia z ciągiem formatującym dla poziomu NOTICE - wyłączona.
+#define LOGGER_NOTICE_F(...) __LOGGER_DISABLED__
+#else
+//!Strumień wejściowy (char) dla poziomu NOTICE w najwyższej warstwie logowania dla danego wątku.
+#define LOGGER_NOTICE __LOGGER_STREAM__(ict::logger::notice)
+//!Strumień wejściowy (char) dla poziomu NOTICE co n-te wywołanie w danym miejscu w kodzie (pozostałe wywołania są pomijane razem z argumentami).
+#define LOGGER_NOTICE_EVERY_N(n) __LOGGER_EVERY_N__(ict::logger::notice,n)
+//!Strumień wejściowy (char) dla poziomu NOTICE tylko dla n pierwszych wywołań w danym miejscu w kodzie.
+#define LOGGER_NOTICE_FIRST_N(n) __LOGGER_FIRST_N__(ict::logger::notice,n)
+//!Strumień wejściowy (char) dla poziomu NOTICE z ograniczeniem liczby linii na sekundę w danym miejscu w kodzie.
+#define LOGGER_NOTICE_RATE(per_sec) __LOGGER_RATE__(ict::logger::notice,per_sec)
+//!Linia strukturalna dla poziomu NOTICE (treść i pary nazwa-wartość) w najwyższej warstwie logowania dla danego wątku.
+#define LOGGER_NOTICE_KV(...) __LOGGER_KV__(ict::logger::notice,__VA_ARGS__)
+//!Linia z ciągiem formatującym ({} - miejsce na argument, sprawdzane w czasie kompilacji) dla poziomu NOTICE w najwyższej warstwie logowania dla danego wątku.
+#define LOGGER_NOTICE_F(...) __LOGGER_FORMAT__(ict::logger::notice,__VA_ARGS__)
+#endif
\ No newline at end of file
@@ -1,5 +1,46 @@
+#include "levels.hpp"
 #ifdef LOGGER_WARN
 #undef LOGGER_WARN
 #endif
-//!Strumień wejściowy (char) dla poziomu WARNING_ w najwyższej warstwie logowania dla danego wątku.
-#define LOGGER_WARN ict::logger::input::ostream(ict::logger::warning)
\ No newline at end of file
+#ifdef LOGGER_WARN_EVERY_N
+#undef LOGGER_WARN_EVERY_N
+#endif
+#ifdef LOGGER_WARN_FIRST_N
+#undef LOGGER_WARN_FIRST_N
+#endif
+#ifdef LOGGER_WARN_RATE
+#undef LOGGER_WARN_RATE
+#endif
+#ifdef LOGGER_WARN_KV
+#undef LOGGER_WARN_KV
+#endif
+#ifdef LOGGER_WARN_F
+#undef LOGGER_WARN_F
+#endif
+#if LOGGER_MIN_LEVEL>LOGGER_LEVEL_WARN
+//!Strumień wejściowy (char) dla poziomu WARNING - wyłączony w czasie kompilacji (LOGGER_MIN_LEVEL).
+#define LOGGER_WARN __LOGGER_DISABLED__
+//!Strumień wejściowy (char) dla poziomu WARNING co n-te wywołanie - wyłączony.
+#define LOGGER_WARN_EVERY_N(n) __LOGGER_DISABLED__
+//!Strumień wejściowy (char) dla poziomu WARNING tylko dla n pierwszych wywołań - wyłączony.
+#define LOGGER_WARN_FIRST_N(n) __LOGGER_DISABLED__
+//!Strumień wejściowy (char) dla poziomu WARNING z ograniczeniem liczby linii na sekundę - wyłączony.
+#define LOGGER_WARN_RATE(per_sec) __LOGGER_DISABLED__
+//!Linia strukturalna dla poziomu WARNING - wyłączona.
+#define LOGGER_WARN_KV(...) __LOGGER_DISABLED__
+//!Linia z ciągiem formatującym dla poziomu WARNING - wyłączona.
+#define LOGGER_WARN_F(...) __LOGGER_DISABLED__
+#else
+//!Strumień wejściowy (char) dla poziomu WARNING w najwyższej warstwie logowania dla danego wątku.
+#define LOGGER_WARN __LOGGER_STREAM__(ict::logger::warning)
+//!Strumień wejściowy (char) dla poziomu WARNING co n-te wywołanie w danym miejscu w kodzie (pozostałe wywołania są pomijane razem z argumentami).
+#define LOGGER_WARN_EVERY_N(n) __LOGGER_EVERY_N__(ict::logger::warning,n)
+//!Strumień wejściowy (char) dla poziomu WARNING tylko dla n pierwszych wywołań w danym miejscu w kodzie.
+#define LOGGER_WARN_FIRST_N(n) __LOGGER_FIRST_N__(ict::logger::warning,n)
+//!Strumień wejściowy (char) dla poziomu WARNING z ograniczeniem liczby linii na sekundę w danym miejscu w kodzie.
+#define LOGGER_WARN_RATE(per_sec) __LOGGER_RATE__(ict::logger::warning,per_sec)
+//!Linia strukturalna dla poziomu WARNING (treść i pary nazwa-wartość) w najwyższej warstwie logowania dla danego wątku.
+#define LOGGER_WARN_KV(...) __LOGGER_KV__(ict::logger::warning,__VA_ARGS__)
+//!Linia z ciągiem formatującym ({} - miejsce na argument, sprawdzane w czasie kompilacji) dla poziomu WARNING w najwyższej warstwie logowania dla danego wątku.
+#define LOGGER_WARN_F(...) __LOGGER_FORMAT__(ict::logger::warning,__VA_ARGS__)
+#endif
\ No newline at end of file
@@ -0,0 +1,19 @@
+#ifndef _ICT_LOGGER_LEVELS_HEADER
+#define _ICT_LOGGER_LEVELS_HEADER
+//============================================
+//! Numery poziomów logowania dla LOGGER_MIN_LEVEL (od najmniej do najbardziej istotnego).
+#define LOGGER_LEVEL_DEBUG 0
+#define LOGGER_LEVEL_INFO 1
+#define LOGGER_LEVEL_NOTICE 2
+#define LOGGER_LEVEL_WARN 3
+#define LOGGER_LEVEL_ERR 4
+#define LOGGER_LEVEL_CRIT 5
+#define LOGGER_LEVEL_OFF 6
+//! Najniższy poziom logowania, który jest kompilowany (niższe poziomy są usuwane razem z argumentami).
+#ifndef LOGGER_MIN_LEVEL
+#define LOGGER_MIN_LEVEL LOGGER_LEVEL_DEBUG
+#endif
+//! Makro - Strumień wejściowy wyłączony w czasie kompilacji (całe wyrażenie jest pomijane).
+#define __LOGGER_DISABLED__ true?(void)0:ict::logger::input::voidify()&ict::logger::input::dummy()
+//============================================
+#endif
@@ -35,19 +35,47 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 **************************************************************/
 //============================================
 #include "logger.hpp"
-#include <iomanip>
 #include <sstream>
 #include <string>
 #include <streambuf>
 #include <map>
+#include <unordered_map>
 #include <vector>
+#include <deque>
+#include <functional>
 #include <set>
-#include <stack>
 #include <mutex>
 #include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <filesystem>
-#include "syslog.h"
+#include <cstring>
+#include <cstddef>
+#include <fstream>
+#include <cctype>
+#include <ctime>
+#include <cerrno>
+#include <cmath>
+#include <charconv>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/syscall.h>
+#include <pthread.h>
+#include <sched.h>
+#ifdef LOGGER_ZLIB
+#include <zlib.h>
+#endif
+#if defined(__SSE2__)||defined(__AVX2__)
+#include <immintrin.h>
+#endif
 //============================================
 #define TRY_BEGIN try {
 #define TRY_END } catch (...) { \
@@ -56,15 +84,112 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //============================================
 namespace ict { namespace logger {
 //===========================================
+//! Liczba cyfr ułamka sekundy w znaczniku czasu (0 - bez ułamka).
+static std::atomic<unsigned> time_precision(0);
+//! Zegar używany do pobierania czasu.
+static std::atomic<clockid_t> time_clock(CLOCK_REALTIME_COARSE);
 struct timestamp_t {
-  timestamp_t():t(std::time(nullptr)){}
-  void setTime(){t=std::time(nullptr);}
+  timestamp_t(){setTime();}
+  void setTime(){
+    struct timespec ts;
+    ::clock_gettime(time_clock.load(std::memory_order_relaxed),&ts);
+    t=ts.tv_sec;
+    ns=ts.tv_nsec;
+  }
+  //! Maksymalna długość znacznika czasu (bez znaku końca).
+  static const std::size_t size=40;
+  //!
+  //! @brief Zapisuje znacznik czasu w postaci tekstowej.
+  //!
+  //! @param [out] out Bufor o rozmiarze co najmniej timestamp_t::size.
+  //! @return Liczba zapisanych znaków.
+  //!
+  std::size_t format(char * out) const;
+  //!
+  //! @brief Podaje ułamek sekundy z zadaną liczbą cyfr.
+  //!
+  long fraction(unsigned digits) const;
+  //!
+  //! @brief Zapisuje ułamek sekundy (razem z kropką).
+  //!
+  static std::size_t format_fraction(char * out,long frac,unsigned digits);
+  //!
+  //! @brief Zapisuje znacznik czasu w postaci tekstowej dla podanej strefy czasowej.
+  //!
+  //! @param [out] out Bufor o rozmiarze co najmniej timestamp_t::size.
+  //! @param [in] t Czas (sekundy).
+  //! @param [in] frac Ułamek sekundy.
+  //! @param [in] digits Liczba cyfr ułamka sekundy.
+  //! @param [in] gmtoff Przesunięcie strefy czasowej względem UTC (sekundy).
+  //! @return Liczba zapisanych znaków.
+  //!
+  static std::size_t format(char * out,std::time_t t,long frac,unsigned digits,long gmtoff);
   std::time_t t; 
+  long ns=0;
 };
+std::size_t timestamp_t::format(char * out) const {
+  //! Ostatnio sformatowana sekunda (osobno dla każdego wątku).
+  struct Cache {
+    std::time_t t=-1;
+    char date[32];
+    std::size_t date_size=0;
+    char zone[16];
+    std::size_t zone_size=0;
+  };
+  static thread_local Cache cache;
+  if (cache.t!=t){//Data, godzina i strefa są formatowane tylko przy zmianie sekundy.
+    struct tm tm;
+    ::localtime_r(&t,&tm);
+    cache.date_size=std::strftime(cache.date,sizeof(cache.date),"%F %T",&tm);
+    cache.zone_size=std::strftime(cache.zone,sizeof(cache.zone),"(%z)",&tm);
+    cache.t=t;
+  }
+  std::size_t n(cache.date_size);
+  std::memcpy(out,cache.date,n);
+  const unsigned digits(time_precision.load(std::memory_order_relaxed));
+  n+=format_fraction(out+n,fraction(digits),digits);
+  std::memcpy(out+n,cache.zone,cache.zone_size);
+  return(n+cache.zone_size);
+}
+long timestamp_t::fraction(unsigned digits) const {
+  long frac(ns);
+  for (unsigned k=digits;k<9;k++) frac/=10;
+  return(frac);
+}
+std::size_t timestamp_t::format_fraction(char * out,long frac,unsigned digits){
+  if (!digits) return(0);
+  out[0]='.';
+  for (unsigned k=digits;k;k--,frac/=10) out[k]='0'+(frac%10);
+  return(digits+1);
+}
+std::size_t timestamp_t::format(char * out,std::time_t t,long frac,unsigned digits,long gmtoff){
+  const std::time_t local(t+gmtoff);
+  const long zone((gmtoff<0?-gmtoff:gmtoff)/60);
+  struct tm tm;
+  ::gmtime_r(&local,&tm);
+  std::size_t n(std::strftime(out,size,"%F %T",&tm));
+  n+=format_fraction(out+n,frac,digits);
+  n+=std::snprintf(out+n,size-n,"(%c%02ld%02ld)",(gmtoff<0)?'-':'+',zone/60,zone%60);
+  return(n);
+}
 std::ostream & operator<<(std::ostream & os,const timestamp_t & t){
-    os<<std::put_time(std::localtime(&(t.t)),"%F %T(%z)");
+    char out[timestamp_t::size];
+    os.write(out,t.format(out));
     return(os);
 }
+void setPrecision(unsigned digits){
+  if (9<digits) digits=9;
+  struct timespec res;
+  clockid_t clock(CLOCK_REALTIME);
+  //Zegar zgrubny jest używany, jeśli jego rozdzielczość wystarcza dla zadanej precyzji.
+  if (::clock_getres(CLOCK_REALTIME_COARSE,&res)==0){
+    long unit(1000000000);
+    for (unsigned k=digits;k;k--) unit/=10;
+    if ((res.tv_sec==0)&&(res.tv_nsec<=unit)) clock=CLOCK_REALTIME_COARSE;
+  }
+  time_clock.store(clock);
+  time_precision.store(digits);
+}
 typedef std::map<const char *,std::string> path_map_t;
 static path_map_t & getPathMap(){
   static path_map_t map;
@@ -74,21 +199,37 @@ static std::string & getBaseDir(){
   static std::string base_dir;
   return(base_dir);
 }
+//! Chroni mapę ścieżek i katalog bazowy (używane z wielu wątków).
+static std::mutex & getPathMutex(){
+  static std::mutex mutex;
+  return(mutex);
+}
 void setBaseDir(const std::string & file){
+  std::lock_guard<std::mutex> lock(getPathMutex());
   getBaseDir()=std::filesystem::path(file).parent_path().native();
   getPathMap().clear();
 }
-std::ostream & operator<<(std::ostream & os,file_struct f){
-    if (!getPathMap().count(f.path)) {
+//Podaje ścieżkę pliku względem katalogu bazowego (wywoływana pod muteksem ścieżek).
+static const std::string & get_file_path(const char * path){
+    if (!getPathMap().count(path)) {
         if (getBaseDir().size()){
-          getPathMap()[f.path]=std::filesystem::relative(f.path,getBaseDir()).native();
+          getPathMap()[path]=std::filesystem::relative(path,getBaseDir()).native();
         } else {
-          getPathMap()[f.path]=std::string(f.path);
+          getPathMap()[path]=std::string(path);
         }
     }
-    os<<getPathMap().at(f.path);
+    return(getPathMap().at(path));
+}
+std::ostream & operator<<(std::ostream & os,file_struct f){
+    std::lock_guard<std::mutex> lock(getPathMutex());
+    os<<get_file_path(f.path);
     return(os);
 }
+//Dopisuje ścieżkę pliku względem katalogu bazowego.
+static void append_file_path(std::string & out,const char * path){
+    std::lock_guard<std::mutex> lock(getPathMutex());
+    out+=get_file_path(path);
+}
 
 //===========================================
   const flags_t critical(0x1<<0);
@@ -110,7 +251,7 @@ std::ostream & operator<<(std::ostream & os,file_struct f){
   const flags_t nodebug(infos);
   const flags_t defaultValue(0x1<<7);
   //==========================================================================
-  void get_log_severity(flags_t severity,std::ostringstream & out){
+  void get_log_severity(flags_t severity,std::ostream & out){
     static const std::map<flags_t,std::string> severity_map({
       {critical,"CRITICAL"},
       {error,"ERROR"},
@@ -122,30 +263,345 @@ std::ostream & operator<<(std::ostream & os,file_struct f){
     if (severity_map.count(severity)) out<<severity_map.at(severity);
   }
   //==========================================================================
+  const uint64_t histogram_t::bounds[histogram_t::size-1]={
+    64ull<<0,64ull<<1,64ull<<2,64ull<<3,64ull<<4,64ull<<5,64ull<<6,64ull<<7,
+    64ull<<8,64ull<<9,64ull<<10,64ull<<11,64ull<<12,64ull<<13,64ull<<14
+  };
+  //! Liczniki statystyk.
+  enum stat_counter_t {
+    stat_lines=0,//Sześć liczników - po jednym dla każdego poziomu logowania.
+    stat_buffered=6,
+    stat_dumped,
+    stat_discarded,
+    stat_overwritten,
+    stat_dumps,
+    stat_ring_full,
+    stat_repeated,
+    stat_compressed,
+    stat_compress_in,
+    stat_compress_out,
+    stat_compress_cpu,
+    stat_queue_dropped,
+    stat_size
+  };
+  //! Histogram czasów jednego wątku.
+  struct Histogram {
+    std::atomic<uint64_t> buckets[histogram_t::size]={};
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> sum{0};
+  };
+  //! Liczniki statystyk (zmienia je tylko wątek, do którego są przypisane).
+  struct alignas(64) Stats {
+    std::atomic<uint64_t> counters[stat_size]={};
+    Histogram lock_wait;
+    Histogram write;
+    //! Informacja, że liczniki są wspólne dla wielu wątków (zmiany są atomowe).
+    bool shared=false;
+    //! Informacja, czy liczniki są przypisane do wątku.
+    std::atomic<bool> used{true};
+    //! Następne liczniki na liście (lista tylko rośnie).
+    Stats * next=nullptr;
+  };
+  //! Lista liczników wszystkich wątków (liczniki zakończonych wątków są używane przez kolejne wątki).
+  static std::atomic<Stats *> stats_list(nullptr);
+  //Dodaje liczniki do listy.
+  static Stats * stats_push(Stats * s){
+    s->next=stats_list.load(std::memory_order_relaxed);
+    while (!stats_list.compare_exchange_weak(s->next,s,std::memory_order_release,std::memory_order_relaxed));
+    return(s);
+  }
+  //Przydziela liczniki wątkowi (wolne z listy lub nowe).
+  static Stats * stats_acquire(){
+    for (Stats * s=stats_list.load(std::memory_order_acquire);s;s=s->next){
+      bool expected(false);
+      if (!s->used.load(std::memory_order_relaxed)&&s->used.compare_exchange_strong(expected,true)) return(s);
+    }
+    return(stats_push(new Stats));
+  }
+  //! Liczniki wątku.
+  static thread_local Stats * thread_stats(nullptr);
+  //! Informacja, że liczniki wątku zostały już zwolnione (wątek się kończy).
+  static thread_local bool thread_stats_released(false);
+  //! Zwalnia liczniki przy zakończeniu wątku.
+  struct StatsOwner {
+    ~StatsOwner(){
+      if (thread_stats) thread_stats->used.store(false,std::memory_order_release);
+      thread_stats=nullptr;
+      thread_stats_released=true;
+    }
+  };
+  //Podaje liczniki bieżącego wątku (po zakończeniu wątku - liczniki wspólne).
+  static Stats & get_stats(){
+    if (thread_stats) return(*thread_stats);
+    if (!thread_stats_released){
+      static thread_local StatsOwner owner;
+      thread_stats=stats_acquire();
+      return(*thread_stats);
+    }
+    static Stats * shared([]{
+      Stats * s(new Stats);
+      s->shared=true;
+      return(stats_push(s));
+    }());
+    return(*shared);
+  }
+  static inline void stats_add(Stats & s,std::atomic<uint64_t> & c,uint64_t n){
+    if (s.shared) c.fetch_add(n,std::memory_order_relaxed);
+    else c.store(c.load(std::memory_order_relaxed)+n,std::memory_order_relaxed);
+  }
+  //Zwiększa licznik bieżącego wątku.
+  static inline void stats_count(stat_counter_t counter,uint64_t n=1){
+    Stats & s(get_stats());
+    stats_add(s,s.counters[counter],n);
+  }
+  //Zwiększa licznik linii dla poziomu logowania.
+  static inline void stats_line(flags_t severity){
+    if (severity&all) stats_count(stat_counter_t(stat_lines+__builtin_ctz(severity)));
+  }
+  //Dodaje pomiar czasu do histogramu.
+  static inline void stats_time(Stats & s,Histogram & h,uint64_t ns){
+    std::size_t k(0);
+    if (histogram_t::bounds[0]<ns) k=std::min<std::size_t>(64-__builtin_clzll(ns-1)-6,histogram_t::size-1);
+    stats_add(s,h.buckets[k],1);
+    stats_add(s,h.count,1);
+    stats_add(s,h.sum,ns);
+  }
+  static inline uint64_t stats_now(){
+    return(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+  }
+  //! Informacja, czy czas oczekiwania na muteks wyjścia i czas zapisu są mierzone.
+  static std::atomic<bool> stats_timing(true);
+  //!
+  //! @brief Zajmuje muteks wyjścia i mierzy czas oczekiwania oraz zapisu (jeśli pomiar jest włączony).
+  //!
+  //! Czas oczekiwania jest mierzony tylko, jeśli muteks jest zajęty (w przeciwnym razie wynosi zero).
+  //!
+  class OutputLock {
+  private:
+    std::mutex & mutex;
+    //! Informacja, czy czas jest mierzony.
+    const bool timed;
+    //! Czas zajęcia muteksu.
+    uint64_t locked=0;
+  public:
+    explicit OutputLock(std::mutex & mutex_in):mutex(mutex_in),timed(stats_timing.load(std::memory_order_relaxed)){
+      if (!timed){
+        mutex.lock();
+        return;
+      }
+      Stats & s(get_stats());
+      if (mutex.try_lock()){
+        locked=stats_now();
+        stats_time(s,s.lock_wait,0);
+      } else {
+        const uint64_t start(stats_now());
+        mutex.lock();
+        locked=stats_now();
+        stats_time(s,s.lock_wait,locked-start);
+      }
+    }
+    ~OutputLock(){
+      if (timed){
+        Stats & s(get_stats());
+        stats_time(s,s.write,stats_now()-locked);
+      }
+      mutex.unlock();
+    }
+    OutputLock(const OutputLock &)=delete;
+    OutputLock & operator=(const OutputLock &)=delete;
+  };
+  static void stats_sum(histogram_t & out,const Histogram & in){
+    for (std::size_t k=0;k<histogram_t::size;k++) out.buckets[k]+=in.buckets[k].load(std::memory_order_relaxed);
+    out.count+=in.count.load(std::memory_order_relaxed);
+    out.sum+=in.sum.load(std::memory_order_relaxed);
+  }
+  stats_t stats(){
+    stats_t out;
+    for (const Stats * s=stats_list.load(std::memory_order_acquire);s;s=s->next){
+      for (std::size_t k=0;k<6;k++) out.lines[k]+=s->counters[stat_lines+k].load(std::memory_order_relaxed);
+      out.buffered+=s->counters[stat_buffered].load(std::memory_order_relaxed);
+      out.dumped+=s->counters[stat_dumped].load(std::memory_order_relaxed);
+      out.discarded+=s->counters[stat_discarded].load(std::memory_order_relaxed);
+      out.overwritten+=s->counters[stat_overwritten].load(std::memory_order_relaxed);
+      out.dumps+=s->counters[stat_dumps].load(std::memory_order_relaxed);
+      out.ring_full+=s->counters[stat_ring_full].load(std::memory_order_relaxed);
+      out.repeated+=s->counters[stat_repeated].load(std::memory_order_relaxed);
+      out.compressed+=s->counters[stat_compressed].load(std::memory_order_relaxed);
+      out.compress_in+=s->counters[stat_compress_in].load(std::memory_order_relaxed);
+      out.compress_out+=s->counters[stat_compress_out].load(std::memory_order_relaxed);
+      out.compress_cpu+=s->counters[stat_compress_cpu].load(std::memory_order_relaxed);
+      out.queue_dropped+=s->counters[stat_queue_dropped].load(std::memory_order_relaxed);
+      stats_sum(out.lock_wait,s->lock_wait);
+      stats_sum(out.write,s->write);
+    }
+    return(out);
+  }
+  //==========================================================================
+  //! Wyjście do syslog - komunikaty są wysyłane bezpośrednio do gniazda AF_UNIX (bez openlog/syslog).
   class Syslog{
   private:
-    flags_t filter;
+    //! Filtr logów.
+    const flags_t filter;
+    //! Ustawienia wyjścia.
+    const output::syslog_options_t options;
+    //! Część nagłówka po znaczniku czasu (np. "ident[pid]: ").
+    std::string tag;
+    //! Deskryptor gniazda (-1 - brak połączenia).
+    int fd=-1;
+    //! Czas, przed którym nie jest podejmowana kolejna próba połączenia.
+    std::time_t retry=0;
+    //! Komunikaty oczekujące na wysłanie (bufory są używane ponownie).
+    std::vector<std::string> queue;
+    //! Liczba oczekujących komunikatów.
+    std::size_t queued=0;
+    std::vector<struct mmsghdr> msgs;
+    std::vector<struct iovec> iovs;
+    //! Ostatnio sformatowana sekunda.
+    std::time_t stamp_t=-1;
+    char stamp[48];
+    std::size_t stamp_size=0;
+    //! Strefa czasowa ostatnio sformatowanej sekundy (tylko RFC 5424).
+    char zone[16];
+    std::size_t zone_size=0;
+    //! Liczniki wysłanych i odrzuconych komunikatów.
+    std::atomic<uint64_t> sent{0},dropped{0};
+    //Zwraca kod poziomu logowania syslog (lub -1, jeśli poziom jest nieznany).
+    static int code(flags_t severity){
+      switch(severity){
+        case critical:return(2);//critical conditions
+        case error:return(3);//error conditions
+        case warning:return(4);//warning conditions
+        case notice:return(5);//normal, but significant, condition
+        case info:return(6);// informational message
+        case debug:return(7);// debug-level message
+        default:break;
+      }
+      return(-1);
+    }
+    //Łączy gniazdo z odbiorcą (nie częściej niż raz na sekundę).
+    bool open(){
+      const std::time_t now(std::time(nullptr));
+      if (now<retry) return(false);
+      retry=now+1;
+      struct sockaddr_un addr;
+      std::memset(&addr,0,sizeof(addr));
+      addr.sun_family=AF_UNIX;
+      if (sizeof(addr.sun_path)<=options.path.size()) return(false);
+      std::memcpy(addr.sun_path,options.path.data(),options.path.size());
+      fd=::socket(AF_UNIX,SOCK_DGRAM|SOCK_NONBLOCK|SOCK_CLOEXEC,0);
+      if (fd<0) return(false);
+      if (::connect(fd,(const struct sockaddr *)&addr,sizeof(addr))<0){
+        close();
+        return(false);
+      }
+      return(true);
+    }
+    void close(){
+      if (0<=fd) ::close(fd);
+      fd=-1;
+    }
+    //Formatuje znacznik czasu nagłówka (data i godzina są formatowane tylko przy zmianie sekundy).
+    std::size_t format(char * out,const timestamp_t & time){
+      static const char * months[]={"Jan","Feb","Mar","Apr","May","Jun","Jul","Aug","Sep","Oct","Nov","Dec"};
+      if (stamp_t!=time.t){
+        struct tm tm;
+        ::localtime_r(&time.t,&tm);
+        if (options.format==output::rfc5424){
+          stamp_size=std::strftime(stamp,sizeof(stamp),"%FT%T",&tm);
+        } else {
+          stamp_size=std::snprintf(stamp,sizeof(stamp),"%s %2d %02d:%02d:%02d ",months[tm.tm_mon%12],tm.tm_mday,tm.tm_hour,tm.tm_min,tm.tm_sec);
+        }
+        stamp_t=time.t;
+        zone_size=0;
+        if (options.format==output::rfc5424){
+          const long gmtoff(tm.tm_gmtoff),m((gmtoff<0?-gmtoff:gmtoff)/60);
+          zone_size=std::snprintf(zone,sizeof(zone),"%c%02ld:%02ld ",(gmtoff<0)?'-':'+',m/60,m%60);
+        }
+      }
+      std::size_t n(stamp_size);
+      std::memcpy(out,stamp,n);
+      if (options.format==output::rfc5424){
+        n+=timestamp_t::format_fraction(out+n,time.fraction(6),6);
+        std::memcpy(out+n,zone,zone_size);
+        n+=zone_size;
+      }
+      return(n);
+    }
   public:
-    Syslog(const std::string & ident,flags_t filter_in):filter(filter_in){
-      ::openlog(ident.c_str(),LOG_PID,LOG_USER);
+    //! Mutex zapisu do wyjścia (chroni kolejkę i gniazdo).
+    std::mutex mutex;
+    Syslog(const std::string & ident,flags_t filter_in,const output::syslog_options_t & options_in):filter(filter_in),options(options_in){
+      const std::string pid(std::to_string(::getpid()));
+      if (options.format==output::rfc5424){
+        char host[256]="-";
+        if (::gethostname(host,sizeof(host)-1)<0) std::strcpy(host,"-");
+        host[sizeof(host)-1]=0;
+        tag=std::string(host)+" "+(ident.empty()?std::string("-"):ident)+" "+pid+" - - ";
+      } else {
+        tag=ident+"["+pid+"]: ";
+      }
+      open();
     }
     ~Syslog(){
-      ::closelog();
-    }
-    void log(flags_t severity,const std::string & str){
-      static const std::map<flags_t,int> severity_map({
-        {critical,LOG_CRIT},//critical conditions
-        {error,LOG_ERR},//error conditions
-        {warning,LOG_WARNING},//warning conditions
-        {notice,LOG_NOTICE},//normal, but significant, condition
-        {info,LOG_INFO},// informational message
-        {debug,LOG_DEBUG}// debug-level message
-      });
-      if ((filter&severity)&&(severity_map.count(severity))){
-        ::syslog(severity_map.at(severity),"%s",str.c_str());
+      send();
+      close();
+    }
+    //Dodaje komunikat do kolejki.
+    void push(flags_t severity,const timestamp_t & time,const std::string & str){
+      const int c(code(severity));
+      if (!(filter&severity)||(c<0)) return;
+      if (queue.size()<=queued) queue.emplace_back();
+      std::string & out(queue[queued++]);
+      char head[16+sizeof(stamp)+sizeof(zone)];
+      std::size_t n(std::snprintf(head,16,"<%u>%s",options.facility*8+c,(options.format==output::rfc5424)?"1 ":""));
+      n+=format(head+n,time);
+      out.assign(head,n);
+      out+=tag;
+      out+=str;
+    }
+    //Wysyła wszystkie komunikaty z kolejki (jeśli gniazdo jest pełne, to komunikaty są odrzucane).
+    void send(){
+      if (!queued) return;
+      std::size_t done(0),skipped(0);
+      if ((0<=fd)||open()){
+        msgs.resize(queued);
+        iovs.resize(queued);
+        for (std::size_t k=0;k<queued;k++){
+          iovs[k].iov_base=queue[k].data();
+          iovs[k].iov_len=queue[k].size();
+          std::memset(&msgs[k],0,sizeof(msgs[k]));
+          msgs[k].msg_hdr.msg_iov=&iovs[k];
+          msgs[k].msg_hdr.msg_iovlen=1;
+        }
+        while (done<queued){
+          const int n(::sendmmsg(fd,msgs.data()+done,queued-done,MSG_DONTWAIT|MSG_NOSIGNAL));
+          if (0<n) {
+            done+=n;
+          } else if (errno==EINTR) {
+            continue;
+          } else if (errno==EMSGSIZE) {//Komunikat za duży - tylko on jest odrzucany.
+            done++;
+            skipped++;
+          } else {
+            //Jeśli odbiorca zniknął, to połączenie jest odtwarzane przy kolejnym wysłaniu.
+            if ((errno!=EAGAIN)&&(errno!=EWOULDBLOCK)) close();
+            break;
+          }
+        }
       }
+      sent+=done-skipped;
+      dropped+=queued-done+skipped;
+      queued=0;
+    }
+    void log(flags_t severity,const timestamp_t & time,const std::string & str){
+      push(severity,time,str);
+      send();
+    }
+    flags_t getFilter() const {return(filter);}
+    void getStats(output::syslog_stats_t & stats){
+      stats.sent=sent.load();
+      stats.dropped=dropped.load();
     }
-    flags_t getFilter(){return(filter);}
   };
   //==========================================================================
   template <typename charT>
@@ -153,700 +609,5510 @@ std::ostream & operator<<(std::ostream & os,file_struct f){
     bool buffered=false;
     timestamp_t time;
     flags_t severity;
+    //! Miejsce w kodzie (jeśli plik jest pusty, to miejsce jest częścią linii).
+    site_struct site{nullptr,false,0,nullptr,0};
     std::basic_string<charT> line;
+    //! Pola linii strukturalnej (LOGGER_*_KV).
+    std::vector<field_t> fields;
+    //! Ciąg formatujący linii odroczonej (LOGGER_*_F) - linia zawiera wtedy wartości argumentów, a nie tekst.
+    const char * format=nullptr;
   };
   typedef log_line_t<char> log_string_t;
   typedef log_line_t<wchar_t> log_wstring_t;
   //==========================================================================
-  namespace output {
-    typedef std::map<std::ostream *,flags_t> ostream_map_t;
-    struct Data{
-      //! Mutex dla strumieni wyjściowych.
-      std::mutex mutex;
-      //! Zestaw strumieni wyjściowych ostream.
-      ostream_map_t ostream_map;
-      //! Wskaźnik na obieg obsługujący syslog.
-      std::unique_ptr<Syslog> syslog;
-    };
-    static Data & data(){
-      static Data data;
-      return(data);
-    }
-    template <typename S> 
-    void set(S * ostream,flags_t filter,std::map<S *,flags_t> & map){
-      TRY_BEGIN
-      std::lock_guard<std::mutex> lock(data().mutex);
-      if (filter&&ostream){
-        map[ostream]=filter;
-      } else if (map.count(ostream)) {
-        map.erase(ostream);
-      }
-      TRY_END
+  //! Nazwy poziomów logowania.
+  static const char * get_severity_name(flags_t severity){
+    switch (severity){
+      case 0x1<<0:return("CRITICAL");
+      case 0x1<<1:return("ERROR");
+      case 0x1<<2:return("WARNING");
+      case 0x1<<3:return("NOTICE");
+      case 0x1<<4:return("INFO");
+      case 0x1<<5:return("DEBUG");
+      default:break;
     }
-    void set(std::ostream & ostream,flags_t filter){
-      set(&ostream,filter,data().ostream_map);
+    return("");
+  }
+  //Informacja, czy znak wymaga zamiany w ciągu znaków JSON (cudzysłów, ukośnik wsteczny i znaki sterujące).
+  static inline bool json_special(char c){
+    return((c=='"')||(c=='\\')||(((unsigned char)c)<0x20));
+  }
+  //!
+  //! @brief Znajduje pierwszy znak, który wymaga zamiany w ciągu znaków JSON.
+  //!
+  //! @param [in] s Wskaźnik na ciąg znaków.
+  //! @param [in] n Liczba znaków.
+  //! @return Pozycja znaku lub n, jeśli nie znaleziono.
+  //!
+  static inline std::size_t json_find(const char * s,std::size_t n){
+    std::size_t i(0);
+#if defined(__AVX2__)
+    const __m256i quote32(_mm256_set1_epi8('"')),slash32(_mm256_set1_epi8('\\')),limit32(_mm256_set1_epi8(0x1f));
+    for (;(i+32)<=n;i+=32){
+      const __m256i v(_mm256_loadu_si256((const __m256i *)(s+i)));
+      const __m256i m(_mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpeq_epi8(v,quote32),_mm256_cmpeq_epi8(v,slash32)),
+        _mm256_cmpeq_epi8(_mm256_min_epu8(v,limit32),v)
+      ));
+      const uint32_t mask(_mm256_movemask_epi8(m));
+      if (mask) return(i+__builtin_ctz(mask));
     }
-    void set(const std::string & ident,flags_t filter){
-      TRY_BEGIN
-      std::lock_guard<std::mutex> lock(data().mutex);
-      if (filter){
-        data().syslog.reset(new Syslog(ident,filter));
-      } else if (data().syslog.get()) {
-        data().syslog.reset(nullptr);
-      }
-      TRY_END
+#endif
+#if defined(__SSE2__)
+    const __m128i quote16(_mm_set1_epi8('"')),slash16(_mm_set1_epi8('\\')),limit16(_mm_set1_epi8(0x1f));
+    for (;(i+16)<=n;i+=16){
+      const __m128i v(_mm_loadu_si128((const __m128i *)(s+i)));
+      const __m128i m(_mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(v,quote16),_mm_cmpeq_epi8(v,slash16)),
+        _mm_cmpeq_epi8(_mm_min_epu8(v,limit16),v)
+      ));
+      const uint32_t mask(_mm_movemask_epi8(m));
+      if (mask) return(i+__builtin_ctz(mask));
     }
-
-    template <typename S> 
-    flags_t test(S * ostream,std::map<S *,flags_t> & map){
-      TRY_BEGIN
-      std::lock_guard<std::mutex> lock(data().mutex);
-      if (map.count(ostream)){
-        return(map.at(ostream));
+#endif
+    for (;i<n;i++) if (json_special(s[i])) return(i);
+    return(n);
+  }
+  //Dopisuje ciąg znaków JSON (w cudzysłowach).
+  static void json_string(std::string & out,const char * s,std::size_t n){
+    static const char hex[]="0123456789abcdef";
+    out+='"';
+    while (n){
+      const std::size_t i(json_find(s,n));
+      out.append(s,i);
+      if (i==n) break;
+      switch (s[i]){
+        case '"':out+="\\\"";break;
+        case '\\':out+="\\\\";break;
+        case '\n':out+="\\n";break;
+        case '\r':out+="\\r";break;
+        case '\t':out+="\\t";break;
+        default:
+          out+="\\u00";
+          out+=hex[(s[i]>>4)&0xf];
+          out+=hex[s[i]&0xf];
+          break;
       }
-      TRY_END
-      return(0x0);
+      s+=i+1;
+      n-=i+1;
     }
-    flags_t test(std::ostream * ostream){
-      return(test(ostream,data().ostream_map));
+    out+='"';
+  }
+  static inline void json_string(std::string & out,const char * s){
+    json_string(out,s,std::strlen(s));
+  }
+  //Dopisuje liczbę (bez pośrednich napisów).
+  template <typename T>
+  static inline void append_number(std::string & out,T v){
+    char buffer[32];
+    const std::to_chars_result r(std::to_chars(buffer,buffer+sizeof(buffer),v));
+    out.append(buffer,r.ptr-buffer);
+  }
+  //Dopisuje wartość pola, która nie jest tekstem (w JSON i w postaci tekstowej wygląda tak samo).
+  static void append_value(std::string & out,const field_t & f){
+    switch (f.type){
+      case field_int:append_number(out,f.i);break;
+      case field_uint:append_number(out,f.u);break;
+      case field_double:
+        if (std::isfinite(f.d)) append_number(out,f.d); else out+="null";
+        break;
+      case field_bool:out+=(f.b?"true":"false");break;
+      default:break;
     }
-    flags_t test(){
-      TRY_BEGIN
-      std::lock_guard<std::mutex> lock(data().mutex);
-      if (data().syslog.get()) {
-        return(data().syslog->getFilter());
+  }
+  //Dopisuje pola linii strukturalnej w postaci tekstowej (" nazwa=wartość").
+  static void append_fields_text(std::string & out,const std::vector<field_t> & fields){
+    for (const field_t & f: fields){
+      out+=' ';
+      out+=f.key;
+      out+='=';
+      if (f.type!=field_string){
+        append_value(out,f);
+      } else if (f.s.size()&&(f.s.find_first_of(" \"=")==std::string::npos)&&(json_find(f.s.data(),f.s.size())==f.s.size())){
+        out+=f.s;
+      } else {//Tekst ze spacjami lub znakami specjalnymi jest w cudzysłowach.
+        json_string(out,f.s.data(),f.s.size());
       }
-      TRY_END
-      return(0x0);
-    }
-    //Zapisuje pojedynczy log w syslog.
-    static inline void log_syslog_out(flags_t severity,const std::string & in){
-      TRY_BEGIN
-      if (data().syslog.get()) data().syslog->log(severity,in);
-      TRY_END
     }
-    //Zapisuje pojedynczy log w syslog.
-    template <typename charT>
-    static inline void log_syslog_out(const log_line_t<charT> & in){
-      TRY_BEGIN
-      std::lock_guard<std::mutex> lock(data().mutex);
-      if (data().syslog.get()){//Jeśli syslog jest ustawiony
-        if ((in.severity)&(data().syslog->getFilter())){//Jeśli został ustawiony i poziom logu się zgadza.
-          std::basic_ostringstream<charT> out;
-          //Jeśli jest to wpis buforowany, to go oznacz i wstaw czas powstania tego logu.
-          if (in.buffered) out<<out.widen('|')<<out.widen(' ')<<in.time<<out.widen(' ');
-          //Wstaw znacznik severity do strumienia.
-          get_log_severity(in.severity,out);
-          //Wstaw spację do strumienia.
-          out<<out.widen(' ')<<in.line;
-          //Wstaw do syslog.
-          log_syslog_out(in.severity,out.str());
-        }
+  }
+  //Zapisuje pola linii strukturalnej w postaci tekstowej do strumienia.
+  static void log_fields_out(const std::vector<field_t> & fields,std::ostream & out){
+    if (fields.empty()) return;
+    static thread_local std::string text;
+    text.clear();
+    append_fields_text(text,fields);
+    out<<text;
+  }
+  template <typename charT>
+  static void log_fields_out(const std::vector<field_t> & fields,std::basic_ostream<charT> & out){}
+  //Porównuje pola linii strukturalnych.
+  static bool fields_equal(const std::vector<field_t> & a,const std::vector<field_t> & b){
+    if (a.size()!=b.size()) return(false);
+    for (std::size_t k=0;k<a.size();k++){
+      if ((a[k].type!=b[k].type)||std::strcmp(a[k].key,b[k].key)) return(false);
+      switch (a[k].type){
+        case field_int:if (a[k].i!=b[k].i) return(false);break;
+        case field_uint:if (a[k].u!=b[k].u) return(false);break;
+        case field_double:if (a[k].d!=b[k].d) return(false);break;
+        case field_bool:if (a[k].b!=b[k].b) return(false);break;
+        case field_string:if (a[k].s!=b[k].s) return(false);break;
       }
-      TRY_END
-    }
-
-    //Zapisuje pojedynczy log w strumieniach wyjściowych w jednym strumieniu.
-    template <typename charT> 
-    static inline void log_stream_out(const std::basic_string<charT>& in, std::basic_ostream<charT> & out){
-      TRY_BEGIN
-      out<<in;
-      TRY_END
     }
-    //Zapisuje pojedynczy log w strumieniach wyjściowych jednego typu.
-    template <typename charIn,typename charOut> 
-    static inline void log_stream_out(flags_t severity,const std::basic_string<charIn>& in, std::map<std::basic_ostream<charOut>*,flags_t> & out){
-      TRY_BEGIN
-      std::lock_guard<std::mutex> lock(data().mutex);
-      for (typename std::map<std::basic_ostream<charOut>*,flags_t>::iterator it=out.begin();it!=out.end();++it){//Przejdź po liście strumieni.
-        if (severity&(it->second))//Jeśli filtr przepuszcza ten wpis
-          if (it->first){//Jeśli to nie jest wpis dotyczący logera systemowego.
-            log_stream_out(in,*(it->first));//Zapisz do strumienia.
-            it->first->flush();
-          }
+    return(true);
+  }
+  //!
+  //! @brief Dopisuje linię w formacie JSON Lines (jeden obiekt i znak końca linii).
+  //!
+  //! @param [out] out Bufor (używany ponownie - bez alokacji, gdy ma już odpowiednią pojemność).
+  //! @param [in] in Linia loga.
+  //!
+  static void log_json_encode(std::string & out,const log_string_t & in){
+    char time[timestamp_t::size];
+    out+="{\"time\":\"";
+    out.append(time,in.time.format(time));
+    out+="\",\"severity\":\"";
+    out+=get_severity_name(in.severity);
+    out+='"';
+    if (in.buffered) out+=",\"buffered\":true";
+    if (in.site.file){
+      out+=",\"file\":";
+      if (in.site.relative){
+        json_string(out,in.site.file);
+      } else {
+        static thread_local std::string path;
+        path.clear();
+        append_file_path(path,in.site.file);
+        json_string(out,path.data(),path.size());
       }
-      TRY_END
+      out+=",\"line\":";
+      append_number(out,in.site.line);
+      out+=",\"function\":";
+      json_string(out,in.site.function,in.site.function_size);
     }
-    //Zapisuje pojedynczy log w strumieniach wyjściowych.
-    template <typename charT> 
-    static void log_stream_out(const log_line_t<charT> & in){
-      TRY_BEGIN
-      std::basic_ostringstream<charT> out;
-      // Wstaw czas.
-      out<<in.time;
-      //Wstaw spację do strumienia.
-      out<<out.widen(' ');
-      //Jeśli jest to wpis buforowany, to go oznacz.
-      if (in.buffered) out<<out.widen('|')<<out.widen(' ');
-      //Wstaw znacznik severity do strumienia.
-      get_log_severity(in.severity,out);
-      //Wstaw spację do strumienia.
-      out<<out.widen(' ');
-      //Wstaw linię.
-      out<<in.line<<std::endl;
-      //Zapisz do wszystkich strumieni wyjściowych ostream.
-      log_stream_out(in.severity,out.str(),data().ostream_map);
-      TRY_END
+    out+=",\"msg\":";
+    json_string(out,in.line.data(),in.line.size());
+    for (const field_t & f: in.fields){
+      out+=',';
+      json_string(out,f.key);
+      out+=':';
+      if (f.type==field_string) json_string(out,f.s.data(),f.s.size()); else append_value(out,f);
     }
+    out+="}\n";
   }
-  //==========================================================================
-  //! Klasa obsługująca pusty bufor.
-  template <
-    typename charT=char,
-    typename traits=std::char_traits<charT>
-  > 
-  class BlackHole:public std::basic_streambuf<charT,traits> {
-  public:
-    typedef typename traits::int_type int_type_t;
-  public:
-    //!
-    //! @brief Konstruktor.
-    //! 
-    BlackHole(){}
-    //!
-    //! @brief Destruktor.
-    //! 
-    ~BlackHole(){}
-    //!
-    //! @brief Przetwarza jeden znak.
-    //! 
-    //! @param [in] c Przetwarzany znak.
-    //! @return Przetworzony znak.
-    //!
-    int_type_t overflow (int_type_t c){
-      //Zakończ.
-      return(c);
-    }
-  };
-  //==========================================================================
-  //! Klasa obsługująca bufor logowania na wybranym poziomie.
-  template <
-    typename charT=char,
-    typename traits=std::char_traits<charT>
-  > 
-  class Buffer:public std::basic_streambuf<charT,traits> {
-  public:
-    typedef std::basic_string<charT> basic_string_t;
-    typedef std::basic_ostream<charT,traits> basic_ostream_t;
-    typedef typename traits::int_type int_type_t;
-    typedef std::vector<log_line_t<charT>> log_line_vector_t;
-  private:
-    //! Pojedyncza linia loga.
-    log_line_t<charT> log_line;
-    //! Bufor linii loga.
-    log_line_vector_t * log_buffer;
-    //! Informacja o tym, że ostatnio została złamana linia (rozpoczyna się nowy wpis loga).
-    bool newline=true;
-  public:
-    //!
-    //! @brief Konstruktor.
-    //! 
-    //! @param [in] severity_in Poziom logowania.
-    //! @param [in] buffered_in Informacja, czy poziom jest buforowany.
-    //! @param [in] buffered_in Informacja, czy poziom jest buforowany.
-    //!
-    Buffer(ict::logger::flags_t severity_in,bool buffered_in,log_line_vector_t * log_buffer_in):log_buffer(log_buffer_in){
-      TRY_BEGIN
-      log_line.buffered=buffered_in;
-      log_line.severity=severity_in;
-      TRY_END
-    }
-    //!
-    //! @brief Destruktor.
-    //! 
-    ~Buffer(){}
+  namespace output {
+    typedef std::map<std::ostream *,flags_t> ostream_map_t;
+    //! Funkcja skrótu dla miejsca w kodzie.
+    struct site_hash {
+      std::size_t operator()(const site_struct & s) const {
+        return(std::hash<const void *>()(s.file)^(std::hash<const void *>()(s.function)*31)^s.line);
+      }
+    };
+    //! Porównanie miejsc w kodzie.
+    struct site_equal {
+      bool operator()(const site_struct & a,const site_struct & b) const {
+        return((a.file==b.file)&&(a.line==b.line)&&(a.function==b.function));
+      }
+    };
+    typedef std::unordered_map<site_struct,uint64_t,site_hash,site_equal> site_id_map_t;
+    //! Stan binarnego strumienia wyjściowego.
+    struct Binary {
+      //! Informacja, czy nagłówek strumienia został już zapisany.
+      bool header=false;
+      //! Identyfikatory miejsc w kodzie, których opis został już zapisany.
+      site_id_map_t sites;
+      //! Liczba cyfr ułamka sekundy zapisana w strumieniu (-1 - jeszcze nie zapisana).
+      int digits=-1;
+      //! Sekunda, dla której ostatnio sprawdzono strefę czasową.
+      std::time_t zone_t=-1;
+      //! Przesunięcie strefy czasowej zapisane w strumieniu.
+      long gmtoff=0;
+      //! Czas ostatniej linii (linie zapisują tylko różnicę).
+      std::time_t last_t=0;
+      //! Bufor rekordu.
+      std::string record;
+    };
+    typedef std::map<std::ostream *,flags_t> binary_map_t;
+    //! Opis linii w bloku zrzutu bufora warstwy.
+    struct batch_line_t {
+      //! Poziom logowania.
+      flags_t severity;
+      //! Czas powstania linii.
+      std::time_t t;
+      //! Położenie linii w bloku.
+      std::size_t offset;
+      //! Długość linii (razem ze znakiem końca linii).
+      std::size_t size;
+    };
+    typedef std::vector<batch_line_t> batch_vector_t;
+    //! Linie przekazywane do wątków wyjść - formatowane raz i wspólne dla wszystkich wyjść (po utworzeniu nie są zmieniane).
+    struct shared_lines_t {
+      //! Linie w pierwotnej postaci.
+      std::vector<log_string_t> lines;
+      //! Postać tekstowa wszystkich linii.
+      std::string block;
+      //! Opis linii w bloku.
+      batch_vector_t meta;
+      //! Poziomy logowania linii.
+      flags_t severities=0x0;
+      //! Informacja, że jest to zrzut bufora warstwy.
+      bool dump=false;
+    };
+    typedef std::shared_ptr<const shared_lines_t> shared_lines_ptr;
+    //Przygotowuje linię z liczbą linii odrzuconych przez kolejkę wyjścia (według poziomu logowania).
+    static shared_lines_ptr log_drop_summary(const std::string & name,const uint64_t (&counts)[6]);
     //!
-    //! @brief Filtruje znaki char.
-    //! 
-    static char charFilter(char c,Buffer<char>*p){
-      static const std::map<char,char> char_map({
-        {'\t',' '},//Zamiana na spacje.
-        {'\v',' '},
-        {'\0',' '},
-        {'\n',0},//Zero oznacza koniec linii.
-        {'\r',0}
-      });
-      if (char_map.count(c)) return(char_map.at(c));
-      return(c);
-    }
+    //! @brief Wątek wyjścia z własną, ograniczoną kolejką.
     //!
-    //! @brief Przetwarza jeden znak.
-    //! 
-    //! @param [in] c Przetwarzany znak.
-    //! @return Przetworzony znak.
+    //! Wątki, które logują, tylko wkładają do kolejki wspólne linie, więc wolne wyjście nie wstrzymuje ich ani pozostałych wyjść.
+    //! Jeśli kolejka jest pełna, to o losie linii decyduje overload_t. Liczba odrzuconych linii jest zapisywana do wyjścia
+    //! (linia warning, nie częściej niż raz na sekundę).
     //!
-    int_type_t overflow (int_type_t c){
-      TRY_BEGIN
-      //! Przetwarzany znak.
-      int_type_t znak(charFilter(c,this));
-      if (znak){//Nie było znaku nowej linii
-        if (newline) {
-          //Jeśli rozpoczyna się nowy wpis, to pobierz aktualny czas.
-          log_line.time.setTime();
-          //Oznacz, że linia się rozpoczyna.
-          newline=false;
-          //Wyczyść linię.
-          log_line.line.clear();
-        }
-        //Wstaw przetwarzany znak.
-        log_line.line+=znak;
-      } else {//Pojawił się znak nowej linii
-        //Jeśli znaki nowej linii.
-        if (newline) {
-          //Ignoruj powtarzające się jeden po drugim.
-          return(c);
-        }
-        //Oznacz nową linię.
-        newline=true;
-        if (log_line.buffered){//Jeśli zapis jest buforowany.
-          const static std::size_t max(1000);//Maksymalny rozmiar bufora.
-            if (log_buffer){
-              if (log_buffer->size()<max){//Jeśli mniejszy, niż maksymalny rozmiar.
-                log_buffer->push_back(log_line);//Dodaj do bufora.
+    class Worker {
+    public:
+      //! Funkcja zapisu linii do wyjścia (wywoływana w wątku wyjścia; podaje linie i filtr wyjścia w migawce).
+      typedef std::function<void(const shared_lines_t &,flags_t)> deliver_t;
+    private:
+      //! Element kolejki.
+      struct item_t {
+        shared_lines_ptr lines;
+        //! Filtr wyjścia w chwili włożenia linii.
+        flags_t filter;
+        //! Czas włożenia linii (stats_now).
+        uint64_t queued;
+        //! Numer ostatniej linii elementu (wartość pushed po jego włożeniu).
+        uint64_t seq;
+      };
+      //! Nazwa wyjścia (w statystykach).
+      const std::string name;
+      const deliver_t deliver;
+      std::mutex mutex;
+      //! Budzi wątek wyjścia.
+      std::condition_variable wake;
+      //! Budzi wątki czekające na miejsce w kolejce lub na zapis linii.
+      std::condition_variable space;
+      std::deque<item_t> queue;
+      std::thread thread;
+      //! Pojemność kolejki (w liniach).
+      std::size_t capacity;
+      //! Zachowanie przy pełnej kolejce.
+      overload_t overload;
+      //! Liczba linii w kolejce (razem z zapisywanymi).
+      std::size_t depth=0;
+      //! Informacja, że kolejka nie przyjmuje już linii (wątek kończy się po zapisaniu kolejki).
+      bool stop=false;
+      //! Informacja, że wątek wyjścia czeka na linie (tylko wtedy trzeba go budzić).
+      bool idle=false;
+      //! Liczba wątków czekających na miejsce w kolejce i na zapis linii.
+      std::size_t full_waiters=0,drain_waiters=0;
+      //! Czas włożenia zapisywanych linii (0 - brak).
+      uint64_t current=0;
+      //! Numer ostatniej zapisywanej linii (0 - brak).
+      uint64_t current_seq=0;
+      //! Liczniki linii włożonych, zapisanych i czekających na miejsce.
+      uint64_t pushed=0,delivered=0,full=0;
+      //! Liczba odrzuconych linii według poziomu logowania (od uruchomienia i w ostatniej linii z podsumowaniem).
+      uint64_t dropped[6]={},reported[6]={};
+      //! Liczba odrzuconych linii, które nie trafiły jeszcze do podsumowania.
+      uint64_t unreported=0;
+      //! Czas, przed którym nie jest zapisywane kolejne podsumowanie.
+      std::chrono::steady_clock::time_point summary_time;
+      //! Ostatni filtr wyjścia (dla linii z podsumowaniem).
+      flags_t last_filter=0x0;
+      //! Liczba elementów kolejki, które można odrzucić, według ważności (overload_drop_severity nie musi przeglądać kolejki).
+      std::size_t droppable_count[8]={};
+      //Informacja, czy linie mogą być odrzucone przez overload_drop_severity (linie critical i error nie są odrzucane).
+      static bool droppable(const shared_lines_t & l){
+        return(!(l.severities&(critical|error)));
+      }
+      //Ważność linii - poziom logowania najważniejszej z nich (0 - critical ... 5 - debug).
+      static int rank(const shared_lines_t & l){
+        return(__builtin_ctz(l.severities|0x80));
+      }
+      //Uwzględnia element wstawiany do kolejki (delta=1) lub z niej usuwany (delta=-1).
+      void count(const shared_lines_t & l,int delta){
+        if (droppable(l)) droppable_count[rank(l)]+=delta;
+      }
+      //Odrzuca linie (wywoływana pod muteksem kolejki).
+      void drop(const shared_lines_t & l){
+        for (const log_string_t & in: l.lines) dropped[std::min(__builtin_ctz(in.severity|0x80),5)]++;
+        unreported+=l.lines.size();
+        stats_count(stat_queue_dropped,l.lines.size());
+      }
+      //Odrzuca element kolejki (wywoływana pod muteksem kolejki).
+      void drop_at(std::deque<item_t>::iterator it){
+        const std::size_t n(it->lines->lines.size());
+        drop(*it->lines);
+        count(*it->lines,-1);
+        queue.erase(it);
+        depth-=n;
+        if (drain_waiters||full_waiters) space.notify_all();//Odrzucone linie nie zostaną już zapisane.
+      }
+      //!
+      //! @brief Zwalnia miejsce w pełnej kolejce według overload_t (wywoływana pod muteksem kolejki).
+      //!
+      //! @param [in] lines Wstawiane linie.
+      //! @return Wartość true, jeśli wstawiane linie zostały odrzucone.
+      //!
+      bool make_room(const shared_lines_t & lines){
+        const std::size_t n(lines.lines.size());
+        switch (overload){
+          case overload_drop_newest:
+            drop(lines);
+            return(true);
+          case overload_drop_oldest:
+            //Zapisywane linie nie mogą być odrzucone - kolejka może je przekroczyć.
+            while (queue.size()&&(capacity<(depth+n))) drop_at(queue.begin());
+            return(false);
+          case overload_drop_severity:
+            while (capacity<(depth+n)){//Najpierw najstarsze linie najniższego poziomu.
+              const int in(droppable(lines)?rank(lines):-1);
+              int lowest(7);
+              while ((0<=lowest)&&!droppable_count[lowest]) lowest--;
+              if (in<lowest){
+                std::deque<item_t>::iterator victim(queue.begin());
+                while (!droppable(*victim->lines)||(rank(*victim->lines)!=lowest)) ++victim;
+                drop_at(victim);
+              } else if (0<=in) {
+                drop(lines);
+                return(true);
               } else {
-                  if (log_buffer->size()==max) {
-                    log_line_t<char> log_warn;
-                    log_warn.buffered=true;
-                    log_warn.line="logger.cpp";
-                    log_warn.line+=" (";
-                    log_warn.line+=__PRETTY_FUNCTION__;
-                    log_warn.line+=") ";
-                    log_warn.line+="Bufor loggera osiągnął maksymalny rozmiar!";
-                    log_warn.severity=warning;
-                    output::log_stream_out(log_warn);//Zapisz w strumieniach wyjściowych.
-                    output::log_syslog_out(log_warn);//Zapisz w syslog.
-                    log_buffer->push_back(log_line);//Dodaj do bufora.
-                  }
+                break;//Linie critical i error czekają na miejsce.
               }
             }
-        } else {//Jeśli zapis nie jest buforowany.
-          output::log_stream_out(log_line);//Zapisz w strumieniach wyjściowych.
-          output::log_syslog_out(log_line);//Zapisz w syslog.
+            return(false);
+          default:
+            return(false);
+        }
+      }
+      //Zapisuje do wyjścia liczbę odrzuconych linii (wywoływana w wątku wyjścia pod muteksem kolejki).
+      void summarize(std::unique_lock<std::mutex> & lock,bool force){
+        if (!unreported) return;
+        const std::chrono::steady_clock::time_point now(std::chrono::steady_clock::now());
+        if (!force&&(now<summary_time)) return;
+        uint64_t counts[6];
+        for (std::size_t k=0;k<6;k++){
+          counts[k]=dropped[k]-reported[k];
+          reported[k]=dropped[k];
+        }
+        unreported=0;
+        summary_time=now+std::chrono::seconds(1);
+        const flags_t filter(last_filter|warning);
+        lock.unlock();
+        TRY_BEGIN
+        deliver(*log_drop_summary(name,counts),filter);
+        TRY_END
+        lock.lock();
+      }
+      void run(){
+        std::unique_lock<std::mutex> lock(mutex);
+        for(;;){
+          if (!stop&&queue.empty()){
+            idle=true;
+            if (unreported) wake.wait_until(lock,summary_time,[this]{return(stop||queue.size());});
+            else wake.wait(lock,[this]{return(stop||queue.size());});
+            idle=false;
+          }
+          summarize(lock,stop&&queue.empty());
+          if (queue.empty()){
+            if (stop) break;
+            continue;
+          }
+          item_t item(std::move(queue.front()));
+          count(*item.lines,-1);
+          queue.pop_front();
+          current=item.queued;
+          current_seq=item.seq;
+          last_filter=item.filter;
+          lock.unlock();
+          TRY_BEGIN
+          deliver(*item.lines,item.filter);
+          TRY_END
+          const std::size_t n(item.lines->lines.size());
+          item.lines.reset();
+          lock.lock();
+          current=0;
+          current_seq=0;
+          depth-=n;
+          delivered+=n;
+          //Wątki czekające na miejsce są budzone, gdy kolejka opróżni się do połowy (a nie po każdej linii).
+          if (drain_waiters||(full_waiters&&((depth*2)<=capacity))) space.notify_all();
         }
       }
-      TRY_END
-      //Zakończ.
-      return(c);
-    }
-  };
-  //==========================================================================
-  //! Klasa obsługująca logowanie na wszystkich poziomach (pojedynczy logger).
-  template <
-    typename charT=char,
-    typename traits=std::char_traits<charT>
-  > 
-  class Single:
-    public std::basic_ostringstream<charT,traits> 
-  {
-  public:
-    typedef logger::Buffer<charT,traits> logger_buffer_t;
-    typedef std::basic_ostream<charT,traits> basic_ostream_t;
-    typedef std::vector<log_line_t<charT>> log_line_vector_t;
-  private:
-    //! Loger dla pojedynczego poziomu logowania.
-    class StreamPack{
     public:
-      logger_buffer_t buffer;
-      basic_ostream_t stream;
-      StreamPack(ict::logger::flags_t severity,bool buffered,log_line_vector_t * log_buffer):
-        buffer(severity,buffered,log_buffer),stream(&buffer)
-      {}
-    };
-    typedef std::map<ict::logger::flags_t,std::unique_ptr<StreamPack>> stream_map_t;
-    //! Mapa logerów dla różnych poziomów.
-    stream_map_t logger_map;
-    //! Poziomy logowania bez buforowania na tej warstwie.
-    ict::logger::flags_t direct;
-    //! Poziomy logowania, które powodują opróżnienie bufora na tej warstwie.
-    ict::logger::flags_t dump;
-    //! Poziomy logowania, które są aktywne na tej warstwie.
-    ict::logger::flags_t active;
-    //! Poziomy logowania, które zostały wykonane na tej warstwie.
-    ict::logger::flags_t done;
-  public:
-    //!
-    //! @brief Konstruktor.
-    //! 
-    //! @param [in] direct_in Poziomy logowania bez buforowania na tej warstwie.
-    //! @param [in] buffered_in Poziomy logowania z buforowaniem na tej warstwie.
-    //! @param [in] dump_in Poziomy logowania, które powodują opróżnienie bufora na tej warstwie.
-    //!
-    Single(
-      ict::logger::flags_t direct_in,
-      ict::logger::flags_t buffered_in,
-      ict::logger::flags_t dump_in
-    ):direct(direct_in),dump(dump_in),active(direct_in|buffered_in),done(0){}
-    ~Single(){
-      TRY_BEGIN
-      if (dump&done)//Jeśli pojawił się poziom, który wyzwala zrzut z buforów logujących
-        doDump();//Zrób zrzut.
-      TRY_END
+      Worker(const std::string & name_in,std::size_t capacity_in,overload_t overload_in,deliver_t deliver_in):
+        name(name_in),deliver(deliver_in),capacity(std::max<std::size_t>(capacity_in,1)),overload(overload_in)
+      {
+        thread=std::thread(&Worker::run,this);
+      }
+      ~Worker(){
+        TRY_BEGIN
+        close();
+        TRY_END
+      }
+      Worker(const Worker &)=delete;
+      Worker & operator=(const Worker &)=delete;
+      //!
+      //! @brief Wkłada linie do kolejki (jeśli kolejka jest pełna, to czeka lub odrzuca linie według overload_t).
+      //!
+      //! @param [in] lines Wspólne linie.
+      //! @param [in] filter Filtr wyjścia w migawce.
+      //! @return Wartość false, jeśli kolejka jest zamknięta (linie należy zapisać bezpośrednio).
+      //!
+      bool push(const shared_lines_ptr & lines,flags_t filter=0x0){
+        const std::size_t n(lines->lines.size());
+        std::unique_lock<std::mutex> lock(mutex);
+        if (stop) return(false);
+        if (depth&&(capacity<(depth+n))){
+          full+=n;
+          if (make_room(*lines)) return(true);
+          //Czekają: overload_block, linie critical i error przy overload_drop_severity (zrzut większy niż kolejka czeka na pustą kolejkę).
+          if ((overload!=overload_drop_oldest)&&depth&&(capacity<(depth+n))){
+            full_waiters++;
+            space.wait(lock,[this,n]{return(stop||!depth||((depth+n)<=capacity));});
+            full_waiters--;
+            if (stop) return(false);
+          }
+        }
+        depth+=n;
+        pushed+=n;
+        queue.push_back({lines,filter,stats_now(),pushed});
+        count(*lines,1);
+        if (idle) wake.notify_one();
+        return(true);
+      }
+      //! Czeka na zapis (lub odrzucenie) linii włożonych przed wywołaniem.
+      void drain(){
+        std::unique_lock<std::mutex> lock(mutex);
+        if (thread.get_id()==std::this_thread::get_id()) return;
+        const uint64_t mark(pushed);
+        drain_waiters++;
+        //Numery elementów w kolejce rosną (odrzucenie elementu nie zmienia kolejności pozostałych), więc wystarczy sprawdzić pierwszy.
+        space.wait(lock,[this,mark]{return(((!current_seq)||(mark<current_seq))&&(queue.empty()||(mark<queue.front().seq)));});
+        drain_waiters--;
+      }
+      //! Zmienia pojemność kolejki i zachowanie przy pełnej kolejce.
+      void configure(std::size_t capacity_in,overload_t overload_in){
+        std::lock_guard<std::mutex> lock(mutex);
+        capacity=std::max<std::size_t>(capacity_in,1);
+        overload=overload_in;
+        space.notify_all();
+      }
+      //! Zamyka kolejkę i czeka na zapis wszystkich linii (kolejne linie należy zapisywać bezpośrednio).
+      void close(){
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          stop=true;
+          wake.notify_one();
+          space.notify_all();
+        }
+        if (thread.joinable()&&(thread.get_id()!=std::this_thread::get_id())) thread.join();
+      }
+      //! Podaje stan kolejki.
+      queue_stats_t getStats(){
+        queue_stats_t out;
+        std::lock_guard<std::mutex> lock(mutex);
+        const uint64_t oldest(current?current:(queue.size()?queue.front().queued:0));
+        out.output=name;
+        out.depth=depth;
+        out.capacity=capacity;
+        if (oldest) out.lag=stats_now()-oldest;
+        out.lines=delivered;
+        out.full=full;
+        for (std::size_t k=0;k<6;k++) out.dropped[k]=dropped[k];
+        return(out);
+      }
     };
-    //! Bufor linii loga.
-    log_line_vector_t log_buffer;
-    //!
-    //! @brief Zrzuca cały bufor linii loga.
-    //! 
-    void doDump(){
-      TRY_BEGIN
-      for (log_line_t<charT> & l: log_buffer){//Cały bufor.
-        output::log_stream_out(l);//Zapisz w strumieniach wyjściowych.
-        output::log_syslog_out(l);//Zapisz w syslog.
+    //! Wyjście zapisujące gotowe linie tekstowe (np. plik).
+    class Sink {
+    public:
+      //! Mutex zapisu do wyjścia.
+      std::mutex mutex;
+      //! Filtr logów.
+      flags_t filter=0x0;
+      //! Wątek wyjścia z własną kolejką (nullptr - zapis w wątku, który loguje); musi być zamknięty przez klasę pochodną.
+      std::unique_ptr<Worker> worker;
+      virtual ~Sink(){}
+      //!
+      //! @brief Zapisuje linię (wywoływana pod muteksem wyjścia).
+      //!
+      //! @param [in] in Linia loga.
+      //! @param [in] text Postać tekstowa linii (razem ze znakiem końca linii).
+      //!
+      virtual void write(const log_string_t & in,const std::string & text)=0;
+      //!
+      //! @brief Zapisuje zrzut bufora warstwy (wywoływana pod muteksem wyjścia).
+      //!
+      //! @param [in] lines Opis linii w bloku.
+      //! @param [in] block Postać tekstowa wszystkich linii.
+      //!
+      virtual void writeBatch(const batch_vector_t & lines,const std::string & block){
+        log_string_t in;
+        in.buffered=true;
+        for (const batch_line_t & l: lines) if (l.severity&filter){
+          in.severity=l.severity;
+          in.time.t=l.t;
+          write(in,block.substr(l.offset,l.size));
+        }
       }
-      log_buffer.clear();//Wyczyść bufor.
-      TRY_END
-    }
-    basic_ostream_t & getLogger(flags_t severity){
-      static BlackHole<charT> blackHoleBuff;
-      static basic_ostream_t blackHole(&blackHoleBuff);
-      TRY_BEGIN
-      const static std::set<ict::logger::flags_t> severity_set({
-        critical,error,warning,
-        notice,info,debug
-      });
-      done|=severity;//Zaznacz, że był taki.
-      if ((severity_set.count(severity))&&(active&severity)){//Jeśli poziom logowania jest prawidłowy i aktywny na tej warstwie.
-        if (!logger_map.count(severity)){//Jeśli loger na takim poziomie nie istnieje
-          logger_map[severity].reset(new StreamPack(severity,!(severity&direct),&log_buffer));//Stwórz logera.
+      //! Zapisuje zawartość bufora (wywoływana pod muteksem wyjścia).
+      virtual void flush(){}
+      //! Informacja, czy wyjście zostało poprawnie otwarte.
+      virtual bool good() const {return(true);}
+      //! Informacja, czy wyjście otrzymuje linie buforowane w chwili ich powstania (a nie przy opróżnieniu bufora).
+      virtual bool captures() const {return(false);}
+      //! Informacja, czy wyjście potrzebuje linii w pierwotnej postaci (zrzut bufora jest przekazywany przez write() linia po linii).
+      virtual bool structured() const {return(false);}
+      //!
+      //! @brief Zapisuje linię buforowaną w chwili jej powstania (wywoływana pod muteksem wyjścia, jeśli captures()).
+      //!
+      //! @param [in] in Linia loga.
+      //!
+      virtual void capture(const log_string_t & /*in*/){}
+      //! Zadania okresowe wymagające wstrzymania zapisu (wywoływana przez wątek porządkowy pod muteksem wyjścia).
+      virtual void tick(){}
+      //! Zadania okresowe, które nie wymagają wstrzymania zapisu (wywoływana przez wątek porządkowy poza muteksem wyjścia).
+      virtual void background(){}
+      //! Najdłuższy odstęp (w milisekundach) między wywołaniami tick(), jakiego wymaga wyjście (0 - bez wymagań).
+      virtual unsigned period() const {return(0);}
+      //Zapisuje linie przekazane przez wątek wyjścia.
+      void deliver(const shared_lines_t & l){
+        static const std::string empty;
+        OutputLock lock(mutex);
+        if (!l.dump){
+          write(l.lines.front(),l.block);
+        } else if (structured()){
+          for (const log_string_t & in: l.lines) if (in.severity&filter) write(in,empty);
+        } else {
+          writeBatch(l.meta,l.block);
         }
-        return(logger_map[severity]->stream);//Zwróć go.
       }
-      TRY_END
-      return(blackHole);
-    }
-  };
-  typedef Single<char> single_char_t;
-  //==========================================================================
-  //! Klasa obsługująca stos logerów.
-  template <
-    typename charT=char,
-    typename traits=std::char_traits<charT>
-  > 
-  class Stack
-  {
-  public:
-    typedef Single<charT,traits> single_t;
-    typedef std::stack<std::unique_ptr<single_t>> stack_t;
-  private:
-    //! Muteks stosu logerów,
-    std::mutex stack_mutex;
-    //! Stos logerów,
-    stack_t stack;
-  public:
-    //!
-    //! @brief Podaje referencję do najwyższego logera.
-    //! 
-    single_t & operator ()(){
-      std::lock_guard<std::mutex> lock(stack_mutex);
-      return(*(stack.top()));
-    }
+    };
+    typedef std::map<std::string,std::shared_ptr<Sink>> sink_map_t;
     //!
-    //! @brief Dokłada nowego logger na stos.
-    //! 
-    //! @param [in] direct_in Poziomy logowania bez buforowania na tej warstwie.
-    //! @param [in] buffered_in Poziomy logowania z buforowaniem na tej warstwie.
-    //! @param [in] dump_in Poziomy logowania, które powodują opróżnienie bufora na tej warstwie.
-    //! @return Liczba logerów na stosie.
+    //! @brief Kompresuje plik po rotacji (gzip) i usuwa oryginał.
     //!
-    std::size_t push(
-      ict::logger::flags_t direct_in,
-      ict::logger::flags_t buffered_in,
-      ict::logger::flags_t dump_in
-    ){
-      std::lock_guard<std::mutex> lock(stack_mutex);
-      stack.emplace(new single_t(direct_in,buffered_in,dump_in));
-      return(stack.size());
-    }
+    //! Wynik jest zapisywany do pliku tymczasowego (.nazwa.gz.part), a jego nazwa jest zmieniana po zakończeniu,
+    //! więc plik .gz jest zawsze kompletny.
     //!
-    //! @brief Zdejmuje loggera ze stosu, jeśli nie jest to ostatni loger.
-    //! 
-    //! @return Liczba logerów na stosie.
+    //! @param [in] name Ścieżka pliku.
+    //! @param [in] level Poziom kompresji (1-9).
     //!
-    std::size_t pop(){
-      std::lock_guard<std::mutex> lock(stack_mutex);
-      if (stack.size()>0){
-        stack.pop();
+    static void compress_file(const std::string & name,unsigned level){
+#ifdef LOGGER_ZLIB
+      const std::filesystem::path p(name);
+      const std::string part((p.parent_path()/("."+p.filename().native()+".gz.part")).native());
+      const std::string gz(name+".gz");
+      struct timespec start,end;
+      ::clock_gettime(CLOCK_THREAD_CPUTIME_ID,&start);
+      const int in(::open(name.c_str(),O_RDONLY|O_CLOEXEC));
+      if (in<0) return;//Plik został już usunięty.
+      const char mode[4]={'w','b',char('0'+std::min(std::max(level,1u),9u)),0};
+      gzFile out(::gzopen(part.c_str(),mode));
+      bool ok(out!=nullptr);
+      uint64_t size(0);
+      if (ok){
+        std::vector<char> buffer(256*1024);
+        for(;;){
+          const ssize_t r(::read(in,buffer.data(),buffer.size()));
+          if (r<0){
+            if (errno==EINTR) continue;
+            ok=false;
+            break;
+          }
+          if (!r) break;
+          if (::gzwrite(out,buffer.data(),r)!=r) {ok=false;break;}
+          size+=r;
+        }
+        if (::gzclose(out)!=Z_OK) ok=false;
+      }
+      ::close(in);
+      struct stat st;
+      //Plik mógł zostać usunięty w czasie kompresji (liczba zachowywanych plików).
+      if (ok&&(::access(name.c_str(),F_OK)==0)&&(::stat(part.c_str(),&st)==0)&&(::rename(part.c_str(),gz.c_str())==0)){
+        ::unlink(name.c_str());
+        ::clock_gettime(CLOCK_THREAD_CPUTIME_ID,&end);
+        stats_count(stat_compressed);
+        stats_count(stat_compress_in,size);
+        stats_count(stat_compress_out,st.st_size);
+        stats_count(stat_compress_cpu,(end.tv_sec-start.tv_sec)*1000000000ll+(end.tv_nsec-start.tv_nsec));
+      } else {
+        ::unlink(part.c_str());
       }
-      return(stack.size());
+#endif
     }
-    //!
-    //! @brief Zwraca liczbę logerów na stosie.
-    //! 
-    //! @return Liczba logerów na stosie.
-    //!
-    std::size_t size(){
-      std::lock_guard<std::mutex> lock(stack_mutex);
-      return(stack.size());
+    //! Wątek kompresji plików po rotacji (najniższy priorytet procesora i dysku).
+    class Compressor {
+    private:
+      std::mutex mutex;
+      std::condition_variable wake;
+      std::thread thread;
+      bool stop=false;
+      //! Pliki do kompresji (ścieżka i poziom kompresji).
+      std::vector<std::pair<std::string,unsigned>> jobs;
+      //! Pliki w kolejce lub w trakcie kompresji.
+      std::set<std::string> queued;
+      void run(){
+        //Wątek pracuje tylko wtedy, gdy procesor i dysk nie mają innej pracy.
+        struct sched_param param={};
+        ::pthread_setschedparam(::pthread_self(),SCHED_IDLE,&param);
+        ::syscall(SYS_ioprio_set,1,0,3<<13);//IOPRIO_WHO_PROCESS (bieżący wątek), IOPRIO_CLASS_IDLE.
+        std::unique_lock<std::mutex> lock(mutex);
+        for(;;){
+          wake.wait(lock,[this]{return(stop||jobs.size());});
+          if (stop) break;
+          const std::pair<std::string,unsigned> job(jobs.front());
+          jobs.erase(jobs.begin());
+          lock.unlock();
+          TRY_BEGIN
+          compress_file(job.first,job.second);
+          TRY_END
+          lock.lock();
+          queued.erase(job.first);
+        }
+      }
+    public:
+      ~Compressor(){
+        TRY_BEGIN
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          stop=true;
+          wake.notify_one();
+        }
+        if (thread.joinable()) thread.join();
+        TRY_END
+      }
+      //! Dodaje plik do kompresji (wątek jest uruchamiany przy pierwszym pliku).
+      void push(const std::string & name,unsigned level){
+#ifdef LOGGER_ZLIB
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stop||!queued.insert(name).second) return;
+        jobs.emplace_back(name,level);
+        if (!thread.joinable()) thread=std::thread(&Compressor::run,this);
+        wake.notify_one();
+#endif
+      }
+    };
+    static Compressor & compressor(){
+      static Compressor c;
+      return(c);
     }
-  };
-  //==========================================================================
-  //! Mapa stosów logerów dla wątków (char).
-  typedef Stack<char> stack_char_t;
-  typedef std::map<std::thread::id,stack_char_t> stack_map_char_t;
-  static stack_map_char_t & get_map_char(){
-    static stack_map_char_t map_char;
-    return(map_char);
-  }
-  //==========================================================================
-  namespace input {
+    //! Plik wyjściowy z buforem w pamięci i rotacją.
+    class FileSink:public Sink {
+    private:
+      //! Ścieżka pliku.
+      const std::string path;
+      //! Ścieżka pliku przygotowanego na następną rotację.
+      const std::string spare_path;
+      //! Ustawienia pliku.
+      const file_options_t options;
+      //! Deskryptor bieżącego pliku.
+      int fd=-1;
+      //! Bufor linii.
+      std::string buffer;
+      //! Rozmiar bieżącego pliku (razem z buforem).
+      std::size_t size=0;
+      //! Czas, od którego należy wykonać rotację według czasu.
+      std::time_t deadline=0;
+      //! Czas, przed którym nie jest ponawiana nieudana rotacja (0 - brak).
+      std::time_t retry=0;
+      //! Odstęp (w sekundach) między próbami nieudanej rotacji.
+      static const std::time_t retry_interval=10;
+      //! Czas ostatniego zapisu bufora do pliku.
+      std::chrono::steady_clock::time_point flushed;
+      //! Mutex dla pliku przygotowanego na następną rotację i informacji o rotacji.
+      std::mutex spare_mutex;
+      //! Deskryptor pliku przygotowanego na następną rotację (-1 - brak).
+      int spare=-1;
+      //! Informacja, że wykonano rotację (należy usunąć nadmiarowe pliki).
+      bool rotated=false;
+      //! Pliki po rotacji, które należy skompresować.
+      std::vector<std::string> finished;
+      //! Informacja, że należy poszukać plików po rotacji, które nie zostały skompresowane (np. przed ponownym uruchomieniem).
+      bool scan=false;
+      static int open_file(const std::string & name){
+        return(::open(name.c_str(),O_WRONLY|O_CREAT|O_APPEND|O_CLOEXEC,0644));
+      }
+      static std::string get_spare_path(const std::string & name){
+        const std::filesystem::path p(name);
+        return((p.parent_path()/("."+p.filename().native()+".next")).native());
+      }
+      //Zapisuje bufor i podaną linię jednym wywołaniem writev.
+      void write_out(const char * data,std::size_t n){
+        struct iovec iov[2]={
+          {const_cast<char *>(buffer.data()),buffer.size()},
+          {const_cast<char *>(data),n}
+        };
+        struct iovec * v(iov);
+        int count(2);
+        while (count){
+          if (!v->iov_len) {v++;count--;continue;}
+          const ssize_t w(::writev(fd,v,count));
+          if (w<0){
+            if (errno==EINTR) continue;
+            break;//Błąd zapisu - dane są tracone.
+          }
+          std::size_t k(w);
+          while (count&&(v->iov_len<=k)) {k-=v->iov_len;v++;count--;}
+          if (count) {
+            v->iov_base=static_cast<char *>(v->iov_base)+k;
+            v->iov_len-=k;
+          }
+        }
+        buffer.clear();
+        flushed=std::chrono::steady_clock::now();
+      }
+      //Wylicza czas następnej rotacji według czasu (okresy liczone od północy czasu lokalnego).
+      void set_deadline(std::time_t t){
+        if (!options.max_age) return;
+        struct tm tm;
+        ::localtime_r(&t,&tm);
+        const std::time_t local(t+tm.tm_gmtoff);
+        deadline=local-(local%options.max_age)+options.max_age-tm.tm_gmtoff;
+      }
+      //Podaje nazwę pliku po rotacji.
+      std::string segment_path(std::time_t t) const {
+        struct tm tm;
+        char stamp[32];
+        ::localtime_r(&t,&tm);
+        std::strftime(stamp,sizeof(stamp),"%Y%m%d-%H%M%S",&tm);
+        const std::string name(path+"."+stamp);
+        std::string out(name);
+        for (unsigned k=1;(::access(out.c_str(),F_OK)==0);k++){//Kolejne pliki w tej samej sekundzie (nazwy zachowują kolejność).
+          char suffix[16];
+          std::snprintf(suffix,sizeof(suffix),".%03u",k);
+          out=name+suffix;
+        }
+        return(out);
+      }
+      //Zamienia bieżący plik na nowy (bieżący otrzymuje nazwę z czasem rotacji).
+      void rotate(std::time_t t){
+        const std::string segment(segment_path(t));
+        int next(-1);
+        {
+          std::lock_guard<std::mutex> lock(spare_mutex);
+          std::swap(next,spare);
+        }
+        if (::link(path.c_str(),segment.c_str())==0){
+          if ((0<=next)&&(::rename(spare_path.c_str(),path.c_str())==0)){//Podmiana nazwy jest atomowa.
+          } else {
+            ::unlink(path.c_str());
+            if (0<=next) {::close(next);next=-1;}
+          }
+        } else if (::rename(path.c_str(),segment.c_str())==0){
+          if ((0<=next)&&(::rename(spare_path.c_str(),path.c_str())!=0)) {::close(next);next=-1;}
+        } else {//Nie udało się zmienić nazwy - dopisuj dalej do bieżącego pliku (kolejna próba po retry_interval).
+          if (0<=next){
+            std::lock_guard<std::mutex> lock(spare_mutex);
+            std::swap(next,spare);
+          }
+          retry=t+retry_interval;
+          set_deadline(t);
+          return;
+        }
+        {
+          std::lock_guard<std::mutex> lock(spare_mutex);
+          rotated=true;
+        }
+        if (next<0) next=open_file(path);//Brak przygotowanego pliku - utwórz go teraz.
+        if (next<0) {//Dopisuj dalej do pliku po rotacji (nie jest kompresowany, dopóki jest zapisywany).
+          retry=t+retry_interval;
+          return;
+        }
+        ::close(fd);
+        fd=next;
+        size=0;
+        retry=0;
+        set_deadline(t);
+        if (options.compress){
+          std::lock_guard<std::mutex> lock(spare_mutex);
+          finished.push_back(segment);
+        }
+      }
+      //Podaje pliki po rotacji (bez rozszerzenia .gz, posortowane od najstarszego).
+      std::vector<std::string> list_segments() const {
+        const std::filesystem::path p(path);
+        const std::string prefix(p.filename().native()+".");
+        std::set<std::string> segments;
+        std::error_code ec;
+        for (const std::filesystem::directory_entry & e: std::filesystem::directory_iterator(p.parent_path().empty()?".":p.parent_path(),ec)){
+          const std::string name(e.path().filename().native());
+          if ((prefix.size()<name.size())&&(name.compare(0,prefix.size(),prefix)==0)&&std::isdigit(name[prefix.size()])){
+            std::string segment(e.path().native());
+            if ((3<segment.size())&&(segment.compare(segment.size()-3,3,".gz")==0)) segment.resize(segment.size()-3);
+            segments.insert(segment);
+          }
+        }
+        return(std::vector<std::string>(segments.begin(),segments.end()));
+      }
+      //Usuwa najstarsze pliki po rotacji ponad zadaną liczbę (plik i jego wersja skompresowana liczą się jako jeden).
+      void remove_old(){
+        const std::vector<std::string> segments(list_segments());
+        if (segments.size()<=options.keep) return;
+        for (std::size_t k=0;k<(segments.size()-options.keep);k++) {
+          ::unlink(segments[k].c_str());
+          ::unlink((segments[k]+".gz").c_str());
+        }
+      }
+    public:
+      FileSink(const std::string & path_in,flags_t filter_in,const file_options_t & options_in):
+        path(path_in),spare_path(get_spare_path(path_in)),options(options_in),flushed(std::chrono::steady_clock::now())
+      {
+        struct stat st;
+        filter=filter_in;
+        buffer.reserve(options.buffer);
+        fd=open_file(path);
+        if (fd<0) return;
+        if (::fstat(fd,&st)==0) size=st.st_size;
+        set_deadline(size?st.st_mtime:std::time(nullptr));
+        if (options.max_size||options.max_age) spare=open_file(spare_path);
+        rotated=(options.keep!=0);
+        scan=(options.compress!=0);
+        if (options.queue) worker.reset(new Worker("file:"+path,options.queue,options.overload,[this](const shared_lines_t & l,flags_t){deliver(l);}));
+      }
+      ~FileSink(){
+        if (worker) worker->close();//Linie z kolejki trafiają do pliku przed jego zamknięciem.
+        flush();
+        if (0<=fd) ::close(fd);
+        if (0<=spare) {
+          ::close(spare);
+          ::unlink(spare_path.c_str());
+        }
+        for (const std::string & segment: finished) compressor().push(segment,options.compress);
+      }
+      bool good() const {return(0<=fd);}
+      //Zapisuje linię (z rotacją, jeśli jest potrzebna).
+      void put(std::time_t t,const char * text,std::size_t n){
+        if (size&&(retry<=t)&&(
+          (options.max_size&&(options.max_size<(size+n)))||
+          (options.max_age&&(deadline<=t))
+        )){
+          flush();
+          rotate(t);
+        }
+        size+=n;
+        if ((buffer.size()+n)<=options.buffer){
+          buffer.append(text,n);
+        } else {
+          write_out(text,n);
+        }
+      }
+      void write(const log_string_t & in,const std::string & text){
+        if (fd<0) return;
+        if (options.json){
+          static thread_local std::string json;
+          json.clear();
+          log_json_encode(json,in);
+          put(in.time.t,json.data(),json.size());
+        } else {
+          put(in.time.t,text.data(),text.size());
+        }
+        if (in.severity&options.flush_severity) flush();
+      }
+      bool structured() const {return(options.json);}
+      void writeBatch(const batch_vector_t & lines,const std::string & block){
+        if (fd<0) return;
+        flags_t severities(0x0);
+        std::size_t n(0);
+        for (const batch_line_t & l: lines) if (l.severity&filter) {
+          n+=l.size;
+          severities|=l.severity;
+        }
+        if (!options.max_size&&!options.max_age&&(n==block.size())){//Bez rotacji - cały blok jednym zapisem.
+          size+=n;
+          if ((buffer.size()+n)<=options.buffer) buffer+=block; else write_out(block.data(),n);
+        } else {
+          for (const batch_line_t & l: lines) if (l.severity&filter) put(l.t,block.data()+l.offset,l.size);
+        }
+        if (severities&options.flush_severity) flush();
+      }
+      void flush(){
+        if ((0<=fd)&&buffer.size()) write_out(nullptr,0);
+      }
+      void tick(){
+        if (fd<0) return;
+        const std::time_t t(std::time(nullptr));
+        if (size&&options.max_age&&(deadline<=t)){
+          flush();
+          rotate(t);
+        } else if ((std::chrono::steady_clock::now()-flushed)>=std::chrono::milliseconds(options.flush_interval)){
+          flush();
+        }
+      }
+      unsigned period() const {return(options.flush_interval);}
+      void background(){
+        bool need,old;
+        std::vector<std::string> segments;
+        {
+          std::lock_guard<std::mutex> lock(spare_mutex);
+          need=(spare<0)&&(options.max_size||options.max_age)&&(0<=fd);
+          old=rotated;
+          rotated=false;
+          segments.swap(finished);
+        }
+        if (scan){//Pliki po rotacji, które nie zostały skompresowane (tylko przy pierwszym wywołaniu).
+          scan=false;
+          for (const std::string & segment: list_segments()) if (::access(segment.c_str(),F_OK)==0) segments.push_back(segment);
+        }
+        for (const std::string & segment: segments) compressor().push(segment,options.compress);
+        if (need){//Przygotuj plik na następną rotację (bez wstrzymywania zapisu).
+          const int next(open_file(spare_path));
+          std::lock_guard<std::mutex> lock(spare_mutex);
+          if (spare<0) spare=next; else if (0<=next) ::close(next);
+        }
+        if (old&&options.keep) remove_old();
+      }
+    };
+    //! Nagłówek pliku rejestratora (przed obszarem danych).
+    struct recorder_header_t {
+      //! Znacznik pliku rejestratora.
+      char magic[8];
+      //! Pojemność obszaru danych (w bajtach).
+      uint64_t capacity;
+      //! Pozycja początku najstarszego zachowanego rekordu (liczona od początku zapisu, bez zawijania).
+      std::atomic<uint64_t> tail;
+      //! Pozycja końca ostatniego zapisanego rekordu (liczona od początku zapisu, bez zawijania).
+      std::atomic<uint64_t> head;
+    };
+    //! Nagłówek rekordu w obszarze danych rejestratora (za nim: ścieżka pliku, nazwa funkcji i treść linii).
+    struct recorder_record_t {
+      //! Rozmiar rekordu (razem z nagłówkiem).
+      uint32_t size;
+      //! Numer linii w kodzie.
+      uint32_t line;
+      //! Czas powstania linii (sekundy).
+      int64_t t;
+      //! Ułamek sekundy.
+      uint32_t frac;
+      //! Przesunięcie strefy czasowej względem UTC (sekundy).
+      int32_t gmtoff;
+      //! Długość ścieżki pliku (0 - brak miejsca w kodzie).
+      uint16_t file_size;
+      //! Długość nazwy funkcji.
+      uint16_t function_size;
+      //! Poziom logowania.
+      uint8_t severity;
+      //! Liczba cyfr ułamka sekundy.
+      uint8_t digits;
+    };
+    //! Znacznik pliku rejestratora (wersja 1 - tekst, wersja 2 - rekordy).
+    static const char recorder_magic_text[8]={'I','C','T','R','E','C','\x01','\n'};
+    static const char recorder_magic[8]={'I','C','T','R','E','C','\x02','\n'};
+    //! Położenie obszaru danych w pliku rejestratora.
+    static const std::size_t recorder_offset=64;
+    //! Rejestrator - plik odwzorowany w pamięci, używany jako bufor cykliczny (przetrwa zabicie procesu).
+    class RecorderSink:public Sink {
+    private:
+      //! Deskryptor pliku.
+      int fd=-1;
+      //! Rozmiar odwzorowania.
+      std::size_t length=0;
+      //! Nagłówek (początek odwzorowania).
+      recorder_header_t * header=nullptr;
+      //! Obszar danych.
+      char * ring=nullptr;
+      //! Pojemność obszaru danych.
+      std::size_t capacity=0;
+      //! Ścieżki plików względem katalogu bazowego (ustalane raz dla każdego pliku).
+      std::unordered_map<const char *,std::string> paths;
+      //! Sekunda, dla której ostatnio sprawdzono strefę czasową.
+      std::time_t zone_t=-1;
+      //! Przesunięcie strefy czasowej.
+      long gmtoff=0;
+      //! Bufor pól linii strukturalnej.
+      std::string fields;
+      //Kopiuje dane do obszaru danych (z zawinięciem).
+      void put(uint64_t position,const char * s,std::size_t n){
+        const std::size_t offset(position%capacity);
+        const std::size_t first(std::min(n,capacity-offset));
+        std::memcpy(ring+offset,s,first);
+        if (first<n) std::memcpy(ring,s+first,n-first);
+      }
+      //Odczytuje rozmiar rekordu z obszaru danych.
+      uint32_t size_at(uint64_t position) const {
+        char raw[sizeof(uint32_t)];
+        uint32_t size;
+        for (std::size_t k=0;k<sizeof(raw);k++) raw[k]=ring[(position+k)%capacity];
+        std::memcpy(&size,raw,sizeof(size));
+        return(size);
+      }
+      //Podaje ścieżkę pliku względem katalogu bazowego.
+      const std::string & path(const site_struct & site){
+        std::unordered_map<const char *,std::string>::iterator it(paths.find(site.file));
+        if (it==paths.end()){
+          std::string p;
+          if (site.relative) p=site.file; else append_file_path(p,site.file);
+          if (UINT16_MAX<p.size()) p.erase(0,p.size()-UINT16_MAX);
+          it=paths.emplace(site.file,p).first;
+        }
+        return(it->second);
+      }
+    public:
+      RecorderSink(const std::string & path,flags_t filter_in,std::size_t capacity_in):capacity(capacity_in){
+        struct stat st;
+        filter=filter_in;
+        length=recorder_offset+capacity;
+        if (!capacity) return;
+        fd=::open(path.c_str(),O_RDWR|O_CREAT|O_CLOEXEC,0644);
+        if (fd<0) return;
+        if (::fstat(fd,&st)||((std::size_t(st.st_size)!=length)&&(::ftruncate(fd,0)||::posix_fallocate(fd,0,length)))){
+          ::close(fd);
+          fd=-1;
+          return;
+        }
+        void * m(::mmap(nullptr,length,PROT_READ|PROT_WRITE,MAP_SHARED,fd,0));
+        if (m==MAP_FAILED){
+          ::close(fd);
+          fd=-1;
+          return;
+        }
+        header=static_cast<recorder_header_t *>(m);
+        ring=static_cast<char *>(m)+recorder_offset;
+        //Zawartość poprzedniego przebiegu jest zachowywana, jeśli plik ma ten sam format i pojemność.
+        const bool valid(
+          (std::memcmp(header->magic,recorder_magic,sizeof(recorder_magic))==0)&&
+          (header->capacity==capacity)&&
+          (header->tail.load()<=header->head.load())&&
+          ((header->head.load()-header->tail.load())<=capacity)
+        );
+        if (!valid){
+          header->capacity=capacity;
+          header->tail.store(0);
+          header->head.store(0);
+          std::memcpy(header->magic,recorder_magic,sizeof(recorder_magic));
+        }
+      }
+      ~RecorderSink(){
+        if (header) ::munmap(header,length);
+        if (0<=fd) ::close(fd);
+      }
+      bool good() const {return(header!=nullptr);}
+      bool captures() const {return(true);}
+      void write(const log_string_t & in,const std::string & /*text*/){
+        if (!in.buffered) capture(in);//Linia buforowana została zapisana w chwili jej powstania.
+      }
+      void writeBatch(const batch_vector_t & /*lines*/,const std::string & /*block*/){}//Linie buforowane zostały zapisane w chwili ich powstania.
+      void capture(const log_string_t & in){
+        if (!header) return;
+        const char * s(in.line.data());
+        std::size_t n(in.line.size());
+        if (in.fields.size()){//Pola linii strukturalnej są zapisywane w postaci tekstowej.
+          fields.assign(in.line);
+          append_fields_text(fields,in.fields);
+          s=fields.data();
+          n=fields.size();
+        }
+        recorder_record_t r{};
+        const std::string * file(in.site.file?&path(in.site):nullptr);
+        if (file){
+          r.line=in.site.line;
+          r.file_size=file->size();
+          r.function_size=std::min<std::size_t>(in.site.function_size,UINT16_MAX);
+        }
+        if (capacity<(sizeof(r)+r.file_size+r.function_size)) return;
+        if (capacity<(sizeof(r)+r.file_size+r.function_size+n)){//Zachowaj koniec zbyt długiej linii.
+          s+=(sizeof(r)+r.file_size+r.function_size+n)-capacity;
+          n=capacity-(sizeof(r)+r.file_size+r.function_size);
+        }
+        if (zone_t!=in.time.t){//Strefa czasowa jest sprawdzana raz na sekundę.
+          struct tm tm;
+          ::localtime_r(&in.time.t,&tm);
+          gmtoff=tm.tm_gmtoff;
+          zone_t=in.time.t;
+        }
+        r.size=sizeof(r)+r.file_size+r.function_size+n;
+        r.t=in.time.t;
+        r.digits=time_precision.load(std::memory_order_relaxed);
+        r.frac=in.time.fraction(r.digits);
+        r.gmtoff=gmtoff;
+        r.severity=in.severity;
+        const uint64_t head(header->head.load(std::memory_order_relaxed));
+        uint64_t tail(header->tail.load(std::memory_order_relaxed));
+        //Najpierw przesuń początek (o całe rekordy) - nadpisywane dane przestają być ważne, zanim zostaną zmienione.
+        if (capacity<(head+r.size-tail)){
+          while (capacity<(head+r.size-tail)){
+            const uint32_t size(size_at(tail));
+            if ((size<sizeof(r))||(head<(tail+size))){//Uszkodzony rekord - porzuć całą zawartość.
+              tail=head;
+              break;
+            }
+            tail+=size;
+          }
+          header->tail.store(tail,std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        put(head,reinterpret_cast<const char *>(&r),sizeof(r));
+        if (file){
+          put(head+sizeof(r),file->data(),r.file_size);
+          put(head+sizeof(r)+r.file_size,in.site.function,r.function_size);
+        }
+        put(head+sizeof(r)+r.file_size+r.function_size,s,n);
+        header->head.store(head+r.size,std::memory_order_release);
+      }
+    };
+    //! Rodzaj wyjścia używającego strumienia.
+    enum stream_kind_t {stream_text,stream_json,stream_binary};
+    //! Strumień wyjściowy (wspólny dla wyjścia tekstowego i binarnego).
+    struct Stream {
+      //! Mutex zapisu do strumienia.
+      std::mutex mutex;
+      //! Strumień wyjściowy.
+      std::ostream * const ostream;
+      //! Stan binarnego strumienia wyjściowego.
+      Binary binary;
+      //! Zasady opróżniania strumienia.
+      flush_policy_t policy;
+      //! Liczba linii zapisanych od ostatniego opróżnienia.
+      std::size_t lines=0;
+      //! Liczba bajtów zapisanych od ostatniego opróżnienia.
+      std::size_t bytes=0;
+      //! Czas pierwszego zapisu od ostatniego opróżnienia.
+      std::chrono::steady_clock::time_point pending;
+      //! Informacja, że strumienia nie ma w żadnym zestawie - zapis z wcześniejszych migawek jest pomijany (strumień może już nie istnieć).
+      std::atomic<bool> detached{false};
+      Stream(std::ostream * ostream_in):ostream(ostream_in){}
+      //!
+      //! @brief Zapisuje linie i opróżnia strumień, jeśli wymagają tego zasady (wywoływana pod muteksem strumienia).
+      //!
+      //! @param [in] text Postać tekstowa (lub binarna) linii.
+      //! @param [in] n Rozmiar.
+      //! @param [in] severities Poziomy logowania zapisanych linii.
+      //! @param [in] count Liczba zapisanych linii.
+      //!
+      void write(const char * text,std::size_t n,flags_t severities,std::size_t count){
+        if (detached.load(std::memory_order_relaxed)) return;
+        ostream->write(text,n);
+        if (!lines&&policy.interval) pending=std::chrono::steady_clock::now();
+        lines+=count;
+        bytes+=n;
+        if ((severities&policy.severity)||(policy.lines&&(policy.lines<=lines))||(policy.bytes&&(policy.bytes<=bytes))) flush();
+      }
+      //Opróżnia strumień (wywoływana pod muteksem strumienia).
+      void flush(){
+        if (detached.load(std::memory_order_relaxed)) return;
+        ostream->flush();
+        lines=0;
+        bytes=0;
+      }
+      //Opróżnia strumień, jeśli minął maksymalny czas od zapisu (wywoływana przez wątek porządkowy pod muteksem strumienia).
+      void tick(){
+        if (lines&&policy.interval&&((std::chrono::steady_clock::now()-pending)>=std::chrono::milliseconds(policy.interval))) flush();
+      }
+      //! Wątki wyjść z własną kolejką według rodzaju wyjścia (zmieniane pod muteksem zmian wyjść; usuwane przed pozostałymi polami).
+      std::shared_ptr<Worker> workers[3];
+    };
+    //! Wyjście w migawce.
+    template <typename T>
+    struct entry_t {
+      //! Filtr logów.
+      flags_t filter;
+      //! Wyjście.
+      std::shared_ptr<T> out;
+      //! Wątek wyjścia z własną kolejką (nullptr - zapis w wątku, który loguje).
+      std::shared_ptr<Worker> worker;
+    };
+    //! Zestaw wyjść odczytywany bez muteksu (po opublikowaniu nie jest zmieniany).
+    struct Snapshot {
+      //! Strumienie wyjściowe ostream.
+      std::vector<entry_t<Stream>> ostreams;
+      //! Binarne strumienie wyjściowe.
+      std::vector<entry_t<Stream>> binaries;
+      //! Strumienie wyjściowe JSON Lines.
+      std::vector<entry_t<Stream>> jsons;
+      //! Pozostałe wyjścia (np. pliki, rejestratory).
+      std::vector<std::shared_ptr<Sink>> sinks;
+      //! Wyjścia do syslog.
+      std::vector<entry_t<Syslog>> syslogs;
+      //! Suma filtrów wyjść do syslog.
+      flags_t syslog=0x0;
+    };
+    typedef std::map<std::ostream *,std::shared_ptr<Stream>> stream_map_t;
+    typedef std::map<std::string,entry_t<Syslog>> syslog_map_t;
     struct Data{
-      //! Mutex dla strumieni wejściowych.
+      //! Mutex dla zmian zestawu wyjść (zapis linii go nie zajmuje).
       std::mutex mutex;
-      //! Wartość domyślna dla poziomów logowania bez buforowania na danej warstwie.
-      ict::logger::flags_t directDefault=ict::logger::notices;
-      //! Wartość domyślna dla poziomów logowania z buforowaniem na danej warstwie.
-      ict::logger::flags_t bufferedDefault=ict::logger::nonotices;
-      //! Wartość domyślna dla poziomów logowania, które powodują opróżnienie bufora na danej warstwie.
-      ict::logger::flags_t dumpDefault=ict::logger::errors;
+      //! Zestaw strumieni wyjściowych ostream.
+      ostream_map_t ostream_map;
+      //! Zestaw binarnych strumieni wyjściowych.
+      binary_map_t binary_map;
+      //! Zestaw strumieni wyjściowych JSON Lines.
+      ostream_map_t json_map;
+      //! Strumienie używane przez wyjścia tekstowe i binarne (jeden muteks zapisu na strumień).
+      stream_map_t stream_map;
+      //! Zestaw pozostałych wyjść (np. plików, rejestratorów) według ścieżki.
+      sink_map_t sink_map;
+      //! Zestaw wyjść do syslog według identyfikatora.
+      syslog_map_t syslog_map;
+      //! Bieżąca migawka wyjść.
+      std::atomic<const Snapshot *> snapshot{new Snapshot};
+      //! Zastąpione migawki, które mogą być jeszcze czytane przez inne wątki.
+      std::vector<const Snapshot *> retired;
+      Data(){
+        //Wątek kompresji musi żyć dłużej niż pliki wyjściowe (usuwany plik przekazuje mu pliki po rotacji).
+        compressor();
+      }
+      ~Data(){
+        for (const Snapshot * s: retired) delete s;
+        delete snapshot.load();
+      }
     };
     static Data & data(){
       static Data data;
       return(data);
     }
-    void setDefault(
-      ict::logger::flags_t direct_in,
-      ict::logger::flags_t buffered_in,
-      ict::logger::flags_t dump_in
-    ){
-      TRY_BEGIN
-      std::lock_guard<std::mutex> lock(data().mutex);
-      data().directDefault=direct_in;
-      data().bufferedDefault=buffered_in;
-      data().dumpDefault=dump_in;
-      TRY_END
+    //! Wskaźnik ochronny - migawka czytana przez wątek nie jest usuwana.
+    struct Hazard {
+      //! Czytana migawka (nullptr - brak).
+      std::atomic<const Snapshot *> snapshot{nullptr};
+      //! Informacja, czy wskaźnik jest przypisany do wątku.
+      std::atomic<bool> used{true};
+      //! Następny wskaźnik na liście (lista tylko rośnie).
+      Hazard * next=nullptr;
+    };
+    //! Lista wskaźników ochronnych wszystkich wątków.
+    static std::atomic<Hazard *> hazards(nullptr);
+    //Przydziela wskaźnik ochronny (wolny z listy lub nowy).
+    static Hazard * hazard_acquire(){
+      for (Hazard * h=hazards.load(std::memory_order_acquire);h;h=h->next){
+        bool expected(false);
+        if (!h->used.load(std::memory_order_relaxed)&&h->used.compare_exchange_strong(expected,true)) return(h);
+      }
+      Hazard * h(new Hazard);
+      h->next=hazards.load(std::memory_order_relaxed);
+      while (!hazards.compare_exchange_weak(h->next,h,std::memory_order_release,std::memory_order_relaxed));
+      return(h);
     }
-    Layer::Layer(
-      ict::logger::flags_t direct_in,
-      ict::logger::flags_t buffered_in,
-      ict::logger::flags_t dump_in
-    ){
-      TRY_BEGIN
-      std::lock_guard<std::mutex> lock(data().mutex);
-      std::thread::id id(std::this_thread::get_id());//Ustal ID wątku.
-      if (ict::logger::defaultValue&direct_in) direct_in=data().directDefault;//Jeśli wartość domyślna.
-      if (ict::logger::defaultValue&buffered_in) buffered_in=data().bufferedDefault;//Jeśli wartość domyślna.
-      if (ict::logger::defaultValue&dump_in) dump_in=data().dumpDefault;//Jeśli wartość domyślna.
-      get_map_char()[id].push(direct_in,buffered_in,dump_in);//Dodaj stos logerów char dla tej warstwy.
-      TRY_END
+    static void hazard_release(Hazard * h){
+      h->snapshot.store(nullptr,std::memory_order_release);
+      h->used.store(false,std::memory_order_release);
     }
-    Layer::~Layer(){
-      TRY_BEGIN
-      std::lock_guard<std::mutex> lock(data().mutex);
-      std::thread::id id(std::this_thread::get_id());//Ustal ID wątku.
-      //Jeśli istnieje stos dla wątku.
-      if (get_map_char().count(id)){
-        //Zdejmij loggera ze stosu. Jeśli to był ostatni logger na stosie, to wykasuj stos.
-        if (!get_map_char()[id].pop()){
-          get_map_char().erase(id);
+    //! Wskaźnik ochronny wątku.
+    static thread_local Hazard * thread_hazard(nullptr);
+    //! Informacja, że wskaźnik ochronny wątku został już zwolniony (wątek się kończy).
+    static thread_local bool thread_hazard_released(false);
+    //! Zwalnia wskaźnik ochronny przy zakończeniu wątku.
+    struct HazardOwner {
+      ~HazardOwner(){
+        if (thread_hazard) hazard_release(thread_hazard);
+        thread_hazard=nullptr;
+        thread_hazard_released=true;
+      }
+    };
+    //!
+    //! @brief Dostęp do bieżącej migawki wyjść bez muteksu.
+    //!
+    //! Migawka jest chroniona wskaźnikiem ochronnym wątku, więc nie zostanie usunięta przed zniszczeniem obiektu.
+    //! Zagnieżdżony odczyt w tym samym wątku używa tej samej migawki.
+    //!
+    class SnapshotReader {
+    private:
+      Hazard * hazard;
+      const Snapshot * snapshot;
+      //! Informacja, że wskaźnik ochronny jest tymczasowy (wątek się kończy).
+      bool own=false;
+      //! Informacja, że migawka jest już chroniona przez zewnętrzny odczyt.
+      bool nested=false;
+    public:
+      SnapshotReader(){
+        if (!thread_hazard&&!thread_hazard_released){
+          static thread_local HazardOwner owner;
+          thread_hazard=hazard_acquire();
+        }
+        hazard=thread_hazard;
+        if (!hazard){
+          hazard=hazard_acquire();
+          own=true;
+        }
+        snapshot=hazard->snapshot.load(std::memory_order_relaxed);
+        if (snapshot){
+          nested=true;
+          return;
+        }
+        const std::atomic<const Snapshot *> & current(data().snapshot);
+        snapshot=current.load();
+        for (;;){//Migawka jest chroniona, jeśli po zapisaniu wskaźnika ochronnego nadal jest bieżąca.
+          hazard->snapshot.store(snapshot);
+          const Snapshot * s(current.load());
+          if (s==snapshot) break;
+          snapshot=s;
+        }
+      }
+      ~SnapshotReader(){
+        if (own) hazard_release(hazard);
+        else if (!nested) hazard->snapshot.store(nullptr,std::memory_order_release);
+      }
+      const Snapshot & operator*() const {return(*snapshot);}
+      const Snapshot * operator->() const {return(snapshot);}
+    };
+    //Usuwa zastąpione migawki, których nie czyta już żaden wątek (wywoływana pod muteksem zmian wyjść).
+    static void reclaim(){
+      std::vector<const Snapshot *> & retired(data().retired);
+      if (retired.empty()) return;
+      std::vector<const Snapshot *> used;
+      for (Hazard * h=hazards.load();h;h=h->next) used.push_back(h->snapshot.load());
+      std::size_t k(0);
+      for (const Snapshot * s: retired){
+        if (std::find(used.begin(),used.end(),s)==used.end()) delete s; else retired[k++]=s;
+      }
+      retired.resize(k);
+      //Strumienie, do których nie odwołuje się żadna migawka ani zestaw, są usuwane.
+      for (stream_map_t::iterator it=data().stream_map.begin();it!=data().stream_map.end();){
+        if ((it->second.use_count()==1)&&!data().ostream_map.count(it->first)&&!data().binary_map.count(it->first)&&!data().json_map.count(it->first)) {
+          it=data().stream_map.erase(it);
+        } else {
+          ++it;
         }
       }
-      TRY_END
     }
-    std::ostream & ostream(flags_t severity){
-      std::lock_guard<std::mutex> lock(data().mutex);
-      static BlackHole<char> blackHoleBuff;
-      static std::basic_ostream<char> blackHole(&blackHoleBuff);
-      TRY_BEGIN
-      std::thread::id id(std::this_thread::get_id());//Ustal ID wątku.
-      if (get_map_char().count(id)){//Jeśli istnieje stos dla wątku.
-        if(get_map_char()[id].size())//Jeśli są logery na stosie.
-          return(get_map_char()[id]().getLogger(severity));//Pobierz najwyższego loggera.
+    std::atomic<flags_t> sinkMask(0x0);
+    //! Suma filtrów wyjść, które otrzymują linie buforowane w chwili ich powstania.
+    static std::atomic<flags_t> captureMask(0x0);
+    //Publikuje nową migawkę wyjść i przelicza sumę filtrów (wywoływana pod muteksem zmian wyjść).
+    static void publish(){
+      Data & d(data());
+      std::unique_ptr<Snapshot> next(new Snapshot);
+      flags_t mask(0x0);
+      flags_t capture(0x0);
+      auto stream=[&d](std::ostream * o)->const std::shared_ptr<Stream> & {
+        std::shared_ptr<Stream> & s(d.stream_map[o]);
+        if (!s) s=std::make_shared<Stream>(o);
+        return(s);
+      };
+      for (const ostream_map_t::value_type & o: d.ostream_map) {
+        const std::shared_ptr<Stream> & s(stream(o.first));
+        next->ostreams.push_back({o.second,s,s->workers[stream_text]});
+        mask|=o.second;
       }
-      TRY_END
-      return(blackHole);
+      for (const binary_map_t::value_type & b: d.binary_map) {
+        const std::shared_ptr<Stream> & s(stream(b.first));
+        next->binaries.push_back({b.second,s,s->workers[stream_binary]});
+        mask|=b.second;
+      }
+      for (const ostream_map_t::value_type & j: d.json_map) {
+        const std::shared_ptr<Stream> & s(stream(j.first));
+        next->jsons.push_back({j.second,s,s->workers[stream_json]});
+        mask|=j.second;
+      }
+      for (const sink_map_t::value_type & s: d.sink_map) {
+        next->sinks.push_back(s.second);
+        mask|=s.second->filter;
+        if (s.second->captures()) capture|=s.second->filter;
+      }
+      for (const syslog_map_t::value_type & s: d.syslog_map) {
+        next->syslogs.push_back(s.second);
+        next->syslog|=s.second.filter;
+      }
+      mask|=next->syslog;
+      d.retired.push_back(d.snapshot.exchange(next.release()));
+      reclaim();
+      captureMask.store(capture);
+      sinkMask.store(mask);
+    }
+    static void start_housekeeper();
+    static void log_stats_tick();
+    static void log_dedup_expire(bool all);
+    static void log_limiter_expire(bool all);
+    static void log_stream_deliver(Stream & o,stream_kind_t kind,const shared_lines_t & l,flags_t filter);
+    static void log_syslog_deliver(Syslog & s,const shared_lines_t & l);
+    //Ustawia strumień wyjściowy w podanym zestawie (tekstowym, binarnym lub JSON Lines).
+    static void set_stream(std::ostream * ostream,flags_t filter,const flush_policy_t & policy,ostream_map_t & map){
+      std::shared_ptr<Stream> stream;
+      std::shared_ptr<Worker> old;
+      bool removed(false);
+      {
+        std::lock_guard<std::mutex> lock(data().mutex);
+        std::shared_ptr<Stream> & s(data().stream_map[ostream]);
+        if (!s) s=std::make_shared<Stream>(ostream);
+        stream=s;
+        removed=(!filter&&map.count(ostream));
+        const stream_kind_t kind((&map==&data().binary_map)?stream_binary:((&map==&data().json_map)?stream_json:stream_text));
+        std::shared_ptr<Worker> & worker(stream->workers[kind]);
+        if (filter&&policy.queue){
+          if (worker){
+            worker->configure(policy.queue,policy.overload);
+          } else {
+            static const char * const names[3]={"text:","json:","binary:"};
+            std::ostringstream name;
+            name<<names[kind]<<static_cast<const void *>(ostream);
+            Stream * p(stream.get());
+            worker=std::make_shared<Worker>(name.str(),policy.queue,policy.overload,[p,kind](const shared_lines_t & l,flags_t f){log_stream_deliver(*p,kind,l,f);});
+          }
+        } else {//Wątek jest zamykany po zwolnieniu muteksu (wstrzymany strumień nie blokuje zmian wyjść).
+          old.swap(worker);
+        }
+        if (filter){
+          std::lock_guard<std::mutex> lock(stream->mutex);
+          //Nowy strumień binarny zaczyna się od nagłówka.
+          if ((&map==&data().binary_map)&&!map.count(ostream)) stream->binary=Binary();
+          stream->policy=policy;
+          stream->detached.store(false);
+          map[ostream]=filter;
+        } else if (removed) {
+          map.erase(ostream);
+        }
+        publish();
+      }
+      //Linie z kolejki są zapisywane, a kolejne (także z bieżącej migawki) trafiają do strumienia bezpośrednio.
+      if (old) old->close();
+      if (removed){
+        {
+          std::lock_guard<std::mutex> lock(data().mutex);
+          //Po powrocie żaden wątek (także czytający starszą migawkę) nie zapisuje już do strumienia, który nie jest w żadnym zestawie.
+          if (!data().ostream_map.count(ostream)&&!data().binary_map.count(ostream)&&!data().json_map.count(ostream)) stream->detached.store(true);
+        }
+        //Czeka na wątki, które zaczęły zapis przed odłączeniem, i opróżnia strumień.
+        std::lock_guard<std::mutex> lock(stream->mutex);
+        if (stream->detached.load()) stream->ostream->flush(); else stream->flush();
+      }
+      if (filter&&policy.interval) start_housekeeper();
+    }
+    void set(std::ostream & ostream,flags_t filter,const flush_policy_t & policy){
+      TRY_BEGIN
+      set_stream(&ostream,filter,policy,data().ostream_map);
+      TRY_END
+    }
+    //Tworzy wyjście do syslog (z wątkiem, jeśli podano pojemność kolejki).
+    static entry_t<Syslog> make_syslog(const std::string & ident,flags_t filter,const syslog_options_t & options){
+      entry_t<Syslog> out{filter,std::make_shared<Syslog>(ident,filter,options),nullptr};
+      if (options.queue){
+        const std::shared_ptr<Syslog> syslog(out.out);
+        out.worker=std::make_shared<Worker>("syslog:"+ident,options.queue,options.overload,[syslog](const shared_lines_t & l,flags_t){log_syslog_deliver(*syslog,l);});
+      }
+      return(out);
+    }
+    //Zamyka kolejkę usuniętego wyjścia do syslog (linie z kolejki są wysyłane).
+    static void close_syslog(const entry_t<Syslog> & syslog){
+      if (syslog.worker) syslog.worker->close();
+    }
+    void set(const std::string & ident,flags_t filter){
+      TRY_BEGIN
+      entry_t<Syslog> syslog{0x0,nullptr,nullptr};
+      if (filter) syslog=make_syslog(ident,filter,syslog_options_t());
+      syslog_map_t old;
+      {
+        std::lock_guard<std::mutex> lock(data().mutex);
+        old.swap(data().syslog_map);
+        if (syslog.out) data().syslog_map[ident]=syslog;
+        publish();
+      }
+      //Wątki są zamykane po zwolnieniu muteksu (wstrzymane wyjście nie blokuje zmian wyjść).
+      for (const syslog_map_t::value_type & s: old) close_syslog(s.second);
+      TRY_END
+    }
+    void setSyslog(const std::string & ident,flags_t filter,const syslog_options_t & options){
+      TRY_BEGIN
+      entry_t<Syslog> syslog{0x0,nullptr,nullptr};
+      if (filter) syslog=make_syslog(ident,filter,options);
+      entry_t<Syslog> old{0x0,nullptr,nullptr};
+      {
+        std::lock_guard<std::mutex> lock(data().mutex);
+        syslog_map_t::iterator it(data().syslog_map.find(ident));
+        if (it!=data().syslog_map.end()){
+          old=it->second;
+          data().syslog_map.erase(it);
+        }
+        if (syslog.out) data().syslog_map[ident]=syslog;
+        publish();
+      }
+      //Wątek jest zamykany po zwolnieniu muteksu (wstrzymane wyjście nie blokuje zmian wyjść).
+      close_syslog(old);
+      TRY_END
+    }
+    flags_t testSyslog(const std::string & ident,syslog_stats_t * stats){
+      TRY_BEGIN
+      std::lock_guard<std::mutex> lock(data().mutex);
+      if (data().syslog_map.count(ident)){
+        Syslog & syslog(*data().syslog_map.at(ident).out);
+        if (stats) syslog.getStats(*stats);
+        return(syslog.getFilter());
+      }
+      TRY_END
+      return(0x0);
+    }
+
+    template <typename S> 
+    flags_t test(S * ostream,std::map<S *,flags_t> & map){
+      TRY_BEGIN
+      std::lock_guard<std::mutex> lock(data().mutex);
+      if (map.count(ostream)){
+        return(map.at(ostream));
+      }
+      TRY_END
+      return(0x0);
+    }
+    flags_t test(std::ostream * ostream){
+      return(test(ostream,data().ostream_map));
+    }
+    void setBinary(std::ostream & ostream,flags_t filter,const flush_policy_t & policy){
+      TRY_BEGIN
+      set_stream(&ostream,filter,policy,data().binary_map);
+      TRY_END
+    }
+    flags_t testBinary(std::ostream * ostream){
+      return(test(ostream,data().binary_map));
+    }
+    void setJson(std::ostream & ostream,flags_t filter,const flush_policy_t & policy){
+      TRY_BEGIN
+      set_stream(&ostream,filter,policy,data().json_map);
+      TRY_END
+    }
+    flags_t testJson(std::ostream * ostream){
+      return(test(ostream,data().json_map));
+    }
+    //! Okres (w milisekundach) zapisu statystyk jako linii loga (0 - wyłączony).
+    static std::atomic<unsigned> stats_interval(0);
+    //! Najdłuższy okres budzenia wątku porządkowego.
+    static const std::chrono::milliseconds housekeeping_period(100);
+    //! Wątek porządkowy wyjść (zapis buforów, opróżnianie strumieni, rotacja plików, usuwanie starych plików).
+    struct Housekeeper {
+      std::mutex mutex;
+      std::condition_variable wake;
+      std::thread thread;
+      bool stop=false;
+      //! Informacja, że zmieniły się wyjścia (okres budzenia jest wyliczany od razu).
+      bool kick=false;
+      ~Housekeeper(){
+        TRY_BEGIN
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          stop=true;
+          wake.notify_one();
+        }
+        if (thread.joinable()) thread.join();
+        TRY_END
+      }
+    };
+    static Housekeeper & housekeeper(){
+      //Dane wyjścia muszą żyć dłużej niż wątek porządkowy.
+      data();
+      static Housekeeper housekeeper;
+      return(housekeeper);
+    }
+    //Pętla wątku porządkowego.
+    static void housekeeping(){
+      Housekeeper & h(housekeeper());
+      std::vector<std::shared_ptr<Sink>> sinks;
+      std::vector<std::shared_ptr<Stream>> streams;
+      std::chrono::milliseconds period(housekeeping_period);
+      for(;;){
+        {
+          std::unique_lock<std::mutex> lock(h.mutex);
+          h.wake.wait_for(lock,period,[&h]{return(h.stop||h.kick);});
+          if (h.stop) break;
+          h.kick=false;
+        }
+        TRY_BEGIN
+        //Wątek budzi się co najkrótszy okres opróżniania wyjść (krótsze okresy niż domyślny też są przestrzegane).
+        auto shorten=[&period](unsigned interval){
+          if (interval&&(std::chrono::milliseconds(interval)<period)) period=std::chrono::milliseconds(interval);
+        };
+        period=housekeeping_period;
+        shorten(stats_interval.load());
+        {
+          std::lock_guard<std::mutex> lock(data().mutex);
+          reclaim();//Migawki, które czytał wątek w chwili ich zastąpienia.
+          sinks.clear();
+          for (sink_map_t::value_type & s: data().sink_map) {
+            sinks.push_back(s.second);
+            shorten(s.second->period());
+          }
+          for (stream_map_t::value_type & s: data().stream_map) if (s.second->policy.interval) {
+            streams.push_back(s.second);
+            shorten(s.second->policy.interval);
+          }
+        }
+        for (std::shared_ptr<Stream> & s: streams) {
+          std::lock_guard<std::mutex> lock(s->mutex);
+          s->tick();
+        }
+        streams.clear();
+        for (std::shared_ptr<Sink> & s: sinks) {
+          {
+            std::lock_guard<std::mutex> lock(s->mutex);
+            s->tick();
+          }
+          s->background();
+        }
+        sinks.clear();
+        log_stats_tick();
+        log_dedup_expire(false);
+        log_limiter_expire(false);
+        TRY_END
+      }
+    }
+    //Uruchamia wątek porządkowy (jeśli jeszcze nie działa).
+    static void start_housekeeper(){
+      Housekeeper & h(housekeeper());
+      std::lock_guard<std::mutex> lock(h.mutex);
+      if (!h.thread.joinable()) h.thread=std::thread(housekeeping);
+      h.kick=true;//Okres budzenia mógł się skrócić.
+      h.wake.notify_one();
+    }
+    //Ustawia wyjście dla podanej ścieżki (nullptr - usuwa wyjście).
+    static void set_sink(const std::string & path,std::shared_ptr<Sink> sink){
+      std::shared_ptr<Sink> old;
+      if (sink&&!sink->good()) {
+        std::cerr<<__LOGGER__<<"Logger file error ("<<path<<")!!!"<<std::endl;
+        return;
+      }
+      {
+        std::lock_guard<std::mutex> lock(data().mutex);
+        sink_map_t::iterator it(data().sink_map.find(path));
+        if (it!=data().sink_map.end()){
+          old=it->second;
+          data().sink_map.erase(it);
+        }
+        if (sink) data().sink_map[path]=sink;
+        publish();
+      }
+      if (old){//Wątki czytające poprzednią migawkę mogą jeszcze zapisać linię - reszta trafi do pliku przy jego zamknięciu.
+        if (old->worker) old->worker->close();
+        std::lock_guard<std::mutex> lock(old->mutex);
+        old->flush();
+      }
+      old.reset();
+      if (sink) start_housekeeper();
+    }
+    //Podaje filtr wyjścia danego typu dla podanej ścieżki.
+    template <typename S>
+    static flags_t test_sink(const std::string & path){
+      std::lock_guard<std::mutex> lock(data().mutex);
+      sink_map_t::const_iterator it(data().sink_map.find(path));
+      if ((it!=data().sink_map.end())&&dynamic_cast<const S *>(it->second.get())) return(it->second->filter);
+      return(0x0);
+    }
+    void setFile(const std::string & path,flags_t filter,const file_options_t & options){
+      TRY_BEGIN
+#ifndef LOGGER_ZLIB
+      if (filter&&options.compress){//Bez biblioteki zlib pliki po rotacji nie mogą być kompresowane.
+        std::cerr<<__LOGGER__<<"Logger file error ("<<path<<"): compression is not available!!!"<<std::endl;
+        return;
+      }
+#endif
+      //Plik jest otwierany poza muteksem wyjść.
+      set_sink(path,filter?std::make_shared<FileSink>(path,filter,options):nullptr);
+      TRY_END
+    }
+    flags_t testFile(const std::string & path){
+      TRY_BEGIN
+      return(test_sink<FileSink>(path));
+      TRY_END
+      return(0x0);
+    }
+    void setRecorder(const std::string & path,flags_t filter,std::size_t size){
+      TRY_BEGIN
+      set_sink(path,filter?std::make_shared<RecorderSink>(path,filter,size):nullptr);
+      TRY_END
+    }
+    flags_t testRecorder(const std::string & path){
+      TRY_BEGIN
+      return(test_sink<RecorderSink>(path));
+      TRY_END
+      return(0x0);
+    }
+    bool recover(const std::string & path,std::ostream & out,std::size_t limit){
+      TRY_BEGIN
+      std::ifstream in(path,std::ios::binary);
+      char raw[recorder_offset];
+      char magic[sizeof(recorder_magic)];
+      uint64_t capacity,tail,head;
+      if (!in.read(raw,sizeof(raw))) return(false);
+      std::memcpy(magic,raw+offsetof(recorder_header_t,magic),sizeof(magic));
+      std::memcpy(&capacity,raw+offsetof(recorder_header_t,capacity),sizeof(capacity));
+      std::memcpy(&tail,raw+offsetof(recorder_header_t,tail),sizeof(tail));
+      std::memcpy(&head,raw+offsetof(recorder_header_t,head),sizeof(head));
+      const bool text(std::memcmp(magic,recorder_magic_text,sizeof(magic))==0);
+      if (!text&&std::memcmp(magic,recorder_magic,sizeof(magic))) return(false);
+      if ((head<tail)||(capacity<(head-tail))) return(false);
+      std::string ring(capacity,'\0');
+      if (!in.read(&ring[0],capacity)) return(false);
+      //Kopiuje dane z obszaru danych (z zawinięciem).
+      auto get=[&ring,capacity](uint64_t position,char * s,std::size_t n){
+        const std::size_t offset(position%capacity);
+        const std::size_t first(std::min<std::size_t>(n,capacity-offset));
+        std::memcpy(s,ring.data()+offset,first);
+        std::memcpy(s+first,ring.data(),n-first);
+      };
+      std::string lines;
+      if (text){//Wersja 1 - obszar danych zawiera gotowy tekst.
+        uint64_t begin(tail);
+        if (limit&&(limit<(head-begin))) begin=head-limit;
+        if (begin){//Pomiń niepełną linię na początku (chyba że poprzedni bajt jest końcem linii).
+          bool boundary((tail<begin)&&(ring[(begin-1)%capacity]=='\n'));
+          while ((!boundary)&&(begin<head)) boundary=(ring[(begin++)%capacity]=='\n');
+        }
+        lines.resize(head-begin);
+        if (begin<head) get(begin,&lines[0],lines.size());
+        out<<lines;
+        return(bool(out));
+      }
+      //Wersja 2 - rekordy są zamieniane na tekst dopiero tutaj.
+      std::vector<std::size_t> ends;
+      std::string body;
+      std::ostringstream severity;
+      for (uint64_t position=tail;position<head;){
+        recorder_record_t r;
+        char time[timestamp_t::size];
+        if ((head-position)<sizeof(r)) return(false);
+        get(position,reinterpret_cast<char *>(&r),sizeof(r));
+        if ((r.size<(sizeof(r)+r.file_size+r.function_size))||((head-position)<r.size)) return(false);
+        body.resize(r.size-sizeof(r));
+        if (body.size()) get(position+sizeof(r),&body[0],body.size());
+        lines.append(time,timestamp_t::format(time,r.t,r.frac,std::min<unsigned>(r.digits,9),r.gmtoff));
+        lines+=' ';
+        severity.str("");
+        get_log_severity(r.severity,severity);
+        lines+=severity.str();
+        lines+=' ';
+        if (r.file_size){
+          lines.append(body,0,r.file_size);
+          lines+=':'+std::to_string(r.line)+" (";
+          lines.append(body,r.file_size,r.function_size);
+          lines+=") ";
+        }
+        lines.append(body,r.file_size+r.function_size,std::string::npos);
+        lines+='\n';
+        ends.push_back(lines.size());
+        position+=r.size;
+      }
+      //Pomiń najstarsze linie, jeśli tekst przekracza limit.
+      std::size_t begin(0);
+      for (std::size_t k=0;limit&&(k<ends.size())&&(limit<(lines.size()-begin));k++) begin=ends[k];
+      out.write(lines.data()+begin,lines.size()-begin);
+      return(bool(out));
+      TRY_END
+      return(false);
+    }
+    flags_t test(){
+      TRY_BEGIN
+      std::lock_guard<std::mutex> lock(data().mutex);
+      flags_t filter(0x0);
+      for (const syslog_map_t::value_type & s: data().syslog_map) filter|=s.second.filter;
+      return(filter);
+      TRY_END
+      return(0x0);
+    }
+    //Zapisuje miejsce w kodzie (jeśli nie jest częścią linii).
+    static inline void log_site_out(const site_struct & site,std::ostream & out){
+      if (site.file) out<<site;
+    }
+    //Przygotowuje postać tekstową linii.
+    template <typename charT> 
+    static std::basic_string<charT> log_render(const log_line_t<charT> & in,bool buffered){
+      std::basic_ostringstream<charT> out;
+      // Wstaw czas.
+      out<<in.time;
+      //Wstaw spację do strumienia.
+      out<<out.widen(' ');
+      //Jeśli jest to wpis buforowany, to go oznacz.
+      if (buffered) out<<out.widen('|')<<out.widen(' ');
+      //Wstaw znacznik severity do strumienia.
+      get_log_severity(in.severity,out);
+      //Wstaw spację do strumienia.
+      out<<out.widen(' ');
+      //Wstaw miejsce w kodzie.
+      log_site_out(in.site,out);
+      //Wstaw linię.
+      out<<in.line;
+      //Wstaw pola linii strukturalnej.
+      log_fields_out(in.fields,out);
+      out<<std::endl;
+      return(out.str());
+    }
+    //! Pojedyncza linia zapisywana bezpośrednio - postać tekstowa i linia dla wątków wyjść są tworzone raz (przy pierwszym użyciu).
+    class LineShare {
+    private:
+      const log_string_t & in;
+      bool rendered=false;
+      std::string rendered_text;
+      shared_lines_ptr shared;
+    public:
+      explicit LineShare(const log_string_t & in_in):in(in_in){}
+      //Podaje postać tekstową linii.
+      const std::string & text(){
+        if (!rendered){
+          rendered_text=log_render(in,in.buffered);
+          rendered=true;
+        }
+        return(rendered_text);
+      }
+      //Podaje linię dla wątków wyjść.
+      const shared_lines_ptr & get(){
+        if (!shared){
+          std::shared_ptr<shared_lines_t> l(std::make_shared<shared_lines_t>());
+          l->lines.push_back(in);
+          l->block=text();
+          l->meta.push_back({in.severity,in.time.t,0,l->block.size()});
+          l->severities=in.severity;
+          shared=l;
+        }
+        return(shared);
+      }
+    };
+    static shared_lines_ptr log_drop_summary(const std::string & name,const uint64_t (&counts)[6]){
+      static const char * const severities[6]={"critical","error","warning","notice","info","debug"};
+      std::shared_ptr<shared_lines_t> l(std::make_shared<shared_lines_t>());
+      std::ostringstream out;
+      uint64_t total(0);
+      for (std::size_t k=0;k<6;k++) total+=counts[k];
+      out<<"Kolejka wyjścia "<<name<<" przepełniona (pominięto linie: "<<total<<";";
+      for (int k=5;0<=k;k--) if (counts[k]) out<<" "<<severities[k]<<"="<<counts[k];//Od najniższego poziomu.
+      out<<")!";
+      l->lines.emplace_back();
+      log_string_t & in(l->lines.back());
+      in.severity=warning;
+      in.line=out.str();
+      l->block=log_render(in,false);
+      l->meta.push_back({in.severity,in.time.t,0,l->block.size()});
+      l->severities=in.severity;
+      return(l);
+    }
+    //Przygotowuje treść komunikatu syslog.
+    template <typename charT>
+    static inline std::basic_string<charT> log_syslog_render(const log_line_t<charT> & in){
+      std::basic_ostringstream<charT> out;
+      //Jeśli jest to wpis buforowany, to go oznacz (czas powstania tego logu trafia do nagłówka).
+      if (in.buffered) out<<out.widen('|')<<out.widen(' ');
+      //Wstaw znacznik severity do strumienia.
+      get_log_severity(in.severity,out);
+      //Wstaw spację do strumienia.
+      out<<out.widen(' ');
+      //Wstaw miejsce w kodzie.
+      log_site_out(in.site,out);
+      //Wstaw linię.
+      out<<in.line;
+      //Wstaw pola linii strukturalnej.
+      log_fields_out(in.fields,out);
+      return(out.str());
+    }
+    //Zapisuje pojedynczy log w syslog.
+    static void log_syslog_out(const Snapshot & snapshot,const log_string_t & in,LineShare & share){
+      TRY_BEGIN
+      if (!(in.severity&snapshot.syslog)) return;//Jeśli syslog jest ustawiony i poziom logu się zgadza.
+      std::string str;
+      for (const entry_t<Syslog> & s: snapshot.syslogs) if (in.severity&s.filter){
+        if (s.worker&&s.worker->push(share.get())) continue;
+        if (str.empty()) str=log_syslog_render(in);
+        OutputLock lock(s.out->mutex);
+        s.out->log(in.severity,in.time,str);
+      }
+      TRY_END
+    }
+    //Wysyła linie przekazane przez wątek wyjścia do syslog.
+    static void log_syslog_deliver(Syslog & s,const shared_lines_t & l){
+      const flags_t filter(s.getFilter());
+      if (!(l.severities&filter)) return;
+      std::vector<std::string> messages(l.lines.size());
+      for (std::size_t k=0;k<l.lines.size();k++) if (l.lines[k].severity&filter) messages[k]=log_syslog_render(l.lines[k]);
+      OutputLock lock(s.mutex);
+      for (std::size_t k=0;k<l.lines.size();k++) if (l.lines[k].severity&filter) s.push(l.lines[k].severity,l.lines[k].time,messages[k]);
+      s.send();
+    }
+
+    //Zapisuje pojedynczy log w strumieniach wyjściowych ostream.
+    static inline void log_stream_out(const Snapshot & snapshot,flags_t severity,const std::string & in,LineShare & share){
+      TRY_BEGIN
+      for (const entry_t<Stream> & o: snapshot.ostreams){//Przejdź po liście strumieni.
+        if (severity&o.filter){//Jeśli filtr przepuszcza ten wpis
+          if (o.worker&&o.worker->push(share.get(),o.filter)) continue;//Zapisze wątek strumienia.
+          OutputLock lock(o.out->mutex);
+          o.out->write(in.data(),in.size(),severity,1);//Zapisz do strumienia.
+        }
+      }
+      TRY_END
+    }
+    //Zapisuje pojedynczy log w pozostałych wyjściach (np. plikach).
+    static void log_sink_out(const Snapshot & snapshot,const log_string_t & in,const std::string & text,LineShare & share){
+      TRY_BEGIN
+      for (const std::shared_ptr<Sink> & s: snapshot.sinks) if (in.severity&s->filter){
+        if (s->worker&&s->worker->push(share.get())) continue;
+        OutputLock lock(s->mutex);
+        s->write(in,text);
+      }
+      TRY_END
+    }
+    //Zapisuje pojedynczy log w strumieniach wyjściowych.
+    static void log_stream_out(const Snapshot & snapshot,const log_string_t & in,LineShare & share){
+      TRY_BEGIN
+      if (snapshot.ostreams.empty()&&snapshot.sinks.empty()) return;
+      //Zapisz do wszystkich strumieni wyjściowych ostream.
+      const std::string & text(share.text());
+      log_stream_out(snapshot,in.severity,text,share);
+      //Zapisz do pozostałych wyjść.
+      log_sink_out(snapshot,in,text,share);
+      TRY_END
+    }
+    //Zapisuje linię buforowaną w wyjściach, które otrzymują ją w chwili jej powstania (np. rejestratorach).
+    static void log_capture_out(const log_string_t & in){
+      if (!(in.severity&captureMask.load(std::memory_order_relaxed))) return;
+      TRY_BEGIN
+      const SnapshotReader snapshot;
+      for (const std::shared_ptr<Sink> & s: snapshot->sinks) if ((in.severity&s->filter)&&s->captures()){
+        OutputLock lock(s->mutex);
+        s->capture(in);
+      }
+      TRY_END
+    }
+    template <typename charT> 
+    static void log_capture_out(const log_line_t<charT> & in){}
+    //! Nagłówek strumienia binarnego.
+    static const char binary_magic[8]={'I','C','T','L','O','G','\x01','\n'};
+    //Dopisuje liczbę w kodowaniu LEB128.
+    static inline void put_varint(std::string & out,uint64_t v){
+      for (;0x80<=v;v>>=7) out+=char((v&0x7f)|0x80);
+      out+=char(v);
+    }
+    //Koduje liczbę ze znakiem tak, by małe wartości bezwzględne zajmowały mało miejsca.
+    static inline uint64_t zigzag(int64_t v){
+      return((uint64_t(v)<<1)^uint64_t(v>>63));
+    }
+    static inline int64_t unzigzag(uint64_t v){
+      return(int64_t(v>>1)^-int64_t(v&0x1));
+    }
+    //Dopisuje ciąg znaków poprzedzony długością.
+    static inline void put_string(std::string & out,const std::string & s){
+      put_varint(out,s.size());
+      out+=s;
+    }
+    //Koduje pojedynczy log w postaci binarnej.
+    static void log_binary_encode(const log_string_t & in,Binary & b){
+      b.record.clear();
+      if (!b.header){//Nagłówek strumienia.
+        b.record.append(binary_magic,sizeof(binary_magic));
+        b.header=true;
+      }
+      const int digits(time_precision.load(std::memory_order_relaxed));
+      if (b.digits!=digits){//Rekord P - liczba cyfr ułamka sekundy.
+        b.record+='P';
+        put_varint(b.record,digits);
+        b.digits=digits;
+      }
+      if (b.zone_t!=in.time.t){//Rekord Z - strefa czasowa (sprawdzana raz na sekundę).
+        struct tm tm;
+        ::localtime_r(&in.time.t,&tm);
+        if ((b.zone_t<0)||(b.gmtoff!=tm.tm_gmtoff)){
+          b.record+='Z';
+          put_varint(b.record,zigzag(tm.tm_gmtoff));
+          b.gmtoff=tm.tm_gmtoff;
+        }
+        b.zone_t=in.time.t;
+      }
+      uint64_t id(0);
+      if (in.site.file){
+        site_id_map_t::const_iterator it(b.sites.find(in.site));
+        if (it==b.sites.end()){//Rekord S - opis miejsca w kodzie (raz dla każdego miejsca).
+          std::ostringstream path;
+          if (in.site.relative) path<<in.site.file; else path<<file(in.site.file);
+          id=b.sites.size()+1;
+          b.sites.emplace(in.site,id);
+          b.record+='S';
+          put_varint(b.record,id);
+          put_string(b.record,path.str());
+          put_varint(b.record,in.site.line);
+          put_string(b.record,std::string(in.site.function,in.site.function_size));
+        } else {
+          id=it->second;
+        }
+      }
+      //Rekord L - linia loga.
+      b.record+='L';
+      b.record+=char(in.severity|(in.buffered?0x80:0x0));
+      put_varint(b.record,zigzag(in.time.t-b.last_t));
+      b.last_t=in.time.t;
+      put_varint(b.record,in.time.fraction(digits));
+      put_varint(b.record,id);
+      if (in.fields.size()){//Pola linii strukturalnej są zapisywane w postaci tekstowej.
+        static thread_local std::string line;
+        line.assign(in.line);
+        append_fields_text(line,in.fields);
+        put_string(b.record,line);
+      } else {
+        put_string(b.record,in.line);
+      }
+    }
+    //Zapisuje pojedynczy log w binarnych strumieniach wyjściowych.
+    static void log_binary_out(const Snapshot & snapshot,const log_string_t & in,LineShare & share){
+      TRY_BEGIN
+      for (const entry_t<Stream> & b: snapshot.binaries){
+        if (in.severity&b.filter){
+          if (b.worker&&b.worker->push(share.get(),b.filter)) continue;
+          OutputLock lock(b.out->mutex);
+          log_binary_encode(in,b.out->binary);
+          b.out->write(b.out->binary.record.data(),b.out->binary.record.size(),in.severity,1);
+        }
+      }
+      TRY_END
+    }
+    //Odczytuje liczbę w kodowaniu LEB128.
+    static bool get_varint(std::istream & in,uint64_t & v){
+      v=0;
+      for (unsigned shift=0;shift<64;shift+=7){
+        const int c(in.get());
+        if (c==std::istream::traits_type::eof()) return(false);
+        v|=uint64_t(c&0x7f)<<shift;
+        if (!(c&0x80)) return(true);
+      }
+      return(false);
+    }
+    //Odczytuje ciąg znaków poprzedzony długością.
+    static bool get_string(std::istream & in,std::string & s){
+      uint64_t size;
+      if (!get_varint(in,size)) return(false);
+      if ((1<<24)<size) return(false);
+      s.resize(size);
+      return(!size||in.read(&s[0],size));
+    }
+    bool decode(std::istream & in,std::ostream & out){
+      TRY_BEGIN
+      char magic[sizeof(binary_magic)];
+      std::vector<std::string> sites;
+      std::string text;
+      uint64_t digits(0),gmtoff(0),t(0),v;
+      if (!in.read(magic,sizeof(magic))) return(false);
+      if (std::memcmp(magic,binary_magic,sizeof(magic))) return(false);
+      for (;;){
+        switch (in.get()){
+          case std::istream::traits_type::eof():return(true);
+          case 'P':
+            if (!get_varint(in,digits)||(9<digits)) return(false);
+            break;
+          case 'Z':
+            if (!get_varint(in,gmtoff)) return(false);
+            break;
+          case 'S':{
+            std::string path,function;
+            uint64_t id,line;
+            if (!get_varint(in,id)||(id!=(sites.size()+1))) return(false);
+            if (!get_string(in,path)||!get_varint(in,line)||!get_string(in,function)) return(false);
+            sites.push_back(path+":"+std::to_string(line)+" ("+function+") ");
+          } break;
+          case 'L':{
+            char time[timestamp_t::size];
+            const int flags(in.get());
+            uint64_t frac,id;
+            if (flags==std::istream::traits_type::eof()) return(false);
+            if (!get_varint(in,v)||!get_varint(in,frac)||!get_varint(in,id)) return(false);
+            if (!get_string(in,text)||(sites.size()<id)) return(false);
+            t+=unzigzag(v);
+            out.write(time,timestamp_t::format(time,t,frac,digits,unzigzag(gmtoff)));
+            out<<' ';
+            if (flags&0x80) out<<"| ";
+            get_log_severity(flags&0x7f,out);
+            out<<' ';
+            if (id) out<<sites[id-1];
+            out<<text<<'\n';
+          } break;
+          default:return(false);
+        }
+      }
+      TRY_END
+      return(false);
+    }
+    //Zapisuje pojedynczy log w strumieniach wyjściowych JSON Lines.
+    static void log_json_out(const Snapshot & snapshot,const log_string_t & in,LineShare & share){
+      TRY_BEGIN
+      static thread_local std::string json;
+      bool encoded(false);
+      for (const entry_t<Stream> & j: snapshot.jsons){
+        if (in.severity&j.filter){
+          if (j.worker&&j.worker->push(share.get(),j.filter)) continue;
+          if (!encoded){//Linia jest kodowana raz (poza muteksami strumieni).
+            json.clear();
+            log_json_encode(json,in);
+            encoded=true;
+          }
+          OutputLock lock(j.out->mutex);
+          j.out->write(json.data(),json.size(),in.severity,1);
+        }
+      }
+      TRY_END
+    }
+    //Zapisuje linie przekazane przez wątek strumienia.
+    static void log_stream_deliver(Stream & o,stream_kind_t kind,const shared_lines_t & l,flags_t filter){
+      const flags_t severities(l.severities&filter);
+      if (!severities) return;
+      static thread_local std::string record;
+      std::size_t count(0);
+      record.clear();
+      if (kind==stream_text){//Tekst jest już gotowy - wybierane są tylko linie przepuszczane przez filtr.
+        for (const batch_line_t & m: l.meta) if (m.severity&filter){
+          count++;
+          if (severities!=l.severities) record.append(l.block,m.offset,m.size);
+        }
+        const std::string & out((severities==l.severities)?l.block:record);
+        OutputLock lock(o.mutex);
+        o.write(out.data(),out.size(),severities,count);
+        return;
+      }
+      if (kind==stream_json) for (const log_string_t & in: l.lines) if (in.severity&filter){
+        log_json_encode(record,in);
+        count++;
+      }
+      OutputLock lock(o.mutex);
+      if (kind==stream_binary) for (const log_string_t & in: l.lines) if (in.severity&filter){//Stan kodowania należy do strumienia.
+        log_binary_encode(in,o.binary);
+        record+=o.binary.record;
+        count++;
+      }
+      o.write(record.data(),record.size(),severities,count);
+    }
+    //Zapisuje pojedynczy log we wszystkich wyjściach (bezpośrednio lub przez kolejki wyjść z własnym wątkiem).
+    static void log_direct_out(const log_string_t & in){
+      const SnapshotReader snapshot;//Zestaw wyjść bez zajmowania muteksu.
+      LineShare share(in);
+      log_stream_out(*snapshot,in,share);//Zapisz w strumieniach wyjściowych.
+      log_binary_out(*snapshot,in,share);//Zapisz w binarnych strumieniach wyjściowych.
+      log_json_out(*snapshot,in,share);//Zapisz w strumieniach wyjściowych JSON Lines.
+      log_syslog_out(*snapshot,in,share);//Zapisz w syslog.
+    }
+    template <typename charT> 
+    static void log_direct_out(const log_line_t<charT> & in){}
+    //! Pierścień linii loga dla jednego wątku (jeden producent, jeden konsument).
+    class Ring {
+    private:
+      //! Miejsca na linie loga.
+      std::vector<log_string_t> slots;
+      //! Licznik linii włożonych (zmienia tylko producent).
+      alignas(64) std::atomic<std::size_t> head{0};
+      //! Licznik linii zapisanych (zmienia tylko konsument).
+      alignas(64) std::atomic<std::size_t> tail{0};
+    public:
+      //! Informacja, że producent właśnie wkłada linię.
+      alignas(64) std::atomic<bool> busy{false};
+      //! Informacja, że wątek producenta zakończył działanie.
+      std::atomic<bool> closed{false};
+      //!
+      //! @brief Konstruktor.
+      //!
+      //! @param [in] capacity Pojemność pierścienia (w liniach).
+      //!
+      Ring(std::size_t capacity):slots(capacity?capacity:1){}
+      //!
+      //! @brief Wkłada linię do pierścienia (tylko producent).
+      //!
+      //! @param [in] line Linia loga.
+      //! @return Wartość true, jeśli linia została włożona.
+      //!
+      bool push(const log_string_t & line){
+        const std::size_t h(head.load(std::memory_order_relaxed));
+        if ((h-tail.load(std::memory_order_acquire))>=slots.size()) return(false);
+        //Przypisanie (a nie przeniesienie) zachowuje zaalokowaną pamięć w obu miejscach.
+        slots[h%slots.size()]=line;
+        head.store(h+1,std::memory_order_release);
+        return(true);
+      }
+      //!
+      //! @brief Podaje najstarszą linię w pierścieniu (tylko konsument).
+      //!
+      //! @return Wskaźnik na linię lub nullptr, jeśli pierścień jest pusty.
+      //!
+      const log_string_t * front(){
+        const std::size_t t(tail.load(std::memory_order_relaxed));
+        if (t==head.load(std::memory_order_acquire)) return(nullptr);
+        return(&slots[t%slots.size()]);
+      }
+      //!
+      //! @brief Zwalnia najstarszą linię w pierścieniu (tylko konsument).
+      //!
+      void pop(){
+        tail.store(tail.load(std::memory_order_relaxed)+1,std::memory_order_release);
+      }
+      //! Liczba linii włożonych do pierścienia.
+      std::size_t pushed() const {return(head.load(std::memory_order_acquire));}
+      //! Liczba linii zapisanych z pierścienia.
+      std::size_t written() const {return(tail.load(std::memory_order_acquire));}
+      //! Informacja, czy pierścień jest pusty.
+      bool empty() const {return(pushed()==written());}
+    };
+    typedef std::vector<std::shared_ptr<Ring>> ring_vector_t;
+    struct Async {
+      //! Mutex dla zmian trybu asynchronicznego (włącz/wyłącz).
+      std::mutex control;
+      //! Mutex dla listy pierścieni i zmiennych warunkowych.
+      std::mutex mutex;
+      //! Budzenie wątku zapisującego.
+      std::condition_variable wake;
+      //! Informacja o zakończeniu przejścia po pierścieniach (czekają na nią także producenci z pełnym pierścieniem).
+      std::condition_variable drained;
+      //! Pierścienie wszystkich wątków.
+      ring_vector_t rings;
+      //! Wątek zapisujący.
+      std::thread thread;
+      //! Informacja, czy tryb asynchroniczny jest włączony.
+      std::atomic<bool> enabled{false};
+      //! Informacja, że wątek zapisujący czeka na nowe linie.
+      std::atomic<bool> sleeping{false};
+      //! Żądanie przejścia po pierścieniach.
+      bool kick=false;
+      //! Żądanie zakończenia wątku zapisującego.
+      bool stop=false;
+      //! Pojemność nowych pierścieni.
+      std::size_t capacity=4096;
+      ~Async();
+    };
+    static Async & async(){
+      //Dane wyjścia muszą żyć dłużej niż wątek zapisujący.
+      data();
+      static Async async;
+      return(async);
+    }
+    //! Pierścień bieżącego wątku.
+    static thread_local Ring * thread_ring=nullptr;
+    //! Informacja, że bieżący wątek kończy działanie.
+    static thread_local bool thread_exiting=false;
+    //Czeka, aż wątek zapisujący zapisze linie włożone do pierścieni (wszystkich lub wskazanego).
+    static void async_drain(Async & a,Ring * only=nullptr){
+      std::vector<std::pair<std::shared_ptr<Ring>,std::size_t>> marks;
+      std::unique_lock<std::mutex> lock(a.mutex);
+      if (!a.thread.joinable()) return;
+      if (std::this_thread::get_id()==a.thread.get_id()) return;
+      for (std::shared_ptr<Ring> & r: a.rings) 
+        if ((!only)||(r.get()==only)) marks.emplace_back(r,r->pushed());
+      a.kick=true;
+      a.wake.notify_one();
+      a.drained.wait(lock,[&marks]{
+        for (const std::pair<std::shared_ptr<Ring>,std::size_t> & m: marks) 
+          if (m.first->written()<m.second) return(false);
+        return(true);
+      });
+    }
+    //! Zamyka pierścień bieżącego wątku przy jego zakończeniu.
+    struct RingCloser {
+      ~RingCloser(){
+        TRY_BEGIN
+        thread_exiting=true;
+        if (thread_ring){
+          Ring * r(thread_ring);
+          thread_ring=nullptr;
+          async_drain(async(),r);//Zachowaj kolejność linii, które ten wątek może jeszcze zalogować synchronicznie.
+          r->closed.store(true);
+        }
+        TRY_END
+      }
+    };
+    static void kick_writer(Async & a){
+      std::lock_guard<std::mutex> lock(a.mutex);
+      a.kick=true;
+      a.wake.notify_one();
+    }
+    static Ring * get_thread_ring(Async & a){
+      static thread_local RingCloser closer;
+      if (thread_exiting) return(nullptr);
+      if (!thread_ring){
+        std::lock_guard<std::mutex> lock(a.mutex);
+        a.rings.emplace_back(new Ring(a.capacity));
+        thread_ring=a.rings.back().get();
+      }
+      return(thread_ring);
+    }
+    //Próbuje przekazać pojedynczy log do wątku zapisującego.
+    static bool log_async_out(const log_string_t & in){
+      Async & a(async());
+      if (!a.enabled.load(std::memory_order_relaxed)) return(false);
+      Ring * r(get_thread_ring(a));
+      if (!r) return(false);
+      r->busy.store(true);
+      if (!a.enabled.load()) {//Tryb został właśnie wyłączony.
+        r->busy.store(false);
+        return(false);
+      }
+      if (!r->push(in)){//Pierścień jest pełny - czekaj, aż wątek zapisujący zakończy przejście po pierścieniach.
+        stats_count(stat_ring_full);
+        std::unique_lock<std::mutex> lock(a.mutex);
+        a.kick=true;
+        a.wake.notify_one();
+        a.drained.wait(lock,[r,&in]{return(r->push(in));});
+      }
+      r->busy.store(false);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (a.sleeping.load()) kick_writer(a);
+      return(true);
+    }
+    template <typename charT> 
+    static bool log_async_out(const log_line_t<charT> & in){
+      return(false);
+    }
+    //Pętla wątku zapisującego.
+    static void async_writer(){
+      Async & a(async());
+      ring_vector_t rings;
+      for(;;){
+        bool stop;
+        {
+          std::lock_guard<std::mutex> lock(a.mutex);
+          stop=a.stop;
+          a.kick=false;
+          a.rings.erase(std::remove_if(a.rings.begin(),a.rings.end(),[](const std::shared_ptr<Ring> & r){
+            return(r->closed.load()&&r->empty());
+          }),a.rings.end());
+          rings=a.rings;
+        }
+        std::size_t n(0);
+        for (std::shared_ptr<Ring> & r: rings) {
+          while (const log_string_t * l=r->front()){
+            log_direct_out(*l);//Zapisz w wyjściach.
+            r->pop();
+            n++;
+          }
+        }
+        {
+          std::lock_guard<std::mutex> lock(a.mutex);
+          a.drained.notify_all();
+        }
+        if (n) continue;
+        if (stop) break;
+        a.sleeping.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        bool empty(true);
+        for (std::shared_ptr<Ring> & r: rings) if (!r->empty()) empty=false;
+        if (empty){
+          std::unique_lock<std::mutex> lock(a.mutex);
+          a.wake.wait_for(lock,std::chrono::milliseconds(100),[&a]{return(a.kick||a.stop);});
+        }
+        a.sleeping.store(false);
+      }
+    }
+    //Wyłącza tryb asynchroniczny i zapisuje wszystkie oczekujące linie.
+    static void async_disable(Async & a){
+      if (!a.thread.joinable()) return;
+      a.enabled.store(false);
+      ring_vector_t rings;
+      {
+        std::lock_guard<std::mutex> lock(a.mutex);
+        rings=a.rings;
+      }
+      //Poczekaj, aż producenci skończą wkładać linie.
+      for (std::shared_ptr<Ring> & r: rings) while (r->busy.load()) std::this_thread::yield();
+      {
+        std::lock_guard<std::mutex> lock(a.mutex);
+        a.stop=true;
+        a.wake.notify_one();
+      }
+      a.thread.join();
+    }
+    Async::~Async(){
+      TRY_BEGIN
+      std::lock_guard<std::mutex> lock(control);
+      async_disable(*this);
+      TRY_END
+    }
+    void setAsync(bool enable,std::size_t capacity){
+      TRY_BEGIN
+      Async & a(async());
+      std::lock_guard<std::mutex> control(a.control);
+      if (enable){
+        {
+          std::lock_guard<std::mutex> lock(a.mutex);
+          a.capacity=capacity;
+          a.stop=false;
+        }
+        if (!a.thread.joinable()) a.thread=std::thread(async_writer);
+        a.enabled.store(true);
+      } else {
+        async_disable(a);
+      }
+      TRY_END
+    }
+    bool testAsync(){
+      return(async().enabled.load());
+    }
+    void flush(){
+      TRY_BEGIN
+      log_dedup_expire(true);
+      log_limiter_expire(true);
+      async_drain(async());
+      const SnapshotReader snapshot;
+      //Linie z kolejek wyjść z własnym wątkiem.
+      for (const std::vector<entry_t<Stream>> * streams: {&snapshot->ostreams,&snapshot->binaries,&snapshot->jsons}) for (const entry_t<Stream> & o: *streams){
+        if (o.worker) o.worker->drain();
+      }
+      for (const std::shared_ptr<Sink> & s: snapshot->sinks) if (s->worker) s->worker->drain();
+      for (const entry_t<Syslog> & s: snapshot->syslogs) if (s.worker) s.worker->drain();
+      for (const std::shared_ptr<Sink> & s: snapshot->sinks){
+        OutputLock lock(s->mutex);
+        s->flush();
+      }
+      for (const std::vector<entry_t<Stream>> * streams: {&snapshot->ostreams,&snapshot->binaries,&snapshot->jsons}) for (const entry_t<Stream> & o: *streams){
+        OutputLock lock(o.out->mutex);
+        o.out->flush();
+      }
+      TRY_END
+    }
+    std::vector<queue_stats_t> queueStats(){
+      std::vector<queue_stats_t> out;
+      TRY_BEGIN
+      const SnapshotReader snapshot;
+      for (const std::vector<entry_t<Stream>> * streams: {&snapshot->ostreams,&snapshot->binaries,&snapshot->jsons}) for (const entry_t<Stream> & o: *streams){
+        if (o.worker) out.push_back(o.worker->getStats());
+      }
+      for (const std::shared_ptr<Sink> & s: snapshot->sinks) if (s->worker) out.push_back(s->worker->getStats());
+      for (const entry_t<Syslog> & s: snapshot->syslogs) if (s.worker) out.push_back(s.worker->getStats());
+      TRY_END
+      return(out);
+    }
+    //Zapisuje histogram w formacie tekstowym Prometheus.
+    static void write_histogram(std::ostream & out,const char * name,const char * help,const histogram_t & h){
+      out<<"# HELP "<<name<<" "<<help<<"\n";
+      out<<"# TYPE "<<name<<" histogram\n";
+      uint64_t count(0);
+      for (std::size_t k=0;k<histogram_t::size;k++){
+        count+=h.buckets[k];
+        out<<name<<"_bucket{le=\"";
+        if (k<(histogram_t::size-1)) out<<(histogram_t::bounds[k]*1e-9); else out<<"+Inf";
+        out<<"\"} "<<count<<"\n";
+      }
+      out<<name<<"_sum "<<(h.sum*1e-9)<<"\n";
+      out<<name<<"_count "<<h.count<<"\n";
+    }
+    //Zapisuje licznik w formacie tekstowym Prometheus.
+    static void write_counter(std::ostream & out,const char * name,const char * help,uint64_t value){
+      out<<"# HELP "<<name<<" "<<help<<"\n";
+      out<<"# TYPE "<<name<<" counter\n";
+      out<<name<<" "<<value<<"\n";
+    }
+    //Zapisuje etykietę output w formacie tekstowym Prometheus.
+    static void write_output_label(std::ostream & out,const std::string & output){
+      out<<"output=\"";
+      for (char c: output){
+        if ((c=='\\')||(c=='"')) out<<'\\'<<c; else if (c=='\n') out<<"\\n"; else out<<c;
+      }
+      out<<"\"";
+    }
+    //Zapisuje miarę kolejek wyjść (z etykietą output) w formacie tekstowym Prometheus.
+    template <typename F>
+    static void write_queues(std::ostream & out,const char * name,const char * type,const char * help,const std::vector<queue_stats_t> & queues,F value){
+      out<<"# HELP "<<name<<" "<<help<<"\n";
+      out<<"# TYPE "<<name<<" "<<type<<"\n";
+      for (const queue_stats_t & q: queues){
+        out<<name<<"{";
+        write_output_label(out,q.output);
+        out<<"} "<<value(q)<<"\n";
+      }
+    }
+    void writeStats(std::ostream & out){
+      TRY_BEGIN
+      static const char * const severities[6]={"critical","error","warning","notice","info","debug"};
+      const stats_t st(stats());
+      out<<"# HELP ict_logger_lines_total Log lines by severity.\n";
+      out<<"# TYPE ict_logger_lines_total counter\n";
+      for (std::size_t k=0;k<6;k++) out<<"ict_logger_lines_total{severity=\""<<severities[k]<<"\"} "<<st.lines[k]<<"\n";
+      write_counter(out,"ict_logger_buffered_lines_total","Lines stored in layer buffers.",st.buffered);
+      write_counter(out,"ict_logger_dumped_lines_total","Buffered lines written by layer dumps.",st.dumped);
+      write_counter(out,"ict_logger_discarded_lines_total","Buffered lines discarded when a layer closed without a dump.",st.discarded);
+      write_counter(out,"ict_logger_overwritten_lines_total","Buffered lines overwritten after a layer exceeded its budget.",st.overwritten);
+      write_counter(out,"ict_logger_dumps_total","Layer buffer dumps.",st.dumps);
+      write_counter(out,"ict_logger_ring_full_total","Lines that waited for space in a full asynchronous ring.",st.ring_full);
+      write_counter(out,"ict_logger_repeated_lines_total","Repeated lines suppressed by deduplication.",st.repeated);
+      write_counter(out,"ict_logger_queue_dropped_lines_total","Lines dropped by output queue overload policies.",st.queue_dropped);
+      write_counter(out,"ict_logger_compressed_files_total","Rotated files compressed.",st.compressed);
+      write_counter(out,"ict_logger_compress_in_bytes_total","Bytes of rotated files before compression.",st.compress_in);
+      write_counter(out,"ict_logger_compress_out_bytes_total","Bytes of rotated files after compression.",st.compress_out);
+      out<<"# HELP ict_logger_compress_cpu_seconds_total CPU time spent compressing rotated files.\n";
+      out<<"# TYPE ict_logger_compress_cpu_seconds_total counter\n";
+      out<<"ict_logger_compress_cpu_seconds_total "<<(st.compress_cpu/1e9)<<"\n";
+      write_histogram(out,"ict_logger_lock_wait_seconds","Time spent waiting for an output mutex.",st.lock_wait);
+      write_histogram(out,"ict_logger_write_seconds","Time spent writing to an output under its mutex.",st.write);
+      const std::vector<queue_stats_t> queues(queueStats());
+      if (queues.size()){//Wyjścia z własnym wątkiem.
+        write_queues(out,"ict_logger_queue_depth","gauge","Lines waiting in an output queue (including lines being written).",queues,[](const queue_stats_t & q){return(q.depth);});
+        write_queues(out,"ict_logger_queue_capacity","gauge","Capacity of an output queue in lines.",queues,[](const queue_stats_t & q){return(q.capacity);});
+        write_queues(out,"ict_logger_queue_lag_seconds","gauge","Time the oldest line has been waiting in an output queue.",queues,[](const queue_stats_t & q){return(q.lag*1e-9);});
+        write_queues(out,"ict_logger_queue_lines_total","counter","Lines written by an output worker thread.",queues,[](const queue_stats_t & q){return(q.lines);});
+        write_queues(out,"ict_logger_queue_full_total","counter","Lines that found an output queue full (waited or dropped).",queues,[](const queue_stats_t & q){return(q.full);});
+        out<<"# HELP ict_logger_queue_dropped_total Lines dropped by the overload policy of a full output queue.\n";
+        out<<"# TYPE ict_logger_queue_dropped_total counter\n";
+        for (const queue_stats_t & q: queues) for (std::size_t k=0;k<6;k++){
+          out<<"ict_logger_queue_dropped_total{";
+          write_output_label(out,q.output);
+          out<<",severity=\""<<severities[k]<<"\"} "<<q.dropped[k]<<"\n";
+        }
+      }
+      TRY_END
+    }
+    //! Poziom logowania linii ze statystykami.
+    static std::atomic<flags_t> stats_severity(info);
+    void setStats(unsigned interval,flags_t severity){
+      TRY_BEGIN
+      stats_severity.store(severity);
+      stats_interval.store(interval);
+      if (interval) start_housekeeper();
+      TRY_END
+    }
+    void setTiming(bool enable){
+      stats_timing.store(enable);
+    }
+    //Przekazuje pojedynczy log do wyjść (bezpośrednio lub przez wątek zapisujący).
+    template <typename charT> 
+    static void log_forward(const log_line_t<charT> & in){
+      if (!log_async_out(in)){
+        log_direct_out(in);//Zapisz w wyjściach.
+      }
+    }
+    //! Miejsce w tablicy powtórzeń.
+    struct alignas(64) DedupSlot {
+      std::mutex mutex;
+      //! Skrót linii (0 - miejsce puste).
+      std::size_t hash=0;
+      //! Ostatnia zapisana linia (czas nie jest porównywany).
+      log_string_t line;
+      //! Czas zapisu linii (początek okna).
+      std::chrono::steady_clock::time_point first;
+      //! Liczba pominiętych powtórzeń linii.
+      uint64_t repeats=0;
+    };
+    //! Liczba miejsc w tablicy powtórzeń.
+    static const std::size_t dedup_size=128;
+    static DedupSlot * dedup_table(){
+      static DedupSlot table[dedup_size];
+      return(table);
+    }
+    //! Okno (w milisekundach), w którym powtórzenia linii są pomijane (0 - wyłączone).
+    static std::atomic<unsigned> dedup_window(0);
+    //! Poziomy logowania, dla których powtórzenia są pomijane.
+    static std::atomic<flags_t> dedup_filter(all);
+    //Przygotowuje linię z liczbą pominiętych powtórzeń.
+    static log_string_t log_dedup_summary(const log_string_t & line,uint64_t repeats){
+      log_string_t out;
+      out.severity=line.severity;
+      out.site=line.site;
+      out.line="Powtórzenia linii (pominięto linie: "+std::to_string(repeats)+"): "+line.line;
+      out.fields=line.fields;
+      return(out);
+    }
+    //Sprawdza, czy linia powtarza linię zapisaną w bieżącym oknie (wtedy jest pomijana).
+    static bool log_dedup(const log_string_t & in){
+      const unsigned window(dedup_window.load(std::memory_order_relaxed));
+      if (!window||in.buffered||!(in.severity&dedup_filter.load(std::memory_order_relaxed))) return(false);
+      std::size_t hash(std::hash<std::string>()(in.line)^(site_hash()(in.site)*31)^(in.fields.size()<<8)^in.severity);
+      if (!hash) hash=1;
+      DedupSlot & slot(dedup_table()[hash%dedup_size]);
+      const std::chrono::steady_clock::time_point now(std::chrono::steady_clock::now());
+      log_string_t summary;
+      {
+        std::lock_guard<std::mutex> lock(slot.mutex);
+        if ((slot.hash==hash)&&(slot.line.severity==in.severity)&&site_equal()(slot.line.site,in.site)&&(slot.line.line==in.line)&&fields_equal(slot.line.fields,in.fields)){
+          if (now<(slot.first+std::chrono::milliseconds(window))){//Powtórzenie w oknie.
+            slot.repeats++;
+            stats_count(stat_repeated);
+            return(true);
+          }
+        }
+        if (slot.repeats) summary=log_dedup_summary(slot.line,slot.repeats);
+        slot.hash=hash;
+        slot.line.severity=in.severity;
+        slot.line.site=in.site;
+        slot.line.line.assign(in.line);
+        slot.line.fields=in.fields;
+        slot.first=now;
+        slot.repeats=0;
+      }
+      if (summary.line.size()) log_forward(summary);//Powtórzenia poprzedniej linii w tym miejscu.
+      return(false);
+    }
+    template <typename charT> 
+    static bool log_dedup(const log_line_t<charT> & in){
+      return(false);
+    }
+    //Zapisuje liczby pominiętych powtórzeń (wszystkie lub tylko te, których okno minęło).
+    static void log_dedup_expire(bool all){
+      const unsigned window(dedup_window.load(std::memory_order_relaxed));
+      const std::chrono::steady_clock::time_point now(std::chrono::steady_clock::now());
+      if (!window&&!all) return;
+      for (std::size_t k=0;k<dedup_size;k++){
+        DedupSlot & slot(dedup_table()[k]);
+        log_string_t summary;
+        {
+          std::lock_guard<std::mutex> lock(slot.mutex);
+          if (!slot.repeats) continue;
+          if (!all&&(now<(slot.first+std::chrono::milliseconds(window)))) continue;
+          summary=log_dedup_summary(slot.line,slot.repeats);
+          slot.repeats=0;
+        }
+        log_forward(summary);
+      }
+    }
+    //! Ograniczenie liczby linii, które pominęło linie (LOGGER_*_RATE).
+    struct limiter_entry_t {
+      input::limiter_t * limiter;
+      flags_t severity;
+      site_struct site;
+    };
+    //! Zarejestrowane ograniczenia liczby linii (są statyczne, więc nie są usuwane).
+    struct Limiters {
+      std::mutex mutex;
+      std::vector<limiter_entry_t> list;
+    };
+    static Limiters & limiters(){
+      static Limiters l;
+      return(l);
+    }
+    //Rejestruje ograniczenie, które pominęło linie.
+    static void log_limiter_register(input::limiter_t & limiter,flags_t severity,const site_struct & site){
+      {
+        Limiters & l(limiters());
+        std::lock_guard<std::mutex> lock(l.mutex);
+        if (limiter.registered.load()) return;
+        l.list.push_back({&limiter,severity,site});
+        limiter.registered.store(true);
+      }
+      start_housekeeper();
+    }
+    //Zapisuje liczby linii pominiętych przez ograniczenia (wszystkie lub tylko te, których okno minęło).
+    static void log_limiter_expire(bool all){
+      const uint64_t now(input::limiterWindow());
+      std::vector<log_string_t> summaries;
+      {
+        Limiters & l(limiters());
+        std::lock_guard<std::mutex> lock(l.mutex);
+        for (const limiter_entry_t & e: l.list){
+          if (!e.limiter->suppressed.load(std::memory_order_relaxed)) continue;
+          if (!all&&((e.limiter->window.load(std::memory_order_relaxed)>>32)==now)) continue;
+          const uint64_t n(e.limiter->suppressed.exchange(0,std::memory_order_relaxed));
+          if (!n) continue;//Zgłosiło je kolejne wywołanie.
+          summaries.emplace_back();
+          summaries.back().severity=e.severity;
+          summaries.back().site=e.site;
+          summaries.back().line="Ograniczenie liczby linii (pominięto linie: "+std::to_string(n)+")!";
+        }
+      }
+      for (const log_string_t & summary: summaries) log_forward(summary);
+    }
+    void setDedup(unsigned window,flags_t filter){
+      TRY_BEGIN
+      dedup_window.store(0);
+      log_dedup_expire(true);//Powtórzenia sprzed zmiany.
+      dedup_filter.store(filter);
+      dedup_window.store(window);
+      if (window) start_housekeeper();
+      TRY_END
+    }
+    //Zapisuje pojedynczy log we wszystkich wyjściach (z pominięciem powtórzeń).
+    template <typename charT> 
+    static void log_out(const log_line_t<charT> & in){
+      if (log_dedup(in)) return;
+      log_forward(in);
+    }
+    //Zapisuje statystyki jako linię loga, jeśli upłynął okres (wywoływana przez wątek porządkowy).
+    static void log_stats_tick(){
+      static std::chrono::steady_clock::time_point last(std::chrono::steady_clock::now());
+      const unsigned interval(stats_interval.load());
+      if (!interval) return;
+      const std::chrono::steady_clock::time_point now(std::chrono::steady_clock::now());
+      if (now<(last+std::chrono::milliseconds(interval))) return;
+      last=now;
+      const stats_t st(stats());
+      std::ostringstream out;
+      out<<"logger stats: lines=";
+      for (std::size_t k=0;k<6;k++) out<<(k?"/":"")<<st.lines[k];
+      out<<" buffered="<<st.buffered<<" dumped="<<st.dumped<<" discarded="<<st.discarded;
+      out<<" overwritten="<<st.overwritten<<" dumps="<<st.dumps<<" ring_full="<<st.ring_full<<" repeated="<<st.repeated;
+      if (st.queue_dropped) out<<" queue_dropped="<<st.queue_dropped;
+      if (st.compressed) out<<" compressed="<<st.compressed<<" compress_ratio="<<(st.compress_out?double(st.compress_in)/st.compress_out:0.0);
+      out<<" lock_wait_ns="<<(st.lock_wait.count?st.lock_wait.sum/st.lock_wait.count:0);
+      out<<" write_ns="<<(st.write.count?st.write.sum/st.write.count:0);
+      log_string_t line;
+      line.severity=stats_severity.load();
+      line.line=out.str();
+      log_out(line);//Jak każda inna linia (tryb asynchroniczny, usuwanie powtórzeń).
+    }
+    //Zapisuje zrzut bufora warstwy linia po linii (inne typy znaków niż char).
+    template <typename charT,typename F,typename std::enable_if<!std::is_same<charT,char>::value,int>::type=0>
+    static void log_dump_out(F lines){
+      lines([](const log_line_t<charT> & l){log_out(l);});
+    }
+    //!
+    //! @brief Zapisuje zrzut bufora warstwy w całości.
+    //!
+    //! Linie są formatowane do jednego bloku przed zajęciem muteksów wyjść. Następnie muteks każdego wyjścia jest zajmowany raz,
+    //! a każde wyjście otrzymuje jeden zapis, więc linie zrzutu nie przeplatają się z liniami innych wątków.
+    //! W trybie asynchronicznym linie trafiają do pierścienia wątku (zachowując kolejność z innymi jego liniami).
+    //!
+    //! @param [in] lines Funkcja, która przekazuje wszystkie linie zrzutu (od najstarszej) do podanej funkcji (może być wywołana wielokrotnie).
+    //!
+    template <typename charT,typename F,typename std::enable_if<std::is_same<charT,char>::value,int>::type=0>
+    static void log_dump_out(F lines){
+      if (async().enabled.load(std::memory_order_relaxed)){
+        lines([](const log_line_t<charT> & l){log_out(l);});
+        return;
+      }
+      TRY_BEGIN
+      //Bufory są używane ponownie przez kolejne zrzuty w tym wątku.
+      static thread_local std::string block;
+      static thread_local batch_vector_t meta;
+      static thread_local std::map<flags_t,std::string> filtered;
+      flags_t severities(0x0);
+      block.clear();
+      meta.clear();
+      lines([&severities](const log_line_t<charT> & l){
+        const std::string text(log_render(l,true));
+        meta.push_back({l.severity,l.time.t,block.size(),text.size()});
+        block+=text;
+        severities|=l.severity;
+      });
+      if (meta.empty()) return;
+      //Blok zawierający tylko linie przepuszczane przez podany filtr.
+      auto select=[&severities](flags_t filter)->const std::string & {
+        if ((filter&severities)==severities) return(block);
+        std::string & out(filtered[filter]);
+        out.clear();
+        for (const batch_line_t & m: meta) if (m.severity&filter) out.append(block,m.offset,m.size);
+        return(out);
+      };
+      //Linie dla wątków wyjść (kopiowane raz, przy pierwszym wyjściu z kolejką).
+      shared_lines_ptr shared;
+      auto share=[&shared,&severities,&lines]()->const shared_lines_ptr & {
+        if (!shared){
+          std::shared_ptr<shared_lines_t> l(std::make_shared<shared_lines_t>());
+          lines([&l](const log_line_t<charT> & in){l->lines.push_back(in);});
+          l->block=block;
+          l->meta=meta;
+          l->severities=severities;
+          l->dump=true;
+          shared=l;
+        }
+        return(shared);
+      };
+      const SnapshotReader snapshot;
+      for (const entry_t<Stream> & o: snapshot->ostreams){//Strumienie wyjściowe - jeden zapis.
+        if (!(o.filter&severities)) continue;
+        if (o.worker&&o.worker->push(share(),o.filter)) continue;
+        const std::string & out(select(o.filter));
+        std::size_t count(0);
+        for (const batch_line_t & m: meta) if (m.severity&o.filter) count++;
+        OutputLock lock(o.out->mutex);
+        o.out->write(out.data(),out.size(),o.filter&severities,count);
+      }
+      for (const std::shared_ptr<Sink> & s: snapshot->sinks) if ((s->filter&severities)&&!s->structured()){//Pozostałe wyjścia.
+        if (s->worker&&s->worker->push(share())) continue;
+        OutputLock lock(s->mutex);
+        s->writeBatch(meta,block);
+      }
+      //Binarne strumienie wyjściowe, wyjścia JSON Lines i syslog potrzebują linii w pierwotnej postaci.
+      for (const std::shared_ptr<Sink> & s: snapshot->sinks) if ((s->filter&severities)&&s->structured()){
+        if (s->worker&&s->worker->push(share())) continue;
+        static const std::string empty;
+        OutputLock lock(s->mutex);
+        lines([&s](const log_line_t<charT> & l){
+          if (l.severity&s->filter) s->write(l,empty);
+        });
+      }
+      for (const entry_t<Stream> & j: snapshot->jsons) if (j.filter&severities){//Strumienie JSON Lines - jeden zapis.
+        if (j.worker&&j.worker->push(share(),j.filter)) continue;
+        std::string & record(filtered[0x0]);
+        std::size_t count(0);
+        record.clear();
+        lines([&record,&count,&j](const log_line_t<charT> & l){
+          if (!(l.severity&j.filter)) return;
+          log_json_encode(record,l);
+          count++;
+        });
+        OutputLock lock(j.out->mutex);
+        j.out->write(record.data(),record.size(),j.filter&severities,count);
+      }
+      for (const entry_t<Stream> & b: snapshot->binaries) if (b.filter&severities){//Binarne strumienie wyjściowe - jeden zapis.
+        if (b.worker&&b.worker->push(share(),b.filter)) continue;
+        std::string & record(filtered[0x0]);
+        std::size_t count(0);
+        OutputLock lock(b.out->mutex);
+        record.clear();
+        lines([&record,&count,&b](const log_line_t<charT> & l){
+          if (!(l.severity&b.filter)) return;
+          log_binary_encode(l,b.out->binary);
+          record+=b.out->binary.record;
+          count++;
+        });
+        b.out->write(record.data(),record.size(),b.filter&severities,count);
+      }
+      if (snapshot->syslog&severities){//Syslog - wszystkie linie warstwy jednym wywołaniem sendmmsg.
+        static thread_local std::vector<std::pair<timestamp_t,std::string>> messages;
+        std::size_t k(0);
+        bool rendered(false);
+        for (const entry_t<Syslog> & s: snapshot->syslogs) if (s.filter&severities){
+          if (s.worker&&s.worker->push(share())) continue;
+          if (!rendered){
+            lines([&k](const log_line_t<charT> & l){
+              if (messages.size()<=k) messages.emplace_back();
+              messages[k].first=l.time;
+              messages[k++].second=log_syslog_render(l);
+            });
+            rendered=true;
+          }
+          OutputLock lock(s.out->mutex);
+          for (std::size_t i=0;i<k;i++) s.out->push(meta[i].severity,messages[i].first,messages[i].second);
+          s.out->send();
+        }
+      }
+      TRY_END
+    }
+  }
+  //==========================================================================
+  //! Domyślny budżet (w bajtach) linii buforowanych jednej warstwy.
+  static std::atomic<std::size_t> layer_budget(64*1024);
+  //! Limit pamięci linii buforowanych wszystkich wątków (0 - bez limitu).
+  static std::atomic<std::size_t> arena_limit(0);
+  //! Pamięć linii buforowanych zajęta przez wszystkie wątki.
+  static std::atomic<std::size_t> arena_total(0);
+  //Przydziela pamięć w ramach limitu (zwraca przydzieloną liczbę bajtów, nie więcej niż n).
+  static std::size_t arena_grant(std::size_t n){
+    const std::size_t limit(arena_limit.load(std::memory_order_relaxed));
+    std::size_t total(arena_total.load(std::memory_order_relaxed));
+    for (;;){
+      const std::size_t granted(limit?((total<limit)?std::min(n,limit-total):0):n);
+      if (arena_total.compare_exchange_weak(total,total+granted)) return(granted);
+    }
+  }
+  //! Informacja, czy linie LOGGER_*_F w warstwach buforowanych są odraczane.
+  static std::atomic<bool> deferred_lines(true);
+  //Dopisuje tekst linii odroczonej (taki sam, jak przy formatowaniu od razu).
+  static void render_deferred(std::string & out,const char * fmt,const char * record,std::size_t n);
+  template <typename charT>
+  static void render_deferred(std::basic_string<charT> & out,const char * fmt,const charT * record,std::size_t n){}
+  //! Wpis linii buforowanej w obszarze pamięci (za nim znajdują się znaki linii lub wartości argumentów linii odroczonej).
+  struct arena_entry_t {
+    //! Rozmiar całego wpisu (wyrównany).
+    uint32_t size;
+    //! Długość linii (w znakach).
+    uint32_t length;
+    //! Poziom logowania.
+    flags_t severity;
+    //! Czas powstania linii (sekundy).
+    std::time_t t;
+    //! Czas powstania linii (nanosekundy).
+    long ns;
+    //! Miejsce w kodzie.
+    site_struct site;
+    //! Ciąg formatujący linii odroczonej (nullptr - wpis zawiera tekst).
+    const char * format;
+  };
+  //! Wyrównanie wpisów w obszarze pamięci.
+  static const std::size_t arena_align=alignof(arena_entry_t);
+  //! Obszar pamięci linii buforowanych (jeden na wątek, wspólny dla wszystkich warstw - warstwy zajmują go jak stos).
+  class Arena {
+  private:
+    //! Pamięć.
+    std::unique_ptr<char[]> memory;
+    //! Rozmiar pamięci.
+    std::size_t capacity=0;
+    //! Początek wolnej pamięci.
+    std::size_t top=0;
+  public:
+    ~Arena(){
+      arena_total.fetch_sub(capacity);
+    }
+    //!
+    //! @brief Rezerwuje pamięć na szczycie obszaru (obszar rośnie tylko, jeśli brakuje miejsca).
+    //!
+    //! @param [in] n Rozmiar pamięci.
+    //! @param [out] offset Położenie zarezerwowanej pamięci.
+    //! @return Rozmiar zarezerwowanej pamięci (mniejszy od n, jeśli osiągnięto limit).
+    //!
+    std::size_t reserve(std::size_t n,std::size_t & offset){
+      n-=n%arena_align;
+      if (capacity<(top+n)){
+        const std::size_t granted(arena_grant(top+n-capacity));
+        if (granted){
+          std::unique_ptr<char[]> m(new char[capacity+granted]);
+          if (top) std::memcpy(m.get(),memory.get(),top);
+          memory.swap(m);
+          capacity+=granted;
+        }
+        n=capacity-top;
+        n-=n%arena_align;
+      }
+      offset=top;
+      top+=n;
+      return(n);
+    }
+    //!
+    //! @brief Zwalnia pamięć od podanego położenia do szczytu (pamięć pozostaje do ponownego użycia).
+    //!
+    //! Po zamknięciu ostatniej warstwy pamięć ponad domyślny budżet warstwy wraca do limitu wszystkich wątków.
+    //!
+    void release(std::size_t offset){
+      top=offset;
+      const std::size_t keep(layer_budget.load(std::memory_order_relaxed));
+      if ((!top)&&(keep<capacity)){
+        memory.reset(keep?new char[keep]:nullptr);
+        arena_total.fetch_sub(capacity-keep);
+        capacity=keep;
+      }
+    }
+    //! Podaje wskaźnik na pamięć w podanym położeniu.
+    char * at(std::size_t offset){
+      return(memory.get()+offset);
+    }
+  };
+  //! Linie buforowane jednej warstwy - bufor cykliczny w obszarze pamięci wątku (najstarsze linie są nadpisywane).
+  template <typename charT>
+  class Region {
+  private:
+    //! Obszar pamięci wątku.
+    Arena * arena=nullptr;
+    //! Budżet warstwy (w bajtach).
+    std::size_t budget=0;
+    //! Informacja, czy pamięć została zarezerwowana (przy pierwszej linii).
+    bool reserved=false;
+    //! Położenie pamięci w obszarze.
+    std::size_t base=0;
+    //! Rozmiar pamięci.
+    std::size_t size=0;
+    //! Położenie najstarszego wpisu.
+    std::size_t begin=0;
+    //! Położenie za najnowszym wpisem.
+    std::size_t end=0;
+    //! Koniec starszej części wpisów (jeśli wpisy zostały zawinięte na początek pamięci).
+    std::size_t stop=0;
+    //! Informacja, czy wpisy zostały zawinięte na początek pamięci.
+    bool wrapped=false;
+    //! Liczba wpisów.
+    std::size_t count=0;
+    //! Liczba nadpisanych (utraconych) wpisów.
+    std::size_t dropped=0;
+    //! Liczba linii pominiętych, bo nie zmieściły się w budżecie.
+    std::size_t rejected=0;
+    arena_entry_t entry(std::size_t offset){
+      arena_entry_t e;
+      std::memcpy(&e,arena->at(base+offset),sizeof(e));
+      return(e);
+    }
+    //Usuwa najstarszy wpis.
+    void drop(){
+      begin+=entry(begin).size;
+      count--;
+      dropped++;
+      if (wrapped&&(begin==stop)){
+        wrapped=false;
+        begin=0;
+      }
+    }
+  public:
+    //!
+    //! @brief Przygotowuje bufor dla nowej warstwy.
+    //!
+    //! @param [in] arena_in Obszar pamięci wątku.
+    //! @param [in] budget_in Budżet warstwy (w bajtach).
+    //!
+    void reset(Arena * arena_in,std::size_t budget_in){
+      arena=arena_in;
+      budget=budget_in;
+      reserved=false;
+      size=0;
+      clear();
+      dropped=0;
+      rejected=0;
+    }
+    //!
+    //! @brief Zwalnia pamięć warstwy w obszarze pamięci wątku.
+    //!
+    void release(){
+      if (reserved) arena->release(base);
+      reserved=false;
+      size=0;
+    }
+    //!
+    //! @brief Usuwa wszystkie wpisy.
+    //!
+    void clear(){
+      begin=end=stop=count=0;
+      wrapped=false;
+    }
+    //! Liczba wpisów.
+    std::size_t getCount() const {return(count);}
+    //! Liczba nadpisanych (utraconych) wpisów.
+    std::size_t getDropped() const {return(dropped);}
+    //! Liczba linii pominiętych, bo nie zmieściły się w budżecie.
+    std::size_t getRejected() const {return(rejected);}
+    //!
+    //! @brief Dodaje linię (jeśli brakuje miejsca, to nadpisuje najstarsze).
+    //!
+    //! @param [in] line Linia loga.
+    //!
+    void push(const log_line_t<charT> & line){
+      if (!reserved){
+        size=arena->reserve(budget,base);
+        reserved=true;
+      }
+      arena_entry_t e;
+      std::size_t length(line.line.size());
+      if (line.format&&(size<(sizeof(e)+length*sizeof(charT)))){//Wartości argumentów nie mieszczą się w budżecie - zapisz tekst (jego początek).
+        log_line_t<charT> text;
+        text.severity=line.severity;
+        text.time=line.time;
+        text.site=line.site;
+        render_deferred(text.line,line.format,line.line.data(),line.line.size());
+        push(text);
+        return;
+      }
+      if (size<(sizeof(e)+length*sizeof(charT))){//Linia dłuższa niż budżet - zachowaj jej początek.
+        if (size<sizeof(e)) {//Budżet (lub limit pamięci) nie mieści nawet nagłówka wpisu.
+          rejected++;
+          return;
+        }
+        length=(size-sizeof(e))/sizeof(charT);
+      }
+      e.size=sizeof(e)+length*sizeof(charT);
+      e.size+=(arena_align-e.size%arena_align)%arena_align;
+      e.length=length;
+      e.severity=line.severity;
+      e.t=line.time.t;
+      e.ns=line.time.ns;
+      e.site=line.site;
+      e.format=line.format;
+      if (!count) clear();
+      for (;;){
+        if (!wrapped){
+          if ((end+e.size)<=size) break;
+          stop=end;//Zawiń na początek pamięci.
+          end=0;
+          wrapped=true;
+        }
+        if ((end+e.size)<=begin) break;
+        drop();
+        if (!count) clear();
+      }
+      char * p(arena->at(base+end));
+      std::memcpy(p,&e,sizeof(e));
+      std::memcpy(p+sizeof(e),line.line.data(),length*sizeof(charT));
+      end+=e.size;
+      count++;
+    }
+    //!
+    //! @brief Przekazuje wszystkie wpisy (od najstarszego) jako linie loga.
+    //!
+    //! @param [in] line Linia loga używana do przekazania wpisów (pole line jest nadpisywane).
+    //! @param [in] f Funkcja wywoływana dla każdego wpisu.
+    //!
+    template <typename F>
+    void forEach(log_line_t<charT> & line,F f){
+      std::size_t offset(begin);
+      for (std::size_t k=0;k<count;k++){
+        if (wrapped&&(offset==stop)) offset=0;
+        const arena_entry_t e(entry(offset));
+        line.severity=e.severity;
+        line.time.t=e.t;
+        line.time.ns=e.ns;
+        line.site=e.site;
+        if (e.format){//Linia odroczona - tekst powstaje dopiero teraz.
+          line.line.clear();
+          render_deferred(line.line,e.format,reinterpret_cast<const charT *>(arena->at(base+offset+sizeof(e))),e.length);
+        } else {
+          line.line.assign(reinterpret_cast<const charT *>(arena->at(base+offset+sizeof(e))),e.length);
+        }
+        f(line);
+        offset+=e.size;
+      }
+    }
+  };
+  //==========================================================================
+  //! Klasa obsługująca pusty bufor.
+  template <
+    typename charT=char,
+    typename traits=std::char_traits<charT>
+  > 
+  class BlackHole:public std::basic_streambuf<charT,traits> {
+  public:
+    typedef typename traits::int_type int_type_t;
+  public:
+    //!
+    //! @brief Konstruktor.
+    //! 
+    BlackHole(){}
+    //!
+    //! @brief Destruktor.
+    //! 
+    ~BlackHole(){}
+    //!
+    //! @brief Przetwarza jeden znak.
+    //! 
+    //! @param [in] c Przetwarzany znak.
+    //! @return Przetworzony znak.
+    //!
+    int_type_t overflow (int_type_t c){
+      //Zakończ.
+      return(c);
+    }
+  };
+  //==========================================================================
+  //!
+  //! @brief Filtruje znaki sterujące (\\0, \\t i \\v są zamieniane na spację, a \\n i \\r oznaczają koniec linii).
+  //!
+  //! @param [in] c Znak sterujący.
+  //! @return Znak po zamianie. Zero oznacza koniec linii.
+  //!
+  template <typename charT>
+  static inline charT control_filter(charT c){
+    switch (c){
+      case charT('\n'):case charT('\r'):return(charT(0));
+      default:return(charT(' '));
+    }
+  }
+  //!
+  //! @brief Sprawdza, czy znak wymaga zamiany (\\0, \\t, \\n, \\v, \\r).
+  //!
+  template <typename charT>
+  static inline bool control_char(charT c){
+    const typename std::make_unsigned<charT>::type u(c);
+    //Bity 0, 9, 10, 11 i 13.
+    return((u<=13)&&((0x2e01>>u)&0x1));
+  }
+  //!
+  //! @brief Szuka pierwszego znaku, który wymaga zamiany.
+  //!
+  //! @param [in] s Wskaźnik na ciąg znaków.
+  //! @param [in] n Liczba znaków.
+  //! @return Pozycja znaku lub n, jeśli nie znaleziono.
+  //!
+  template <typename charT>
+  static inline std::size_t control_find(const charT * s,std::size_t n){
+    for (std::size_t i=0;i<n;i++) if (control_char(s[i])) return(i);
+    return(n);
+  }
+  static inline std::size_t control_find(const char * s,std::size_t n){
+    std::size_t i(0);
+    //Wszystkie znaki sterujące mają kod nie większy niż 13 - kandydaci są szukani wektorowo, a sprawdzani pojedynczo.
+#if defined(__AVX2__)
+    const __m256i limit32(_mm256_set1_epi8(13));
+    for (;(i+32)<=n;i+=32){
+      const __m256i v(_mm256_loadu_si256((const __m256i *)(s+i)));
+      uint32_t mask(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_min_epu8(v,limit32),v)));
+      for (;mask;mask&=mask-1) if (control_char(s[i+__builtin_ctz(mask)])) return(i+__builtin_ctz(mask));
+    }
+#endif
+#if defined(__SSE2__)
+    const __m128i limit16(_mm_set1_epi8(13));
+    for (;(i+16)<=n;i+=16){
+      const __m128i v(_mm_loadu_si128((const __m128i *)(s+i)));
+      uint32_t mask(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(v,limit16),v)));
+      for (;mask;mask&=mask-1) if (control_char(s[i+__builtin_ctz(mask)])) return(i+__builtin_ctz(mask));
+    }
+#endif
+    for (;i<n;i++) if (control_char(s[i])) return(i);
+    return(n);
+  }
+  //Podaje wartość argumentu linii odroczonej i przesuwa wskaźnik za nią.
+  template <typename T>
+  static inline T capture_get(const char * & p){
+    T v;
+    std::memcpy(&v,p,sizeof(v));
+    p+=sizeof(v);
+    return(v);
+  }
+  static void render_deferred(std::string & out,const char * fmt,const char * record,std::size_t n){
+    const std::size_t from(out.size());
+    const char * const end(record+n);
+    while (record<end){
+      fmt=input::formatText(out,fmt);
+      switch (*record++){
+        case input::capture_int:input::formatArg(out,capture_get<int64_t>(record));break;
+        case input::capture_uint:input::formatArg(out,capture_get<uint64_t>(record));break;
+        case input::capture_float:input::formatArg(out,capture_get<float>(record));break;
+        case input::capture_double:input::formatArg(out,capture_get<double>(record));break;
+        case input::capture_long_double:input::formatArg(out,capture_get<long double>(record));break;
+        case input::capture_bool:input::formatArg(out,capture_get<bool>(record));break;
+        case input::capture_char:input::formatArg(out,capture_get<char>(record));break;
+        case input::capture_string:{
+          const uint32_t length(capture_get<uint32_t>(record));
+          out.append(record,length);
+          record+=length;
+        } break;
+        default:record=end;break;
+      }
+    }
+    input::formatOut(out,fmt);
+    //Znaki sterujące (razem ze znakami nowej linii) są zamieniane na spacje.
+    char * s(&out[0]+from);
+    std::size_t k(out.size()-from);
+    for (std::size_t i=control_find(s,k);i<k;s+=i+1,k-=i+1,i=control_find(s,k)) s[i]=' ';
+  }
+  //==========================================================================
+  //! Klasa obsługująca bufor logowania na wybranym poziomie.
+  template <
+    typename charT=char,
+    typename traits=std::char_traits<charT>
+  > 
+  class Buffer:public std::basic_streambuf<charT,traits> {
+  public:
+    typedef std::basic_string<charT> basic_string_t;
+    typedef std::basic_ostream<charT,traits> basic_ostream_t;
+    typedef typename traits::int_type int_type_t;
+  private:
+    //! Pojedyncza linia loga.
+    log_line_t<charT> log_line;
+    //! Bufor linii loga.
+    Region<charT> * log_buffer;
+    //! Informacja o tym, że ostatnio została złamana linia (rozpoczyna się nowy wpis loga).
+    bool newline=true;
+    //! Rozmiar obszaru zapisu.
+    static const std::size_t area_size=256;
+    //! Obszar zapisu - znaki są tu zbierane i przetwarzane razem.
+    charT area[area_size];
+  public:
+    //!
+    //! @brief Konstruktor.
+    //! 
+    //! @param [in] severity_in Poziom logowania.
+    //! @param [in] buffered_in Informacja, czy poziom jest buforowany.
+    //! @param [in] log_buffer_in Bufor linii loga.
+    //!
+    Buffer(ict::logger::flags_t severity_in,bool buffered_in,Region<charT> * log_buffer_in):log_buffer(log_buffer_in){
+      TRY_BEGIN
+      log_line.buffered=buffered_in;
+      log_line.severity=severity_in;
+      this->setp(area,area+area_size);
+      TRY_END
+    }
+    //!
+    //! @brief Destruktor.
+    //! 
+    ~Buffer(){
+      sync();
+    }
+    //!
+    //! @brief Przygotowuje bufor do ponownego użycia (niezakończony wpis jest porzucany).
+    //! 
+    //! @param [in] buffered_in Informacja, czy poziom jest buforowany.
+    //!
+    void reset(bool buffered_in){
+      this->setp(area,area+area_size);
+      newline=true;
+      log_line.buffered=buffered_in;
+    }
+  private:
+    //!
+    //! @brief Rozpoczyna nowy wpis loga, jeśli poprzedni został zakończony.
+    //! 
+    void beginLine(){
+      if (newline) {
+        //Jeśli rozpoczyna się nowy wpis, to pobierz aktualny czas.
+        log_line.time.setTime();
+        //Oznacz, że linia się rozpoczyna.
+        newline=false;
+        //Wyczyść linię.
+        log_line.line.clear();
+        log_line.fields.clear();
+        log_line.format=nullptr;
+        log_line.site.file=nullptr;
+      }
+    }
+    //!
+    //! @brief Kończy wpis loga i przekazuje go dalej (do bufora lub do wyjść).
+    //! 
+    void endLine(){
+      //Jeśli znaki nowej linii.
+      if (newline) {
+        //Ignoruj powtarzające się jeden po drugim.
+        return;
+      }
+      //Oznacz nową linię.
+      newline=true;
+      stats_line(log_line.severity);
+      if (log_line.buffered){//Jeśli zapis jest buforowany.
+        if (log_line.fields.size()){//Bufor przechowuje tylko tekst - pola linii strukturalnej są do niego dopisywane.
+          append_fields_text(log_line.line,log_line.fields);
+          log_line.fields.clear();
+        }
+        if (!log_line.format) output::log_capture_out(log_line);//Zapisz w rejestratorach.
+        if (log_buffer) {//Dodaj do bufora (najstarsze linie mogą zostać nadpisane).
+          log_buffer->push(log_line);
+          stats_count(stat_buffered);
+        }
+      } else {//Jeśli zapis nie jest buforowany.
+        output::log_out(log_line);//Zapisz w wyjściach.
+      }
+    }
+    //!
+    //! @brief Przetwarza ciąg znaków.
+    //! 
+    //! @param [in] s Wskaźnik na ciąg znaków.
+    //! @param [in] n Liczba znaków.
+    //!
+    void putChars(const charT * s,std::size_t n){
+      while (n){
+        //Znajdź pierwszy znak, który wymaga zamiany.
+        const std::size_t i(control_find(s,n));
+        if (i){//Ciąg zwykłych znaków - skopiuj go w całości.
+          beginLine();
+          log_line.line.append(s,i);
+        }
+        if (i==n) break;
+        if (control_filter(s[i])){//Zamiana na spację.
+          beginLine();
+          log_line.line+=control_filter(s[i]);
+        } else {//Pojawił się znak nowej linii
+          endLine();
+        }
+        s+=i+1;
+        n-=i+1;
+      }
+    }
+  public:
+    //!
+    //! @brief Zapamiętuje miejsce w kodzie dla bieżącego wpisu loga.
+    //! 
+    //! @param [in] site Miejsce w kodzie.
+    //! @return Wartość true, jeśli miejsce zostało zapamiętane (wpis był pusty).
+    //!
+    bool setSite(const site_struct & site){
+      sync();
+      if (!newline) return(false);
+      beginLine();
+      log_line.site=site;
+      return(true);
+    }
+    //!
+    //! @brief Zapisuje linię strukturalną (niezakończony wpis jest najpierw kończony).
+    //!
+    //! @param [in] site Miejsce w kodzie.
+    //! @param [in] msg Treść linii.
+    //! @param [in,out] fields Pola linii (zamieniane z polami bufora na czas zapisu, więc pamięć jest używana ponownie).
+    //!
+    void putFields(const site_struct & site,const char * msg,std::vector<field_t> & fields){
+      sync();
+      endLine();
+      beginLine();
+      log_line.site=site;
+      for (;*msg;msg++){//Znaki sterujące (razem ze znakami nowej linii) są zamieniane na spacje.
+        const charT c(*msg);
+        log_line.line+=control_char(c)?charT(' '):c;
+      }
+      log_line.fields.swap(fields);
+      endLine();
+      log_line.fields.swap(fields);
+    }
+    //!
+    //! @brief Rozpoczyna linię z ciągiem formatującym (niezakończony wpis jest najpierw kończony).
+    //!
+    //! @param [in] site Miejsce w kodzie.
+    //! @param [in] fmt Ciąg formatujący.
+    //! @param [out] deferred Informacja, że linia jest odroczona (treścią są wartości argumentów).
+    //! @return Tekst linii, do którego jest dopisywana treść.
+    //!
+    std::basic_string<charT,traits> & beginFormat(const site_struct & site,const char * fmt,bool & deferred){
+      sync();
+      endLine();
+      beginLine();
+      log_line.site=site;
+      //Linia buforowana jest odraczana, jeśli nie odbierają jej rejestratory (zapisują ją w chwili powstania).
+      deferred=log_line.buffered&&deferred_lines.load(std::memory_order_relaxed)&&
+        !(log_line.severity&output::captureMask.load(std::memory_order_relaxed));
+      if (deferred) log_line.format=fmt;
+      return(log_line.line);
+    }
+    //!
+    //! @brief Kończy linię rozpoczętą przez beginFormat().
+    //!
+    void endFormat(){
+      if (!log_line.format){//Znaki sterujące (razem ze znakami nowej linii) są zamieniane na spacje.
+        charT * s(&log_line.line[0]);
+        std::size_t n(log_line.line.size());
+        for (std::size_t i=control_find(s,n);i<n;s+=i+1,n-=i+1,i=control_find(s,n)) s[i]=charT(' ');
+      }
+      endLine();
+    }
+  protected:
+    //!
+    //! @brief Przetwarza znaki zebrane w obszarze zapisu.
+    //! 
+    //! @return Zero.
+    //!
+    int sync(){
+      TRY_BEGIN
+      if (this->pbase()!=this->pptr()) putChars(this->pbase(),this->pptr()-this->pbase());
+      TRY_END
+      this->setp(area,area+area_size);
+      return(0);
+    }
+    //!
+    //! @brief Przetwarza ciąg znaków (z pominięciem obszaru zapisu).
+    //! 
+    //! @param [in] s Wskaźnik na ciąg znaków.
+    //! @param [in] n Liczba znaków.
+    //! @return Liczba przetworzonych znaków.
+    //!
+    std::streamsize xsputn(const charT * s,std::streamsize n){
+      sync();
+      TRY_BEGIN
+      if (0<n) putChars(s,n);
+      TRY_END
+      return(n);
+    }
+    //!
+    //! @brief Przetwarza obszar zapisu i jeden znak.
+    //! 
+    //! @param [in] c Przetwarzany znak.
+    //! @return Przetworzony znak.
+    //!
+    int_type_t overflow (int_type_t c){
+      sync();
+      if (!traits::eq_int_type(c,traits::eof())){
+        TRY_BEGIN
+        const charT znak(traits::to_char_type(c));
+        putChars(&znak,1);
+        TRY_END
+      }
+      //Zakończ.
+      return(traits::not_eof(c));
+    }
+  };
+  //==========================================================================
+  //! Strumień, który został ostatnio podany przez loggera w bieżącym wątku.
+  static thread_local std::ostream * site_stream=nullptr;
+  //! Bufor strumienia, który został ostatnio podany przez loggera w bieżącym wątku.
+  static thread_local Buffer<char> * site_buffer=nullptr;
+  static inline void set_site_target(std::ostream * stream,Buffer<char> * buffer){
+    site_stream=stream;
+    site_buffer=buffer;
+  }
+  template <typename charT,typename traits>
+  static inline void set_site_target(std::basic_ostream<charT,traits> * stream,Buffer<charT,traits> * buffer){}
+  std::ostream & operator<<(std::ostream & os,const site_struct & s){
+    //Jeśli to strumień loggera, to miejsce w kodzie jest zapamiętywane przy linii.
+    if ((&os==site_stream)&&(site_buffer->setSite(s))) return(os);
+    if (s.relative) os<<s.file; else os<<file(s.file);
+    os<<":"<<s.line<<" (";
+    os.write(s.function,s.function_size);
+    os<<") ";
+    return(os);
+  }
+  //==========================================================================
+  //! Klasa obsługująca logowanie na wszystkich poziomach (pojedynczy logger).
+  template <
+    typename charT=char,
+    typename traits=std::char_traits<charT>
+  > 
+  class Single
+  {
+  public:
+    typedef logger::Buffer<charT,traits> logger_buffer_t;
+    typedef std::basic_ostream<charT,traits> basic_ostream_t;
+  private:
+    //! Loger dla pojedynczego poziomu logowania.
+    class StreamPack{
+    public:
+      logger_buffer_t buffer;
+      basic_ostream_t stream;
+      StreamPack(ict::logger::flags_t severity,bool buffered,Region<charT> * log_buffer):
+        buffer(severity,buffered,log_buffer),stream(&buffer)
+      {
+        //Obszar zapisu jest przetwarzany po każdej operacji na strumieniu.
+        stream.setf(std::ios_base::unitbuf);
+      }
+      ~StreamPack(){
+        if (site_stream==&stream) set_site_target(nullptr,nullptr);
+      }
+      //! Przygotowuje loger do ponownego użycia (formatowanie i stan strumienia jak po utworzeniu).
+      void reset(bool buffered){
+        //Strumień wzorcowy - wypełnienie jest ustalane od razu, więc późniejszy odczyt go nie zmienia.
+        struct Pristine:basic_ostream_t {
+          Pristine():basic_ostream_t(nullptr){
+            this->fill(this->widen(' '));
+            this->setf(std::ios_base::unitbuf);
+          }
+        };
+        static const Pristine pristine;
+        buffer.reset(buffered);
+        stream.clear();
+        //Kopiowanie formatowania jest kosztowne - tylko, jeśli zostało zmienione.
+        if (
+          (stream.flags()!=pristine.flags())||
+          (stream.precision()!=pristine.precision())||
+          (stream.width()!=pristine.width())||
+          (stream.fill()!=pristine.fill())||
+          (stream.getloc()!=pristine.getloc())
+        ) stream.copyfmt(pristine);
+      }
+    };
+    //! Logery dla różnych poziomów (indeks to numer bitu poziomu, tworzone przy pierwszym użyciu i używane ponownie).
+    std::unique_ptr<StreamPack> logger_map[6];
+    //! Poziomy, których logery zostały przygotowane od ostatniego reset() (pozostałe są przygotowywane przy pierwszym użyciu).
+    ict::logger::flags_t ready;
+    //! Poziomy logowania bez buforowania na tej warstwie.
+    ict::logger::flags_t direct;
+    //! Poziomy logowania, które powodują opróżnienie bufora na tej warstwie.
+    ict::logger::flags_t dump;
+    //! Poziomy logowania, które są aktywne na tej warstwie.
+    ict::logger::flags_t active;
+    //! Poziomy logowania, które zostały wykonane na tej warstwie.
+    ict::logger::flags_t done;
+    //! Bufor linii loga.
+    Region<charT> log_buffer;
+  public:
+    //!
+    //! @brief Konstruktor.
+    //! 
+    //! @param [in] direct_in Poziomy logowania bez buforowania na tej warstwie.
+    //! @param [in] buffered_in Poziomy logowania z buforowaniem na tej warstwie.
+    //! @param [in] dump_in Poziomy logowania, które powodują opróżnienie bufora na tej warstwie.
+    //! @param [in] arena Obszar pamięci linii buforowanych wątku.
+    //! @param [in] budget Budżet linii buforowanych tej warstwy (w bajtach).
+    //!
+    Single(
+      ict::logger::flags_t direct_in,
+      ict::logger::flags_t buffered_in,
+      ict::logger::flags_t dump_in,
+      Arena * arena,
+      std::size_t budget
+    ){
+      reset(direct_in,buffered_in,dump_in,arena,budget);
+    }
+    //!
+    //! @brief Przygotowuje warstwę do ponownego użycia (parametry jak w konstruktorze).
+    //! 
+    void reset(
+      ict::logger::flags_t direct_in,
+      ict::logger::flags_t buffered_in,
+      ict::logger::flags_t dump_in,
+      Arena * arena,
+      std::size_t budget
+    ){
+      direct=direct_in;
+      dump=dump_in;
+      active=direct_in|buffered_in;
+      done=0;
+      ready=0;
+      log_buffer.reset(arena,budget);
+    }
+    //! Poziomy logowania, które są aktywne na tej warstwie.
+    ict::logger::flags_t getActive() const {return(active);}
+    //! Poziomy logowania, które powodują opróżnienie bufora na tej warstwie.
+    ict::logger::flags_t getDump() const {return(dump);}
+    //!
+    //! @brief Zamyka warstwę (zrzuca bufor, jeśli pojawił się poziom wyzwalający zrzut, i zwalnia jego pamięć).
+    //! 
+    void close(){
+      TRY_BEGIN
+      if (dump&done){//Jeśli pojawił się poziom, który wyzwala zrzut z buforów logujących
+        doDump();//Zrób zrzut.
+      } else if (log_buffer.getCount()) {//Linie buforowane są porzucane.
+        stats_count(stat_discarded,log_buffer.getCount());
+      }
+      if (log_buffer.getDropped()) stats_count(stat_overwritten,log_buffer.getDropped());
+      if (log_buffer.getRejected()) stats_count(stat_discarded,log_buffer.getRejected());
+      TRY_END
+      log_buffer.release();
+    }
+    //!
+    //! @brief Zrzuca cały bufor linii loga.
+    //! 
+    void doDump(){
+      TRY_BEGIN
+      log_line_t<charT> log_warn;
+      const bool lost(log_buffer.getDropped()||log_buffer.getRejected());
+      if (lost){//Najstarsze linie zostały nadpisane lub linie nie zmieściły się w budżecie.
+        log_warn.buffered=true;
+        log_warn.line="logger.cpp";
+        log_warn.line+=" (";
+        log_warn.line+=__PRETTY_FUNCTION__;
+        log_warn.line+=") ";
+        log_warn.line+="Bufor loggera osiągnął maksymalny rozmiar (pominięto najstarsze linie: ";
+        log_warn.line+=std::to_string(log_buffer.getDropped());
+        if (log_buffer.getRejected()){
+          log_warn.line+=", linie większe niż bufor: ";
+          log_warn.line+=std::to_string(log_buffer.getRejected());
+        }
+        log_warn.line+=")!";
+        log_warn.severity=warning;
+      }
+      log_line_t<charT> line;
+      line.buffered=true;
+      output::log_dump_out<charT>([this,lost,&log_warn,&line](auto f){//Zapisz w wyjściach cały bufor naraz.
+        if (lost) f(log_warn);
+        log_buffer.forEach(line,f);
+      });
+      stats_count(stat_dumped,log_buffer.getCount());
+      stats_count(stat_dumps);
+      log_buffer.clear();//Wyczyść bufor.
+      TRY_END
+    }
+    basic_ostream_t & getLogger(flags_t severity){
+      static BlackHole<charT> blackHoleBuff;
+      static thread_local basic_ostream_t blackHole(&blackHoleBuff);
+      TRY_BEGIN
+      done|=severity;//Zaznacz, że był taki.
+      if ((severity&all)&&!(severity&(severity-1))&&(active&severity)){//Jeśli poziom logowania jest prawidłowy (jeden bit) i aktywny na tej warstwie.
+        std::unique_ptr<StreamPack> & p(logger_map[__builtin_ctz(severity)]);
+        if (!(ready&severity)){//Pierwsze użycie poziomu od ostatniego reset().
+          if (p) p->reset(!(severity&direct));//Przygotuj loger poprzedniego użycia warstwy.
+          else p.reset(new StreamPack(severity,!(severity&direct),&log_buffer));//Stwórz logera.
+          ready|=severity;
+        }
+        StreamPack & pack(*p);
+        set_site_target(&pack.stream,&pack.buffer);
+        return(pack.stream);//Zwróć go.
+      }
+      TRY_END
+      return(blackHole);
+    }
+  };
+  typedef Single<char> single_char_t;
+  //==========================================================================
+  //! Generacja stosów logerów - zwiększana przez restart loggera.
+  static std::atomic<std::size_t> stack_generation(0);
+  //! Klasa obsługująca stos logerów (jeden na wątek).
+  template <
+    typename charT=char,
+    typename traits=std::char_traits<charT>
+  > 
+  class Stack
+  {
+  public:
+    typedef Single<charT,traits> single_t;
+  private:
+    //! Obszar pamięci linii buforowanych (musi istnieć dłużej niż warstwy).
+    Arena arena;
+    //! Warstwy - otwarte (poniżej depth) i zamknięte do ponownego użycia (od depth).
+    std::vector<std::unique_ptr<single_t>> layers;
+    //! Liczba otwartych warstw (stos logerów).
+    std::size_t depth=0;
+    //! Generacja stosu logerów.
+    std::size_t generation=stack_generation.load();
+    //!
+    //! @brief Zamyka najwyższą warstwę (pozostaje do ponownego użycia).
+    //! 
+    void close(){
+      layers[--depth]->close();
+    }
+  public:
+    ~Stack(){
+      while (depth) close();
+    }
+    //!
+    //! @brief Kasuje stos, jeśli od jego utworzenia logger został zrestartowany.
+    //! 
+    void check(){
+      const std::size_t g(stack_generation.load(std::memory_order_acquire));
+      if (generation!=g){
+        while (depth) close();
+        generation=g;
+        update();
+      }
+    }
+    //!
+    //! @brief Uaktualnia poziomy logowania najwyższej warstwy w bieżącym wątku.
+    //! 
+    void update(){
+      if (depth){
+        input::layerMask.active=layers[depth-1]->getActive();
+        input::layerMask.dump=layers[depth-1]->getDump();
+      } else {
+        input::layerMask.active=ict::logger::none;
+        input::layerMask.dump=ict::logger::none;
+      }
+    }
+    //!
+    //! @brief Podaje referencję do najwyższego logera.
+    //! 
+    single_t & operator ()(){
+      return(*layers[depth-1]);
+    }
+    //!
+    //! @brief Dokłada nowego logger na stos.
+    //! 
+    //! @param [in] direct_in Poziomy logowania bez buforowania na tej warstwie.
+    //! @param [in] buffered_in Poziomy logowania z buforowaniem na tej warstwie.
+    //! @param [in] dump_in Poziomy logowania, które powodują opróżnienie bufora na tej warstwie.
+    //! @param [in] budget_in Budżet linii buforowanych na tej warstwie (w bajtach).
+    //! @return Liczba logerów na stosie.
+    //!
+    std::size_t push(
+      ict::logger::flags_t direct_in,
+      ict::logger::flags_t buffered_in,
+      ict::logger::flags_t dump_in,
+      std::size_t budget_in
+    ){
+      check();
+      if (depth<layers.size()){//Użyj zamkniętej warstwy.
+        layers[depth]->reset(direct_in,buffered_in,dump_in,&arena,budget_in);
+      } else {
+        layers.emplace_back(new single_t(direct_in,buffered_in,dump_in,&arena,budget_in));
+      }
+      depth++;
+      update();
+      return(depth);
+    }
+    //!
+    //! @brief Zdejmuje loggera ze stosu, jeśli nie jest to ostatni loger.
+    //! 
+    //! @return Liczba logerów na stosie.
+    //!
+    std::size_t pop(){
+      check();
+      if (depth>0){
+        close();
+      }
+      update();
+      return(depth);
+    }
+    //!
+    //! @brief Zwraca liczbę logerów na stosie.
+    //! 
+    //! @return Liczba logerów na stosie.
+    //!
+    std::size_t size(){
+      check();
+      return(depth);
+    }
+  };
+  //==========================================================================
+  //! Stos logerów dla bieżącego wątku (char).
+  typedef Stack<char> stack_char_t;
+  static stack_char_t & get_stack_char(){
+    static thread_local stack_char_t stack_char;
+    return(stack_char);
+  }
+  //==========================================================================
+  namespace input {
+    thread_local layer_mask_t layerMask{ict::logger::none,ict::logger::none};
+    struct Data{
+      //! Wartość domyślna dla poziomów logowania bez buforowania na danej warstwie.
+      std::atomic<ict::logger::flags_t> directDefault{ict::logger::notices};
+      //! Wartość domyślna dla poziomów logowania z buforowaniem na danej warstwie.
+      std::atomic<ict::logger::flags_t> bufferedDefault{ict::logger::nonotices};
+      //! Wartość domyślna dla poziomów logowania, które powodują opróżnienie bufora na danej warstwie.
+      std::atomic<ict::logger::flags_t> dumpDefault{ict::logger::errors};
+    };
+    static Data & data(){
+      static Data data;
+      return(data);
+    }
+    void setDefault(
+      ict::logger::flags_t direct_in,
+      ict::logger::flags_t buffered_in,
+      ict::logger::flags_t dump_in
+    ){
+      TRY_BEGIN
+      data().directDefault.store(direct_in);
+      data().bufferedDefault.store(buffered_in);
+      data().dumpDefault.store(dump_in);
+      TRY_END
+    }
+    void setBudget(std::size_t budget,std::size_t limit){
+      TRY_BEGIN
+      layer_budget.store(budget);
+      arena_limit.store(limit);
+      TRY_END
+    }
+    void setDeferred(bool on){
+      deferred_lines.store(on);
+    }
+    Layer::Layer(
+      ict::logger::flags_t direct_in,
+      ict::logger::flags_t buffered_in,
+      ict::logger::flags_t dump_in,
+      std::size_t budget_in
+    ){
+      TRY_BEGIN
+      if (ict::logger::defaultValue&direct_in) direct_in=data().directDefault.load();//Jeśli wartość domyślna.
+      if (ict::logger::defaultValue&buffered_in) buffered_in=data().bufferedDefault.load();//Jeśli wartość domyślna.
+      if (ict::logger::defaultValue&dump_in) dump_in=data().dumpDefault.load();//Jeśli wartość domyślna.
+      if (!budget_in) budget_in=layer_budget.load();//Jeśli wartość domyślna.
+      get_stack_char().push(direct_in,buffered_in,dump_in,budget_in);//Dodaj loggera char dla tej warstwy.
+      TRY_END
+    }
+    Layer::~Layer(){
+      TRY_BEGIN
+      get_stack_char().pop();//Zdejmij loggera ze stosu.
+      TRY_END
+    }
+    std::ostream & ostream(flags_t severity){
+      static BlackHole<char> blackHoleBuff;
+      static thread_local std::basic_ostream<char> blackHole(&blackHoleBuff);
+      TRY_BEGIN
+      stack_char_t & stack(get_stack_char());
+      if(stack.size())//Jeśli są logery na stosie.
+        return(stack().getLogger(severity));//Pobierz najwyższego loggera.
+      TRY_END
+      return(blackHole);
     }
     dummy_stream & dummy(){
       static dummy_stream d;
       return(d);
     }
+    std::vector<field_t> & fields(){
+      static thread_local std::vector<field_t> f;
+      return(f);
+    }
+    void logFields(flags_t severity,const site_struct & site,const char * msg){
+      TRY_BEGIN
+      std::ostream & os(ostream(severity));
+      if ((&os==site_stream)&&site_buffer) site_buffer->putFields(site,msg?msg:"",fields());
+      fields().clear();
+      TRY_END
+    }
+    std::string * beginFormat(flags_t severity,const site_struct & site,const char * fmt,bool & deferred){
+      TRY_BEGIN
+      std::ostream & os(ostream(severity));
+      if ((&os==site_stream)&&site_buffer) return(&site_buffer->beginFormat(site,fmt,deferred));
+      TRY_END
+      return(nullptr);
+    }
+    void endFormat(){
+      TRY_BEGIN
+      if (site_buffer) site_buffer->endFormat();
+      TRY_END
+    }
+    uint64_t limiterWindow(){
+      struct timespec ts;
+      ::clock_gettime(CLOCK_MONOTONIC_COARSE,&ts);
+      return(ts.tv_sec+1);
+    }
+    void logSuppressed(flags_t severity,uint64_t suppressed,const site_struct & site){
+      TRY_BEGIN
+      ostream(severity)<<site<<"Ograniczenie liczby linii (pominięto linie: "<<suppressed<<")!"<<std::endl;
+      TRY_END
+    }
+    void registerLimiter(limiter_t & limiter,flags_t severity,const site_struct & site){
+      TRY_BEGIN
+      output::log_limiter_register(limiter,severity,site);
+      TRY_END
+    }
+  }
+  void restart(){
+    TRY_BEGIN
+    //Stosy innych wątków zostaną skasowane przy ich najbliższym użyciu.
+    stack_generation.fetch_add(1,std::memory_order_release);
+    get_stack_char().check();
+    TRY_END
+    output::flush();//Zapisz linie zrzucone przez usunięte warstwy.
+  }
+//===========================================
+} }
+//===========================================
+#ifdef ENABLE_TESTING
+#include "test.hpp"
+#include <sstream>
+#include <regex>
+#include <iomanip>
+
+REGISTER_TEST(logger,tc1){
+  LOGGER_BASEDIR;
+  LOGGER_THREAD;
+  LOGGER_SET(std::cerr);
+  LOGGER_SET(std::cout);
+  LOGGER_SET("test");
+  #include "enable-all.hpp"
+  LOGGER_CRIT<<__LOGGER__<<"Test string > string ... "<<0<<" "<<ict::test::test_string[0]<<std::endl;
+  LOGGER_ERR<<__LOGGER__<<"Test string > string ... "<<1<<" "<<ict::test::test_string[1]<<std::endl;
+  LOGGER_WARN<<__LOGGER__<<"Test string > string ... "<<2<<" "<<ict::test::test_string[2]<<std::endl;
+  LOGGER_NOTICE<<__LOGGER__<<"Test string > string ... "<<3<<" "<<ict::test::test_string[3]<<std::endl;
+  LOGGER_INFO<<__LOGGER__<<"Test string > string ... "<<4<<" "<<ict::test::test_string[4]<<std::endl;
+  LOGGER_DEBUG<<__LOGGER__<<"Test string > string ... "<<5<<" "<<ict::test::test_string[5]<<std::endl;
+  #include "disable-all.hpp"
+  LOGGER_CRIT<<__LOGGER__<<"Test string > string ... "<<6<<" "<<ict::test::test_string[6]<<std::endl;
+  LOGGER_ERR<<__LOGGER__<<"Test string > string ... "<<7<<" "<<ict::test::test_string[7]<<std::endl;
+  LOGGER_WARN<<__LOGGER__<<"Test string > string ... "<<8<<" "<<ict::test::test_string[8]<<std::endl;
+  LOGGER_NOTICE<<__LOGGER__<<"Test string > string ... "<<9<<" "<<ict::test::test_string[9]<<std::endl;
+  LOGGER_INFO<<__LOGGER__<<"Test string > string ... "<<10<<" "<<ict::test::test_string[10]<<std::endl;
+  LOGGER_DEBUG<<__LOGGER__<<"Test string > string ... "<<11<<" "<<ict::test::test_string[11]<<std::endl;
+  #include "enable-all.hpp"
+  {
+    LOGGER_LAYER;
+    LOGGER_CRIT<<__LOGGER__<<"Test string > string ... "<<12<<" "<<ict::test::test_string[12]<<std::endl;
+    LOGGER_ERR<<__LOGGER__<<"Test string > string ... "<<13<<" "<<ict::test::test_string[13]<<std::endl;
+    LOGGER_WARN<<__LOGGER__<<"Test string > string ... "<<14<<" "<<ict::test::test_string[14]<<std::endl;
+    LOGGER_NOTICE<<__LOGGER__<<"Test string > string ... "<<15<<" "<<ict::test::test_string[15]<<std::endl;
+    LOGGER_INFO<<__LOGGER__<<"Test string > string ... "<<16<<" "<<ict::test::test_string[16]<<std::endl;
+    LOGGER_DEBUG<<__LOGGER__<<"Test string > string ... "<<17<<" "<<ict::test::test_string[17]<<std::endl;
+  }
+  return(0);
+}
+
+static std::regex getRegex(const std::string &sev,int no,bool b=false){
+  std::string tmp(b?"\\| ":"");
+  return std::regex(
+    "\\d{4}-\\d{2}-\\d{2} \\d{2}:\\d{2}:\\d{2}\\(\\+\\d{4}\\) "
+    +tmp
+    +sev
+    +" logger\\.cpp:\\d+ "
+    +".*"
+    +"\\(\\)\\) Test "
+    +std::to_string(no)
+    +".*"
+  );
+}
+
+REGISTER_TEST(logger,tc2){
+  std::stringstream stream;
+  std::string line;
+  LOGGER_BASEDIR;
+  LOGGER_THREAD;
+  LOGGER_SET(std::cerr,ict::logger::none);
+  LOGGER_SET(std::cout,ict::logger::none);
+  LOGGER_SET("test",ict::logger::none);
+  LOGGER_SET(stream);
+  #include "enable-all.hpp"
+  LOGGER_CRIT<<__LOGGER__<<"Test "<<1<<std::endl;
+  LOGGER_ERR<<__LOGGER__<<"Test "<<2<<std::endl;
+  LOGGER_WARN<<__LOGGER__<<"Test "<<3<<std::endl;
+  LOGGER_NOTICE<<__LOGGER__<<"Test "<<4<<std::endl;
+  LOGGER_INFO<<__LOGGER__<<"Test "<<5<<std::endl;
+  LOGGER_DEBUG<<__LOGGER__<<"Test "<<6<<std::endl;
+  #include "disable-all.hpp"
+  LOGGER_CRIT<<__LOGGER__<<"Test "<<7<<std::endl;
+  LOGGER_ERR<<__LOGGER__<<"Test "<<8<<std::endl;
+  LOGGER_WARN<<__LOGGER__<<"Test "<<9<<std::endl;
+  LOGGER_NOTICE<<__LOGGER__<<"Test "<<10<<std::endl;
+  LOGGER_INFO<<__LOGGER__<<"Test "<<11<<std::endl;
+  LOGGER_DEBUG<<__LOGGER__<<"Test "<<12<<std::endl;
+  if (std::getline(stream,line)){
+    if (!std::regex_match(line,getRegex("CRITICAL",1))){
+      std::cout<<"line="<<line<<std::endl;
+      return(1); 
+    }
+  } else return(101);
+  if (std::getline(stream,line)){
+    if (!std::regex_match(line,getRegex("ERROR",2))){
+      std::cout<<"line="<<line<<std::endl;
+      return(2); 
+    }
+  } else return(102);
+  if (std::getline(stream,line)){
+    if (!std::regex_match(line,getRegex("WARNING",3))){
+      std::cout<<"line="<<line<<std::endl;
+      return(3); 
+    }
+  } else return(103);
+  if (std::getline(stream,line)){
+    if (!std::regex_match(line,getRegex("NOTICE",4))){
+      std::cout<<"line="<<line<<std::endl;
+      return(4); 
+    }
+  } else return(104);
+  if (std::getline(stream,line)){
+    if (!std::regex_match(line,getRegex("INFO",5))){
+      std::cout<<"line="<<line<<std::endl;
+      return(5); 
+    }
+  } else return(105);
+  if (std::getline(stream,line)){
+    if (!std::regex_match(line,getRegex("DEBUG",6))){
+      std::cout<<"line="<<line<<std::endl;
+      return(6); 
+    }
+  } else return(106);
+  if (std::getline(stream,line)){
+    return(200);
+  }
+  return(0);
+}
+REGISTER_TEST(logger,tc3){
+  std::stringstream stream;
+  std::string line;
+  LOGGER_BASEDIR;
+  LOGGER_THREAD;
+  LOGGER_SET(std::cerr,ict::logger::none);
+  LOGGER_SET(std::cout,ict::logger::none);
+  LOGGER_SET("test",ict::logger::none);
+  LOGGER_SET(stream);
+  #include "enable-all.hpp"
+  {
+    LOGGER_LAYER;
+    LOGGER_CRIT<<__LOGGER__<<"Test "<<1<<std::endl;
+    LOGGER_ERR<<__LOGGER__<<"Test "<<2<<std::endl;
+    LOGGER_WARN<<__LOGGER__<<"Test "<<3<<std::endl;
+    LOGGER_NOTICE<<__LOGGER__<<"Test "<<4<<std::endl;
+    LOGGER_INFO<<__LOGGER__<<"Test "<<5<<std::endl;
+    LOGGER_DEBUG<<__LOGGER__<<"Test "<<6<<std::endl;
+  }
+  if (std::getline(stream,line)){
+    if (!std::regex_match(line,getRegex("CRITICAL",1))){
+      std::cout<<"line="<<line<<std::endl;
+      return(1); 
+    }
+  } else return(101);
+  if (std::getline(stream,line)){
+    if (!std::regex_match(line,getRegex("ERROR",2))){
+      std::cout<<"line="<<line<<std::endl;
+      return(2); 
+    }
+  } else return(102);
+  if (std::getline(stream,line)){
+    if (!std::regex_match(line,getRegex("WARNING",3))){
+      std::cout<<"line="<<line<<std::endl;
+      return(3); 
+    }
+  } else return(103);
+  if (std::getline(stream,line)){
+    if (!std::regex_match(line,getRegex("NOTICE",4))){
+      std::cout<<"line="<<line<<std::endl;
+      return(4); 
+    }
+  } else return(104);
+  if (std::getline(stream,line)){
+    if (!std::regex_match(line,getRegex("INFO",5,true))){
+      std::cout<<"line="<<line<<std::endl;
+      return(5); 
+    }
+  } else return(105);
+  if (std::getline(stream,line)){
+    if (!std::regex_match(line,getRegex("DEBUG",6,true))){
+      std::cout<<"line="<<line<<std::endl;
+      return(6); 
+    }
+  } else return(106);
+  if (std::getline(stream,line)){
+    return(200);
+  }
+  return(0);
+}
+REGISTER_TEST(logger,tc4){
+  std::stringstream stream;
+  std::string line;
+  LOGGER_BASEDIR;
+  LOGGER_THREAD;
+  LOGGER_SET(std::cerr,ict::logger::none);
+  LOGGER_SET(std::cout,ict::logger::none);
+  LOGGER_SET("test",ict::logger::none);
+  LOGGER_SET(stream);
+  #include "enable-all.hpp"
+  {
+    LOGGER_LAYER;
+    LOGGER_WARN<<__LOGGER__<<"Test "<<3<<std::endl;
+    LOGGER_NOTICE<<__LOGGER__<<"Test "<<4<<std::endl;
+    LOGGER_INFO<<__LOGGER__<<"Test "<<5<<std::endl;
+    LOGGER_DEBUG<<__LOGGER__<<"Test "<<6<<std::endl;
+  }
+  if (std::getline(stream,line)){
+    if (!std::regex_match(line,getRegex("WARNING",3))){
+      std::cout<<"line="<<line<<std::endl;
+      return(3); 
+    }
+  } else return(103);
+  if (std::getline(stream,line)){
+    if (!std::regex_match(line,getRegex("NOTICE",4))){
+      std::cout<<"line="<<line<<std::endl;
+      return(4); 
+    }
+  } else return(104);
+  if (std::getline(stream,line)){
+    return(200);
+  }
+  return(0);
+}
+REGISTER_TEST(logger,tc5){
+  const int threads=4;
+  const int lines=2000;
+  std::stringstream stream;
+  std::string line;
+  std::vector<std::thread> pool;
+  std::vector<int> next(threads,0);
+  std::size_t count=0;
+  LOGGER_BASEDIR;
+  LOGGER_SET(std::cerr,ict::logger::none);
+  LOGGER_SET(std::cout,ict::logger::none);
+  LOGGER_SET("test",ict::logger::none);
+  LOGGER_SET(stream);
+  LOGGER_ASYNC(true,64);
+  #include "enable-all.hpp"
+  for (int t=0;t<threads;t++) pool.emplace_back([t]{
+    LOGGER_THREAD;
+    for (int k=0;k<lines;k++) LOGGER_INFO<<__LOGGER__<<"Test "<<t<<" "<<k<<std::endl;
+  });
+  for (std::thread & t: pool) t.join();
+  LOGGER_ASYNC(false);
+  if (ict::logger::output::testAsync()) return(1);
+  while (std::getline(stream,line)){
+    std::smatch m;
+    if (!std::regex_search(line,m,std::regex("Test (\\d+) (\\d+)$"))){
+      std::cout<<"line="<<line<<std::endl;
+      return(2);
+    }
+    int t(std::stoi(m[1])),k(std::stoi(m[2]));
+    if ((t<0)||(threads<=t)||(next[t]!=k)){//Kolejność linii w wątku musi być zachowana.
+      std::cout<<"line="<<line<<std::endl;
+      return(3);
+    }
+    next[t]++;
+    count++;
+  }
+  if (count!=(threads*lines)) return(4);
+  return(0);
+}
+static void tc6_restart(){
+  LOGGER_THREAD;
+  LOGGER_NOTICE<<__LOGGER__<<"Test "<<1<<std::endl;
+  LOGGER_RESTART;
+  LOGGER_NOTICE<<__LOGGER__<<"Test "<<2<<std::endl;
+}
+static void tc6_after(){
+  LOGGER_THREAD;
+  LOGGER_NOTICE<<__LOGGER__<<"Test "<<3<<std::endl;
+}
+REGISTER_TEST(logger,tc6){
+  std::stringstream stream;
+  std::string line;
+  LOGGER_BASEDIR;
+  LOGGER_SET(std::cerr,ict::logger::none);
+  LOGGER_SET(std::cout,ict::logger::none);
+  LOGGER_SET("test",ict::logger::none);
+  LOGGER_SET(stream);
+  #include "enable-all.hpp"
+  std::thread(tc6_restart).join();
+  std::thread(tc6_after).join();
+  if (std::getline(stream,line)){
+    if (!std::regex_match(line,getRegex("NOTICE",1))){
+      std::cout<<"line="<<line<<std::endl;
+      return(1); 
+    }
+  } else return(101);
+  if (std::getline(stream,line)){
+    if (!std::regex_match(line,getRegex("NOTICE",3))){
+      std::cout<<"line="<<line<<std::endl;
+      return(3); 
+    }
+  } else return(103);
+  if (std::getline(stream,line)){
+    return(200);
+  }
+  return(0);
+}
+static std::vector<std::string> tc7_reference(const std::string & in){
+  std::vector<std::string> out;
+  std::string line;
+  bool newline=true;
+  for (char c: in){
+    switch (c){
+      case '\t':case '\v':case '\0':c=' ';break;
+      case '\n':case '\r':
+        if (!newline) out.push_back(line);
+        newline=true;
+        continue;
+      default:break;
+    }
+    if (newline) line.clear();
+    newline=false;
+    line+=c;
+  }
+  return(out);
+}
+REGISTER_TEST(logger,tc7){
+  static const char alphabet[]={'a','b','c',' ','\t','\v','\0','\n','\r','\x01','\x0c','\x7f','\xff'};
+  std::stringstream stream;
+  std::string line;
+  std::vector<std::string> expected;
+  uint32_t seed=1;
+  LOGGER_SET(std::cerr,ict::logger::none);
+  LOGGER_SET(std::cout,ict::logger::none);
+  LOGGER_SET("test",ict::logger::none);
+  LOGGER_SET(stream);
+  LOGGER_THREAD;
+  #include "enable-all.hpp"
+  for (int k=0;k<200;k++){
+    std::string in;
+    for (int i=(k*7)%150;i;i--){
+      seed=seed*1103515245+12345;
+      in+=alphabet[(seed>>16)%sizeof(alphabet)];
+    }
+    in+="\n";
+    for (const std::string & l: tc7_reference(in)) expected.push_back(l);
+    for (const std::string & l: tc7_reference(in)) expected.push_back(l);
+    LOGGER_INFO<<in;//Cały ciąg naraz.
+    for (char c: in) LOGGER_INFO<<c;//Znak po znaku.
+  }
+  for (const std::string & e: expected){
+    if (!std::getline(stream,line)) return(1);
+    const std::size_t pos(line.find(" INFO "));
+    if ((pos==std::string::npos)||(line.substr(pos+6)!=e)){
+      std::cout<<"line="<<line<<std::endl;
+      return(2);
+    }
+  }
+  if (std::getline(stream,line)){
+    return(200);
+  }
+  return(0);
+}
+REGISTER_TEST(logger,tc8){
+  std::stringstream stream;
+  std::string line;
+  LOGGER_BASEDIR;
+  LOGGER_SET(std::cerr,ict::logger::none);
+  LOGGER_SET(std::cout,ict::logger::none);
+  LOGGER_SET("test",ict::logger::none);
+  LOGGER_SET(stream);
+  LOGGER_THREAD;
+  #include "enable-all.hpp"
+  for (unsigned digits: {3,6,9,0}){
+    LOGGER_PRECISION(digits);
+    LOGGER_NOTICE<<__LOGGER__<<"Test "<<digits<<std::endl;
+    if (!std::getline(stream,line)) return(100+digits);
+    const std::regex r(
+      "\\d{4}-\\d{2}-\\d{2} \\d{2}:\\d{2}:\\d{2}"
+      +(digits?("\\.\\d{"+std::to_string(digits)+"}"):std::string())
+      +"\\([+-]\\d{4}\\) NOTICE .*Test "+std::to_string(digits)
+    );
+    if (!std::regex_match(line,r)){
+      std::cout<<"line="<<line<<std::endl;
+      return(digits);
+    }
   }
-  void restart(){
-    std::lock_guard<std::mutex> lock(input::data().mutex);
-    TRY_BEGIN
-    get_map_char().clear();
-    TRY_END
+  return(0);
+}
+REGISTER_TEST(logger,tc9){
+  std::stringstream stream;
+  std::stringstream binary;
+  std::stringstream decoded;
+  LOGGER_BASEDIR;
+  LOGGER_SET(std::cerr,ict::logger::none);
+  LOGGER_SET(std::cout,ict::logger::none);
+  LOGGER_SET("test",ict::logger::none);
+  LOGGER_SET(stream);
+  LOGGER_BINARY(binary,ict::logger::all);
+  if (ict::logger::output::testBinary(&binary)!=ict::logger::all) return(1);
+  LOGGER_THREAD;
+  #include "enable-all.hpp"
+  for (int k=0;k<3;k++){
+    LOGGER_NOTICE<<__LOGGER__<<"Test "<<k<<std::endl;
+    LOGGER_WARN<<"Test "<<k<<" "<<__LOGGER__<<std::endl;
+    LOGGER_INFO<<"Test "<<k<<"\tno site"<<std::endl;
+    LOGGER_PRECISION(3*k);
+  }
+  {
+    LOGGER_LAYER;
+    LOGGER_DEBUG<<__LOGGER__<<"Test "<<4<<std::endl;
+    LOGGER_ERR<<__LOGGER__<<"Test "<<5<<std::endl;
+  }
+  LOGGER_PRECISION(0);
+  LOGGER_BINARY(binary,ict::logger::none);
+  if (ict::logger::output::testBinary(&binary)) return(2);
+  if (!ict::logger::output::decode(binary,decoded)) return(3);
+  if (decoded.str()!=stream.str()){
+    std::cout<<"text="<<std::endl<<stream.str()<<"decoded="<<std::endl<<decoded.str();
+    return(4);
+  }
+  if (binary.str().size()*2>stream.str().size()) return(5);
+  return(0);
+}
+static int tc10_count=0;
+static int tc10_arg(){
+  return(++tc10_count);
+}
+REGISTER_TEST(logger,tc10){
+  std::stringstream stream;
+  std::string line;
+  LOGGER_BASEDIR;
+  LOGGER_SET(std::cerr,ict::logger::none);
+  LOGGER_SET(std::cout,ict::logger::none);
+  LOGGER_SET("test",ict::logger::none);
+  #include "enable-all.hpp"
+  LOGGER_ERR<<__LOGGER__<<"Test "<<tc10_arg()<<std::endl;//Brak warstwy.
+  if (tc10_count!=0) return(1);
+  LOGGER_THREAD;
+  LOGGER_ERR<<__LOGGER__<<"Test "<<tc10_arg()<<std::endl;//Brak wyjść.
+  if (tc10_count!=0) return(2);
+  LOGGER_SET(stream,ict::logger::nonotices);
+  LOGGER_ERR<<__LOGGER__<<"Test "<<tc10_arg()<<std::endl;//Wyjście nie przyjmuje tego poziomu.
+  if (tc10_count!=0) return(3);
+  LOGGER_INFO<<__LOGGER__<<"Test "<<tc10_arg()<<std::endl;
+  if (tc10_count!=1) return(4);
+  {
+    LOGGER_LAYER;
+    LOGGER_INFO<<__LOGGER__<<"Test "<<tc10_arg()<<std::endl;//Buforowane.
+    if (tc10_count!=2) return(5);
+    LOGGER_ERR<<__LOGGER__<<"Test "<<tc10_arg()<<std::endl;//Nikt nie odbierze linii, ale wyzwala zrzut.
+    if (tc10_count!=3) return(6);
+  }
+  if (std::getline(stream,line)){
+    if (!std::regex_match(line,getRegex("INFO",1))){
+      std::cout<<"line="<<line<<std::endl;
+      return(7); 
+    }
+  } else return(107);
+  if (std::getline(stream,line)){
+    if (!std::regex_match(line,getRegex("INFO",2,true))){
+      std::cout<<"line="<<line<<std::endl;
+      return(8); 
+    }
+  } else return(108);
+  if (std::getline(stream,line)){
+    return(200);
+  }
+  return(0);
+}
+static int tc11_count=0;
+static int tc11_arg(){
+  return(++tc11_count);
+}
+REGISTER_TEST(logger,tc11){
+  std::stringstream stream;
+  std::string line;
+  LOGGER_BASEDIR;
+  LOGGER_THREAD;
+  LOGGER_SET(std::cerr,ict::logger::none);
+  LOGGER_SET(std::cout,ict::logger::none);
+  LOGGER_SET("test",ict::logger::none);
+  LOGGER_SET(stream);
+  #undef LOGGER_MIN_LEVEL
+  #define LOGGER_MIN_LEVEL LOGGER_LEVEL_WARN
+  #include "enable-all.hpp"
+  LOGGER_INFO<<__LOGGER__<<"Test "<<tc11_arg()<<std::endl;//Usunięte w czasie kompilacji.
+  LOGGER_NOTICE<<__LOGGER__<<"Test "<<tc11_arg()<<std::endl;//Usunięte w czasie kompilacji.
+  if (tc11_count!=0) return(1);
+  LOGGER_WARN<<__LOGGER__<<"Test "<<tc11_arg()<<std::endl;
+  if (tc11_count!=1) return(2);
+  #include "disable-warn.hpp"
+  LOGGER_WARN<<__LOGGER__<<"Test "<<tc11_arg()<<std::endl;//Wyłączone.
+  if (tc11_count!=1) return(3);
+  #undef LOGGER_MIN_LEVEL
+  #define LOGGER_MIN_LEVEL LOGGER_LEVEL_DEBUG
+  #include "enable-all.hpp"
+  LOGGER_DEBUG<<__LOGGER__<<"Test "<<tc11_arg()<<std::endl;
+  if (tc11_count!=2) return(4);
+  if (!__LOGGER__.relative) return(5);
+  if (std::string(__LOGGER__.file)!="logger.cpp") return(6);
+  if (std::getline(stream,line)){
+    if (!std::regex_match(line,getRegex("WARNING",1))){
+      std::cout<<"line="<<line<<std::endl;
+      return(7); 
+    }
+  } else return(107);
+  if (std::getline(stream,line)){
+    if (!std::regex_match(line,getRegex("DEBUG",2))){
+      std::cout<<"line="<<line<<std::endl;
+      return(8); 
+    }
+  } else return(108);
+  if (std::getline(stream,line)){
+    return(200);
+  }
+  return(0);
+}
+static std::vector<std::string> tc12_files(const std::filesystem::path & path){
+  std::vector<std::string> out;
+  for (const std::filesystem::directory_entry & e: std::filesystem::directory_iterator(path.parent_path())){
+    const std::string name(e.path().filename().native());
+    if (name.compare(0,path.filename().native().size()+1,path.filename().native()+".")==0) out.push_back(e.path().native());
+  }
+  std::sort(out.begin(),out.end());
+  return(out);
+}
+REGISTER_TEST(logger,tc12){
+  const std::filesystem::path dir(std::filesystem::temp_directory_path()/("libict-logger-tc12-"+std::to_string(::getpid())));
+  const std::filesystem::path path(dir/"app.log");
+  const std::filesystem::path kept(dir/"kept.log");
+  ict::logger::output::file_options_t options;
+  std::vector<std::string> files;
+  std::string line;
+  int k(1);
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+  LOGGER_BASEDIR;
+  LOGGER_THREAD;
+  LOGGER_SET(std::cerr,ict::logger::none);
+  LOGGER_SET(std::cout,ict::logger::none);
+  LOGGER_SET("test",ict::logger::none);
+  #include "enable-all.hpp"
+  options.buffer=100;
+  options.max_size=400;
+  LOGGER_FILE(path.native(),ict::logger::all,options);
+  if (LOGGER_TEST_FILE(path.native())!=ict::logger::all) return(1);
+  for (int i=1;i<=30;i++) LOGGER_INFO<<__LOGGER__<<"Test "<<i<<std::endl;
+  LOGGER_FLUSH;
+  files=tc12_files(path);
+  if (files.size()<3) return(2);//Rotacja według rozmiaru.
+  files.push_back(path.native());
+  for (const std::string & f: files){
+    std::ifstream in(f);
+    if (400<std::filesystem::file_size(f)) return(3);
+    while (std::getline(in,line)){
+      if (!std::regex_match(line,getRegex("INFO",k))){
+        std::cout<<"file="<<f<<" line="<<line<<std::endl;
+        return(4);
+      }
+      k++;
+    }
+  }
+  if (k!=31) return(5);
+  options.keep=2;
+  LOGGER_FILE(kept.native(),ict::logger::all,options);
+  for (int i=1;i<=30;i++) LOGGER_INFO<<__LOGGER__<<"Test "<<i<<std::endl;
+  LOGGER_FLUSH;
+  for (int i=0;(2<tc12_files(kept).size())&&(i<50);i++) std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  if (tc12_files(kept).size()!=2) return(6);//Usuwanie starych plików.
+  LOGGER_FILE(path.native(),ict::logger::none);
+  LOGGER_FILE(kept.native(),ict::logger::none);
+  if (LOGGER_TEST_FILE(path.native())!=ict::logger::none) return(7);
+  std::filesystem::remove_all(dir);
+  return(0);
+}
+REGISTER_TEST(logger,tc13){
+  const std::filesystem::path path(std::filesystem::temp_directory_path()/("libict-logger-tc13-"+std::to_string(::getpid())+".rec"));
+  std::stringstream stream;
+  std::stringstream recovered;
+  std::string line;
+  int k;
+  std::filesystem::remove(path);
+  LOGGER_BASEDIR;
+  LOGGER_THREAD;
+  LOGGER_SET(std::cerr,ict::logger::none);
+  LOGGER_SET(std::cout,ict::logger::none);
+  LOGGER_SET("test",ict::logger::none);
+  LOGGER_SET(stream,ict::logger::errors);
+  #include "enable-all.hpp"
+  LOGGER_RECORDER(path.native(),ict::logger::all,1024);
+  if (LOGGER_TEST_RECORDER(path.native())!=ict::logger::all) return(1);
+  if (LOGGER_TEST_FILE(path.native())!=ict::logger::none) return(2);
+  for (int i=1;i<=30;i++) LOGGER_ERR<<__LOGGER__<<"Test "<<i<<std::endl;
+  {
+    LOGGER_LAYER;
+    for (int i=31;i<=40;i++) LOGGER_DEBUG<<__LOGGER__<<"Test "<<i<<std::endl;//Bufor nie jest opróżniany.
+  }
+  //Plik jest czytany bez zamykania rejestratora (jak po zabiciu procesu).
+  if (!ict::logger::output::recover(path.native(),recovered)) return(3);
+  if (recovered.str().empty()) return(4);//Rekordy są zwięźlejsze niż tekst - wynik może przekraczać pojemność.
+  k=0;
+  while (std::getline(recovered,line)){
+    int i;
+    if (std::sscanf(line.c_str()+line.rfind("Test "),"Test %d",&i)!=1) return(5);
+    if (k&&(i!=(k+1))) {
+      std::cout<<"line="<<line<<std::endl;
+      return(6);
+    }
+    if (!std::regex_match(line,getRegex((i<=30)?"ERROR":"DEBUG",i))){
+      std::cout<<"line="<<line<<std::endl;
+      return(7);
+    }
+    k=i;
+  }
+  if (k!=40) return(8);
+  recovered.str("");
+  recovered.clear();
+  if (!ict::logger::output::recover(path.native(),recovered,200)) return(9);
+  if (200<recovered.str().size()) return(10);
+  if (recovered.str().find("Test 40\n")==std::string::npos) return(11);
+  //Ponowne otwarcie zachowuje zawartość.
+  LOGGER_RECORDER(path.native(),ict::logger::none);
+  LOGGER_RECORDER(path.native(),ict::logger::all,1024);
+  LOGGER_ERR<<__LOGGER__<<"Test "<<41<<std::endl;
+  recovered.str("");
+  recovered.clear();
+  if (!ict::logger::output::recover(path.native(),recovered)) return(12);
+  if (recovered.str().find("Test 40\n")==std::string::npos) return(13);
+  if (recovered.str().find("Test 41\n")==std::string::npos) return(14);
+  LOGGER_RECORDER(path.native(),ict::logger::none);
+  std::filesystem::remove(path);
+  return(0);
+}
+REGISTER_TEST(logger,tc14){
+  std::stringstream stream;
+  std::string line;
+  int k(0);
+  LOGGER_BASEDIR;
+  LOGGER_THREAD;
+  LOGGER_SET(std::cerr,ict::logger::none);
+  LOGGER_SET(std::cout,ict::logger::none);
+  LOGGER_SET("test",ict::logger::none);
+  LOGGER_SET(stream);
+  #include "enable-all.hpp"
+  {
+    LOGGER_L(ict::logger::notices,ict::logger::nonotices,ict::logger::errors,2048);
+    LOGGER_DEBUG<<__LOGGER__<<"Test "<<1<<std::endl;
+    {
+      LOGGER_LAYER;//Warstwa bez zrzutu.
+      for (int i=1;i<=50;i++) LOGGER_DEBUG<<__LOGGER__<<"Test "<<0<<std::endl;
+    }
+    for (int i=2;i<=100;i++) LOGGER_DEBUG<<__LOGGER__<<"Test "<<i<<std::endl;
+    LOGGER_ERR<<__LOGGER__<<"Test "<<101<<std::endl;
+  }
+  if (std::getline(stream,line)){
+    if (!std::regex_match(line,getRegex("ERROR",101))){
+      std::cout<<"line="<<line<<std::endl;
+      return(1); 
+    }
+  } else return(101);
+  if (std::getline(stream,line)){
+    if (line.find("| WARNING logger.cpp")==std::string::npos){
+      std::cout<<"line="<<line<<std::endl;
+      return(2); 
+    }
+  } else return(102);
+  while (std::getline(stream,line)){//Zachowane są najnowsze linie (w kolejności).
+    int i;
+    if (std::sscanf(line.c_str()+line.rfind("Test "),"Test %d",&i)!=1) return(3);
+    if (k&&(i!=(k+1))) {
+      std::cout<<"line="<<line<<std::endl;
+      return(4);
+    }
+    if (!std::regex_match(line,getRegex("DEBUG",i,true))){
+      std::cout<<"line="<<line<<std::endl;
+      return(5);
+    }
+    k=i;
+  }
+  if (k!=100) return(6);
+  //Warstwy używane ponownie zachowują swoje ustawienia.
+  stream.str("");
+  stream.clear();
+  {
+    LOGGER_L(ict::logger::all,ict::logger::none,ict::logger::none);
+    LOGGER_DEBUG<<__LOGGER__<<"Test "<<1<<std::endl;
+  }
+  if (std::getline(stream,line)){
+    if (!std::regex_match(line,getRegex("DEBUG",1))){
+      std::cout<<"line="<<line<<std::endl;
+      return(7); 
+    }
+  } else return(107);
+  //Budżet mniejszy niż nagłówek wpisu - linie są liczone i zgłaszane przy zrzucie.
+  stream.str("");
+  stream.clear();
+  {
+    const ict::logger::stats_t before(LOGGER_STATS);
+    {
+      LOGGER_L(ict::logger::notices,ict::logger::nonotices,ict::logger::errors,8);
+      LOGGER_DEBUG<<__LOGGER__<<"Test "<<1<<std::endl;
+      LOGGER_ERR<<__LOGGER__<<"Test "<<2<<std::endl;
+    }
+    const ict::logger::stats_t after(LOGGER_STATS);
+    if ((after.discarded-before.discarded)!=1) return(8);
+  }
+  if (stream.str().find("linie większe niż bufor: 1)")==std::string::npos){
+    std::cout<<"stream="<<stream.str()<<std::endl;
+    return(9);
+  }
+  return(0);
+}
+static std::atomic<bool> tc15_stop(false);
+static void tc15_thread(){
+  LOGGER_THREAD;
+  #include "enable-all.hpp"
+  while (!tc15_stop.load()) LOGGER_NOTICE<<__LOGGER__<<"Test "<<1000<<std::endl;
+}
+REGISTER_TEST(logger,tc15){
+  std::stringstream stream;
+  std::stringstream infos;
+  std::string line;
+  int k(0);
+  LOGGER_BASEDIR;
+  LOGGER_THREAD;
+  LOGGER_SET(std::cerr,ict::logger::none);
+  LOGGER_SET(std::cout,ict::logger::none);
+  LOGGER_SET("test",ict::logger::none);
+  LOGGER_SET(stream);
+  LOGGER_SET(infos,ict::logger::info);
+  #include "enable-all.hpp"
+  tc15_stop.store(false);
+  std::thread t(tc15_thread);
+  {
+    LOGGER_LAYER;
+    for (int i=1;i<=200;i++) {
+      if (i%2) LOGGER_INFO<<__LOGGER__<<"Test "<<i<<std::endl;
+      else LOGGER_DEBUG<<__LOGGER__<<"Test "<<i<<std::endl;
+    }
+    LOGGER_ERR<<__LOGGER__<<"Test "<<201<<std::endl;
+  }
+  tc15_stop.store(true);
+  t.join();
+  LOGGER_SET(stream,ict::logger::none);
+  LOGGER_SET(infos,ict::logger::none);
+  //Linie zrzutu tworzą jeden blok (bez linii innych wątków).
+  while (std::getline(stream,line)){
+    if (line.find("| ")==std::string::npos) {
+      if (k&&(k<200)) {
+        std::cout<<"line="<<line<<std::endl;
+        return(1);
+      }
+      continue;
+    }
+    k++;
+    if (!std::regex_match(line,getRegex((k%2)?"INFO":"DEBUG",k,true))){
+      std::cout<<"line="<<line<<std::endl;
+      return(2);
+    }
+  }
+  if (k!=200) return(3);
+  //Wyjście z filtrem otrzymuje tylko swoje linie.
+  k=1;
+  while (std::getline(infos,line)){
+    if (!std::regex_match(line,getRegex("INFO",k,true))){
+      std::cout<<"line="<<line<<std::endl;
+      return(4);
+    }
+    k+=2;
+  }
+  if (k!=201) return(5);
+  return(0);
+}
+//Odbiera wszystkie oczekujące komunikaty z gniazda.
+static std::vector<std::string> tc16_recv(int fd){
+  std::vector<std::string> out;
+  char buffer[4096];
+  for (ssize_t n;0<(n=::recv(fd,buffer,sizeof(buffer),MSG_DONTWAIT));) out.emplace_back(buffer,n);
+  return(out);
+}
+REGISTER_TEST(logger,tc16){
+  const std::string path((std::filesystem::temp_directory_path()/("libict-logger-tc16-"+std::to_string(::getpid())+".sock")).native());
+  const std::string pid(std::to_string(::getpid()));
+  const std::regex bsd("<11>[A-Z][a-z]{2} [ 1-3][0-9] [0-9]{2}:[0-9]{2}:[0-9]{2} tc16a\\["+pid+"\\]: ERROR logger\\.cpp:[0-9]+ .*Test 1");
+  const std::regex ietf("<131>1 [0-9]{4}-[0-9]{2}-[0-9]{2}T[0-9]{2}:[0-9]{2}:[0-9]{2}\\.[0-9]{6}[+-][0-9]{2}:[0-9]{2} [^ ]+ tc16b "+pid+" - - ERROR logger\\.cpp:[0-9]+ .*Test 1");
+  ict::logger::output::syslog_options_t options;
+  ict::logger::output::syslog_stats_t stats;
+  std::vector<std::string> in;
+  int a(0),b(0);
+  struct sockaddr_un addr;
+  std::memset(&addr,0,sizeof(addr));
+  addr.sun_family=AF_UNIX;
+  std::memcpy(addr.sun_path,path.data(),path.size());
+  std::filesystem::remove(path);
+  const int fd(::socket(AF_UNIX,SOCK_DGRAM|SOCK_CLOEXEC,0));
+  if (fd<0) return(1);
+  if (::bind(fd,(const struct sockaddr *)&addr,sizeof(addr))<0) {
+    ::close(fd);
+    return(2);
+  }
+  LOGGER_BASEDIR;
+  LOGGER_THREAD;
+  LOGGER_SET(std::cerr,ict::logger::none);
+  LOGGER_SET(std::cout,ict::logger::none);
+  LOGGER_SET("test",ict::logger::none);
+  #include "enable-all.hpp"
+  options.path=path;
+  LOGGER_SYSLOG("tc16a",ict::logger::all,options);
+  options.format=ict::logger::output::rfc5424;
+  options.facility=16;
+  LOGGER_SYSLOG("tc16b",ict::logger::errors,options);
+  if (LOGGER_TEST_SYSLOG("tc16a")!=ict::logger::all) return(3);
+  if (LOGGER_TEST_SYSLOG("tc16b")!=ict::logger::errors) return(4);
+  if (ict::logger::output::test()!=ict::logger::all) return(5);
+  //Formaty RFC 3164 i RFC 5424.
+  LOGGER_ERR<<__LOGGER__<<"Test "<<1<<std::endl;
+  in=tc16_recv(fd);
+  if (in.size()!=2) return(6);
+  if (!std::regex_match(in.at(0),bsd)||!std::regex_match(in.at(1),ietf)){
+    std::cout<<"line="<<in.at(0)<<std::endl<<"line="<<in.at(1)<<std::endl;
+    return(7);
+  }
+  //Zrzut warstwy - każde wyjście otrzymuje tylko swoje linie (kolejka gniazda mieści domyślnie 10 komunikatów).
+  {
+    LOGGER_LAYER;
+    for (int i=2;i<=6;i++) LOGGER_DEBUG<<__LOGGER__<<"Test "<<i<<std::endl;
+    LOGGER_ERR<<__LOGGER__<<"Test "<<7<<std::endl;
+  }
+  in=tc16_recv(fd);
+  for (const std::string & m: in){
+    if (m.find(" tc16a[")!=std::string::npos) a++;
+    if (m.find(" tc16b ")!=std::string::npos) b++;
+  }
+  if ((a!=6)||(b!=1)) return(8);
+  //Odbiorca nie czyta - komunikaty są odrzucane, a logowanie nie jest blokowane.
+  for (int i=1;i<=10000;i++) LOGGER_INFO<<__LOGGER__<<"Test "<<i<<std::endl;
+  if (LOGGER_TEST_SYSLOG("tc16a",&stats)!=ict::logger::all) return(9);
+  if ((stats.dropped==0)||(stats.sent+stats.dropped!=10007)) return(10);
+  tc16_recv(fd);
+  LOGGER_SYSLOG("tc16a",ict::logger::none);
+  if (LOGGER_TEST_SYSLOG("tc16a")!=ict::logger::none) return(11);
+  LOGGER_SET("test",ict::logger::none);
+  if (LOGGER_TEST_SYSLOG("tc16b")!=ict::logger::none) return(12);
+  ::close(fd);
+  std::filesystem::remove(path);
+  return(0);
+}
+static void tc17_thread(){
+  LOGGER_THREAD;
+  #include "enable-all.hpp"
+  for (int i=0;i<1000;i++) LOGGER_NOTICE<<__LOGGER__<<"Test "<<1000<<std::endl;
+}
+REGISTER_TEST(logger,tc17){
+  std::stringstream stream;
+  std::stringstream other;
+  std::string line;
+  std::vector<std::thread> threads;
+  int k(0);
+  LOGGER_BASEDIR;
+  LOGGER_THREAD;
+  LOGGER_SET(std::cerr,ict::logger::none);
+  LOGGER_SET(std::cout,ict::logger::none);
+  LOGGER_SET("test",ict::logger::none);
+  LOGGER_SET(stream);
+  #include "enable-all.hpp"
+  for (int i=0;i<4;i++) threads.emplace_back(tc17_thread);
+  //Zmiany wyjść w trakcie zapisu - wątki logujące czytają migawki bez muteksu.
+  for (int i=0;i<200;i++){
+    LOGGER_SET(other,(i%2)?ict::logger::none:ict::logger::all);
+    LOGGER_BINARY(other,(i%2)?ict::logger::all:ict::logger::none);
+  }
+  for (std::thread & t: threads) t.join();
+  LOGGER_SET(stream,ict::logger::none);
+  LOGGER_BINARY(other,ict::logger::none);
+  if (LOGGER_TEST(&stream)!=ict::logger::none) return(1);
+  //Linie z różnych wątków nie przeplatają się.
+  while (std::getline(stream,line)){
+    if (!std::regex_match(line,getRegex("NOTICE",1000))){
+      std::cout<<"line="<<line<<std::endl;
+      return(2);
+    }
+    k++;
+  }
+  if (k!=4000) return(3);
+  return(0);
+}
+//! Bufor strumienia liczący opróżnienia.
+class tc18_buffer:public std::stringbuf {
+public:
+  std::atomic<int> syncs{0};
+protected:
+  int sync(){
+    syncs++;
+    return(std::stringbuf::sync());
+  }
+};
+REGISTER_TEST(logger,tc18){
+  const std::filesystem::path path(std::filesystem::temp_directory_path()/("libict-logger-tc18-"+std::to_string(::getpid())+".log"));
+  ict::logger::output::flush_policy_t policy;
+  ict::logger::output::file_options_t options;
+  tc18_buffer buffer;
+  std::ostream stream(&buffer);
+  std::filesystem::remove(path);
+  LOGGER_BASEDIR;
+  LOGGER_THREAD;
+  LOGGER_SET(std::cerr,ict::logger::none);
+  LOGGER_SET(std::cout,ict::logger::none);
+  LOGGER_SET("test",ict::logger::none);
+  #include "enable-all.hpp"
+  //Opróżnianie tylko dla błędów.
+  policy.severity=ict::logger::errors;
+  LOGGER_SET(stream,ict::logger::all,policy);
+  for (int i=1;i<=10;i++) LOGGER_INFO<<__LOGGER__<<"Test "<<i<<std::endl;
+  if (buffer.syncs!=0) return(1);
+  LOGGER_ERR<<__LOGGER__<<"Test "<<11<<std::endl;
+  if (buffer.syncs!=1) return(2);
+  //Opróżnianie co 5 linii.
+  policy.severity=ict::logger::none;
+  policy.lines=5;
+  LOGGER_SET(stream,ict::logger::all,policy);
+  buffer.syncs=0;
+  for (int i=1;i<=12;i++) LOGGER_INFO<<__LOGGER__<<"Test "<<i<<std::endl;
+  if (buffer.syncs!=2) return(3);
+  LOGGER_FLUSH;
+  if (buffer.syncs!=3) return(4);
+  //Opróżnianie przez wątek porządkowy.
+  policy.lines=0;
+  policy.interval=100;
+  LOGGER_SET(stream,ict::logger::all,policy);
+  buffer.syncs=0;
+  LOGGER_INFO<<__LOGGER__<<"Test "<<1<<std::endl;
+  if (buffer.syncs!=0) return(5);
+  for (int i=0;(i<50)&&(buffer.syncs==0);i++) std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  if (buffer.syncs!=1) return(6);
+  //Okres krótszy niż domyślny okres budzenia wątku porządkowego.
+  policy.interval=20;
+  LOGGER_SET(stream,ict::logger::all,policy);
+  buffer.syncs=0;
+  for (int i=1;i<=50;i++){
+    LOGGER_INFO<<__LOGGER__<<"Test "<<i<<std::endl;
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  if (buffer.syncs<8) return(9);
+  LOGGER_SET(stream,ict::logger::none);
+  //Plik - bufor jest zapisywany od razu tylko dla błędów.
+  options.flush_interval=100000;
+  options.flush_severity=ict::logger::errors;
+  LOGGER_FILE(path.native(),ict::logger::all,options);
+  LOGGER_INFO<<__LOGGER__<<"Test "<<1<<std::endl;
+  if (std::filesystem::file_size(path)!=0) return(7);
+  LOGGER_ERR<<__LOGGER__<<"Test "<<2<<std::endl;
+  if (std::filesystem::file_size(path)==0) return(8);
+  LOGGER_FILE(path.native(),ict::logger::none);
+  std::filesystem::remove(path);
+  return(0);
+}
+//! Bufor strumienia, który można czytać w trakcie zapisu przez inny wątek.
+class locked_buffer:public std::stringbuf {
+private:
+  //! Zapis znaków (xsputn) może wywołać overflow.
+  std::recursive_mutex mutex;
+public:
+  std::string text(){
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    return(str());
+  }
+  void clear(){
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    str("");
+  }
+protected:
+  int overflow(int c){
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    return(std::stringbuf::overflow(c));
+  }
+  std::streamsize xsputn(const char * s,std::streamsize n){
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    return(std::stringbuf::xsputn(s,n));
+  }
+};
+REGISTER_TEST(logger,tc19){
+  std::stringstream stream;
+  std::stringstream metrics;
+  locked_buffer buffer;
+  std::ostream periodic(&buffer);
+  ict::logger::stats_t before,after;
+  LOGGER_BASEDIR;
+  LOGGER_THREAD;
+  LOGGER_SET(std::cerr,ict::logger::none);
+  LOGGER_SET(std::cout,ict::logger::none);
+  LOGGER_SET("test",ict::logger::none);
+  LOGGER_SET(stream);
+  #include "enable-all.hpp"
+  before=LOGGER_STATS;
+  {
+    LOGGER_L(ict::logger::notices,ict::logger::nonotices,ict::logger::errors);
+    for (int i=1;i<=10;i++) LOGGER_DEBUG<<__LOGGER__<<"Test "<<i<<std::endl;
+    {
+      LOGGER_LAYER;//Warstwa bez zrzutu.
+      for (int i=1;i<=5;i++) LOGGER_INFO<<__LOGGER__<<"Test "<<i<<std::endl;
+    }
+    LOGGER_NOTICE<<__LOGGER__<<"Test "<<11<<std::endl;
+    LOGGER_ERR<<__LOGGER__<<"Test "<<12<<std::endl;
+  }
+  {
+    LOGGER_L(ict::logger::notices,ict::logger::nonotices,ict::logger::errors,1024);//Mały budżet.
+    for (int i=1;i<=100;i++) LOGGER_DEBUG<<__LOGGER__<<"Test "<<i<<std::endl;
+    LOGGER_CRIT<<__LOGGER__<<"Test "<<101<<std::endl;
+  }
+  after=LOGGER_STATS;
+  const uint64_t lines[6]={1,1,0,1,5,110};
+  for (int k=0;k<6;k++) if ((after.lines[k]-before.lines[k])!=lines[k]) {
+    std::cout<<"k="<<k<<" lines="<<(after.lines[k]-before.lines[k])<<std::endl;
+    return(1);
+  }
+  if ((after.buffered-before.buffered)!=115) return(2);
+  if ((after.discarded-before.discarded)!=5) return(3);
+  if ((after.dumps-before.dumps)!=2) return(4);
+  if ((after.overwritten-before.overwritten)==0) return(5);
+  if ((after.dumped-before.dumped)!=(10+100-(after.overwritten-before.overwritten))) return(6);
+  if (after.write.count<=before.write.count) return(7);
+  if (after.lock_wait.count<=before.lock_wait.count) return(8);
+  if (after.write.sum<=before.write.sum) return(9);
+  //Pomiar czasu zapisu można wyłączyć.
+  ict::logger::output::setTiming(false);
+  before=LOGGER_STATS;
+  LOGGER_NOTICE<<__LOGGER__<<"Test "<<102<<std::endl;
+  after=LOGGER_STATS;
+  ict::logger::output::setTiming(true);
+  if ((after.write.count!=before.write.count)||(after.lock_wait.count!=before.lock_wait.count)) return(12);
+  //Format tekstowy Prometheus.
+  LOGGER_SET(stream,ict::logger::none);
+  ict::logger::output::writeStats(metrics);
+  for (const char * name: {
+    "ict_logger_lines_total{severity=\"debug\"} ",
+    "ict_logger_dumped_lines_total ",
+    "ict_logger_overwritten_lines_total ",
+    "ict_logger_lock_wait_seconds_bucket{le=\"+Inf\"} ",
+    "ict_logger_write_seconds_count "
+  }) if (metrics.str().find(name)==std::string::npos) {
+    std::cout<<"name="<<name<<std::endl;
+    return(10);
+  }
+  //Okresowy zapis statystyk jako linii loga.
+  LOGGER_SET(periodic);
+  ict::logger::output::setStats(100,ict::logger::notice);
+  for (int i=0;(i<50)&&(buffer.text().find("logger stats: ")==std::string::npos);i++) std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  ict::logger::output::setStats(0);
+  LOGGER_SET(periodic,ict::logger::none);
+  if (buffer.text().find(" NOTICE logger stats: lines=")==std::string::npos) {
+    std::cout<<"stream="<<buffer.text()<<std::endl;
+    return(11);
+  }
+  return(0);
+}
+//! Liczba wyliczeń argumentów linii.
+static int tc20_calls=0;
+static int tc20_arg(){
+  return(++tc20_calls);
+}
+REGISTER_TEST(logger,tc20){
+  std::stringstream stream;
+  std::string line;
+  int lines(0),suppressed(0),summaries(0);
+  LOGGER_BASEDIR;
+  LOGGER_THREAD;
+  LOGGER_SET(std::cerr,ict::logger::none);
+  LOGGER_SET(std::cout,ict::logger::none);
+  LOGGER_SET("test",ict::logger::none);
+  LOGGER_SET(stream);
+  #include "enable-all.hpp"
+  //Co n-te wywołanie - pozostałe nie wyliczają argumentów.
+  for (int i=0;i<100;i++) LOGGER_INFO_EVERY_N(10)<<__LOGGER__<<"Test "<<tc20_arg()<<std::endl;
+  if (tc20_calls!=10) return(1);
+  //Tylko pierwsze wywołania.
+  tc20_calls=0;
+  for (int i=0;i<100;i++) LOGGER_WARN_FIRST_N(5)<<__LOGGER__<<"Test "<<tc20_arg()<<std::endl;
+  if (tc20_calls!=5) return(2);
+  //Limit linii na sekundę.
+  tc20_calls=0;
+  for (int k=0;k<2;k++){//To samo miejsce w kodzie w kolejnych sekundach.
+    if (k) std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    for (int i=0;i<100;i++) LOGGER_ERR_RATE(5)<<__LOGGER__<<"Test "<<tc20_arg()<<std::endl;
+    if ((tc20_calls<(5*(k+1)))||((10*(k+1))<tc20_calls)) return(3);//Mogła zacząć się kolejna sekunda.
+  }
+  LOGGER_FLUSH;//Zgłasza linie pominięte w ostatnim oknie.
+  LOGGER_SET(stream,ict::logger::none);
+  while (std::getline(stream,line)){
+    std::size_t k(line.find("pominięto linie: "));
+    if (k!=std::string::npos){
+      if (line.find(" ERROR ")==std::string::npos) return(4);
+      suppressed+=std::stoi(line.substr(k+std::strlen("pominięto linie: ")));
+      summaries++;
+    } else if (line.find(" ERROR ")!=std::string::npos) lines++;
+  }
+  if (lines!=tc20_calls) return(5);
+  if (summaries==0) return(6);
+  if ((lines+suppressed)!=200) return(7);
+  //Pominięte linie są zgłaszane po zakończeniu okna także bez kolejnych wywołań.
+  locked_buffer buffer;
+  std::ostream late(&buffer);
+  LOGGER_SET(late);
+  for (int i=0;i<100;i++) LOGGER_NOTICE_RATE(1)<<__LOGGER__<<"Test"<<std::endl;
+  for (int i=0;(i<150)&&(buffer.text().find("pominięto linie: ")==std::string::npos);i++) std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  LOGGER_SET(late,ict::logger::none);
+  if (buffer.text().find(" NOTICE ")==std::string::npos) return(8);
+  if (buffer.text().find("Ograniczenie liczby linii (pominięto linie: ")==std::string::npos) return(10);
+  //Poziom wyłączony w czasie kompilacji.
+  tc20_calls=0;
+  #include "disable-debug.hpp"
+  LOGGER_DEBUG_EVERY_N(1)<<__LOGGER__<<"Test "<<tc20_arg()<<std::endl;
+  LOGGER_DEBUG_RATE(1)<<__LOGGER__<<"Test "<<tc20_arg()<<std::endl;
+  #include "enable-debug.hpp"
+  if (tc20_calls!=0) return(9);
+  return(0);
+}
+static void tc21_thread(){
+  LOGGER_THREAD;
+  for (int i=0;i<100;i++) LOGGER_ERR<<__LOGGER__<<"Test "<<1<<std::endl;
+}
+//Podaje liczbę linii z zadanym tekstem i sumę pominiętych powtórzeń.
+static int tc21_count(const std::string & text,const std::string & test,int & suppressed){
+  std::istringstream in(text);
+  std::string line;
+  int k(0);
+  suppressed=0;
+  while (std::getline(in,line)){
+    std::size_t p(line.find("pominięto linie: "));
+    if (line.find(test)==std::string::npos) continue;
+    if (p!=std::string::npos) suppressed+=std::stoi(line.substr(p+std::strlen("pominięto linie: ")));
+    else k++;
   }
-//===========================================
-} }
-//===========================================
-#ifdef ENABLE_TESTING
-#include "test.hpp"
-#include <sstream>
-#include <regex>
-
-REGISTER_TEST(logger,tc1){
+  return(k);
+}
+REGISTER_TEST(logger,tc21){
+  locked_buffer buffer;
+  std::ostream stream(&buffer);
+  std::vector<std::thread> threads;
+  ict::logger::stats_t before(LOGGER_STATS);
+  int suppressed;
   LOGGER_BASEDIR;
   LOGGER_THREAD;
-  LOGGER_SET(std::cerr);
-  LOGGER_SET(std::cout);
-  LOGGER_SET("test");
+  LOGGER_SET(std::cerr,ict::logger::none);
+  LOGGER_SET(std::cout,ict::logger::none);
+  LOGGER_SET("test",ict::logger::none);
+  LOGGER_SET(stream);
   #include "enable-all.hpp"
-  LOGGER_CRIT<<__LOGGER__<<"Test string > string ... "<<0<<" "<<ict::test::test_string[0]<<std::endl;
-  LOGGER_ERR<<__LOGGER__<<"Test string > string ... "<<1<<" "<<ict::test::test_string[1]<<std::endl;
-  LOGGER_WARN<<__LOGGER__<<"Test string > string ... "<<2<<" "<<ict::test::test_string[2]<<std::endl;
-  LOGGER_NOTICE<<__LOGGER__<<"Test string > string ... "<<3<<" "<<ict::test::test_string[3]<<std::endl;
-  LOGGER_INFO<<__LOGGER__<<"Test string > string ... "<<4<<" "<<ict::test::test_string[4]<<std::endl;
-  LOGGER_DEBUG<<__LOGGER__<<"Test string > string ... "<<5<<" "<<ict::test::test_string[5]<<std::endl;
-  #include "disable-all.hpp"
-  LOGGER_CRIT<<__LOGGER__<<"Test string > string ... "<<6<<" "<<ict::test::test_string[6]<<std::endl;
-  LOGGER_ERR<<__LOGGER__<<"Test string > string ... "<<7<<" "<<ict::test::test_string[7]<<std::endl;
-  LOGGER_WARN<<__LOGGER__<<"Test string > string ... "<<8<<" "<<ict::test::test_string[8]<<std::endl;
-  LOGGER_NOTICE<<__LOGGER__<<"Test string > string ... "<<9<<" "<<ict::test::test_string[9]<<std::endl;
-  LOGGER_INFO<<__LOGGER__<<"Test string > string ... "<<10<<" "<<ict::test::test_string[10]<<std::endl;
-  LOGGER_DEBUG<<__LOGGER__<<"Test string > string ... "<<11<<" "<<ict::test::test_string[11]<<std::endl;
+  LOGGER_DEDUP(10000);
+  //Powtórzenia z jednego wątku.
+  for (int i=0;i<100;i++) {
+    LOGGER_WARN<<__LOGGER__<<"Test "<<1<<std::endl;
+    LOGGER_WARN<<__LOGGER__<<"Test "<<2<<std::endl;
+  }
+  LOGGER_FLUSH;
+  if (tc21_count(buffer.text(),"Test 1",suppressed)!=1) return(1);
+  if (suppressed!=99) return(2);
+  if (tc21_count(buffer.text(),"Test 2",suppressed)!=1) return(3);
+  if (suppressed!=99) return(4);
+  //Powtórzenia z wielu wątków.
+  buffer.clear();
+  for (int i=0;i<4;i++) threads.emplace_back(tc21_thread);
+  for (std::thread & t: threads) t.join();
+  LOGGER_FLUSH;
+  if (tc21_count(buffer.text(),"Test 1",suppressed)!=1) return(5);
+  if (suppressed!=399) return(6);
+  if (buffer.text().find(" ERROR ")==std::string::npos) return(7);
+  //Koniec okna (wątek porządkowy).
+  buffer.clear();
+  LOGGER_DEDUP(100);
+  for (int i=0;i<10;i++) LOGGER_INFO<<__LOGGER__<<"Test "<<3<<std::endl;
+  for (int i=0;(i<50)&&(buffer.text().find("pominięto linie: ")==std::string::npos);i++) std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  if (tc21_count(buffer.text(),"Test 3",suppressed)!=1) return(8);
+  if (suppressed!=9) return(9);
+  //Po wyłączeniu wszystkie linie są zapisywane.
+  buffer.clear();
+  LOGGER_DEDUP(0);
+  for (int i=0;i<10;i++) LOGGER_INFO<<__LOGGER__<<"Test "<<4<<std::endl;
+  if (tc21_count(buffer.text(),"Test 4",suppressed)!=10) return(10);
+  if ((LOGGER_STATS.repeated-before.repeated)!=(99+99+399+9)) return(11);
+  LOGGER_SET(stream,ict::logger::none);
+  return(0);
+}
+//! Liczba wyliczeń argumentów linii strukturalnej.
+static int tc22_calls=0;
+static int tc22_arg(){
+  return(++tc22_calls);
+}
+REGISTER_TEST(logger,tc22){
+  const std::filesystem::path path(std::filesystem::temp_directory_path()/("libict-logger-tc22-"+std::to_string(::getpid())+".log"));
+  const std::string special("0123456789012345678901234567890123456789\"\\\n\x01");
+  ict::logger::output::file_options_t options;
+  std::stringstream text;
+  std::stringstream json;
+  std::string line;
+  std::filesystem::remove(path);
+  LOGGER_BASEDIR;
+  LOGGER_THREAD;
+  LOGGER_SET(std::cerr,ict::logger::none);
+  LOGGER_SET(std::cout,ict::logger::none);
+  LOGGER_SET("test",ict::logger::none);
+  LOGGER_SET(text);
+  LOGGER_JSON(json);
+  options.json=true;
+  LOGGER_FILE(path.native(),ict::logger::all,options);
+  if (LOGGER_TEST_JSON(&json)!=ict::logger::all) return(1);
   #include "enable-all.hpp"
+  LOGGER_INFO_KV("Connected","host",std::string_view("db1:5432",3),"port",5432,"ok",true,"ratio",0.5,"note",std::string("a b"));
+  LOGGER_WARN_KV("Line\tbreak","delta",int64_t(-7),"max",uint64_t(18446744073709551615ull),"special",special);
+  LOGGER_NOTICE<<__LOGGER__<<"Test "<<1<<std::endl;
   {
-    LOGGER_LAYER;
-    LOGGER_CRIT<<__LOGGER__<<"Test string > string ... "<<12<<" "<<ict::test::test_string[12]<<std::endl;
-    LOGGER_ERR<<__LOGGER__<<"Test string > string ... "<<13<<" "<<ict::test::test_string[13]<<std::endl;
-    LOGGER_WARN<<__LOGGER__<<"Test string > string ... "<<14<<" "<<ict::test::test_string[14]<<std::endl;
-    LOGGER_NOTICE<<__LOGGER__<<"Test string > string ... "<<15<<" "<<ict::test::test_string[15]<<std::endl;
-    LOGGER_INFO<<__LOGGER__<<"Test string > string ... "<<16<<" "<<ict::test::test_string[16]<<std::endl;
-    LOGGER_DEBUG<<__LOGGER__<<"Test string > string ... "<<17<<" "<<ict::test::test_string[17]<<std::endl;
+    LOGGER_L(ict::logger::notices,ict::logger::nonotices,ict::logger::errors);
+    LOGGER_DEBUG_KV("Buffered","id",42);
+    LOGGER_ERR<<__LOGGER__<<"Test "<<2<<std::endl;
+  }
+  {
+    LOGGER_L(ict::logger::notices,ict::logger::none,ict::logger::none);
+    LOGGER_DEBUG_KV("Inactive","n",tc22_arg());//Argumenty nie są wyliczane.
+  }
+  LOGGER_SET(text,ict::logger::none);
+  LOGGER_JSON(json,ict::logger::none);
+  LOGGER_FILE(path.native(),ict::logger::none);
+  if (tc22_calls!=0) return(2);
+  //Wyjście tekstowe - pola po treści linii.
+  if (!std::getline(text,line)) return(3);
+  if (!std::regex_match(line,std::regex("^\\d{4}-\\d{2}-\\d{2} \\d{2}:\\d{2}:\\d{2}\\([\\+\\-]\\d{4}\\) INFO logger\\.cpp:\\d+ \\(int test_tc22\\(\\)\\) Connected host=db1 port=5432 ok=true ratio=0\\.5 note=\"a b\"$"))){
+    std::cout<<"line="<<line<<std::endl;
+    return(4);
+  }
+  if (!std::getline(text,line)) return(5);
+  if (line.find(" WARNING logger.cpp:")==std::string::npos) return(6);
+  if (line.find(") Line break delta=-7 max=18446744073709551615 special=\"0123456789012345678901234567890123456789\\\"\\\\\\n\\u0001\"")==std::string::npos){
+    std::cout<<"line="<<line<<std::endl;
+    return(7);
   }
+  //Wyjście JSON Lines.
+  const std::string prefix("^\\{\"time\":\"\\d{4}-\\d{2}-\\d{2} \\d{2}:\\d{2}:\\d{2}\\([\\+\\-]\\d{4}\\)\",");
+  const std::string site("\"file\":\"logger\\.cpp\",\"line\":\\d+,\"function\":\"int test_tc22\\(\\)\",");
+  const std::vector<std::string> expected({
+    prefix+"\"severity\":\"INFO\","+site+"\"msg\":\"Connected\",\"host\":\"db1\",\"port\":5432,\"ok\":true,\"ratio\":0\\.5,\"note\":\"a b\"\\}$",
+    prefix+"\"severity\":\"WARNING\","+site+"\"msg\":\"Line break\",\"delta\":-7,\"max\":18446744073709551615,\"special\":\"0123456789012345678901234567890123456789\\\\\"\\\\\\\\\\\\n\\\\u0001\"\\}$",
+    prefix+"\"severity\":\"NOTICE\","+site+"\"msg\":\"Test 1\"\\}$",
+    prefix+"\"severity\":\"ERROR\","+site+"\"msg\":\"Test 2\"\\}$",
+    prefix+"\"severity\":\"DEBUG\",\"buffered\":true,"+site+"\"msg\":\"Buffered id=42\"\\}$"
+  });
+  for (std::stringstream * in: {&json,(std::stringstream *)nullptr}){
+    std::ifstream file(path);
+    std::istream & lines(in?(std::istream &)*in:(std::istream &)file);
+    for (const std::string & e: expected){
+      if (!std::getline(lines,line)) return(8);
+      if (!std::regex_match(line,std::regex(e))){
+        std::cout<<"line="<<line<<std::endl;
+        return(in?9:10);
+      }
+    }
+    if (std::getline(lines,line)) return(11);
+  }
+  std::filesystem::remove(path);
   return(0);
 }
-
-static std::regex getRegex(const std::string &sev,int no,bool b=false){
-  std::string tmp(b?"\\| ":"");
-  return std::regex(
-    "\\d{4}-\\d{2}-\\d{2} \\d{2}:\\d{2}:\\d{2}\\(\\+\\d{4}\\) "
-    +tmp
-    +sev
-    +" logger\\.cpp:\\d+ "
-    +".*"
-    +"\\(\\)\\) Test "
-    +std::to_string(no)
-    +".*"
-  );
+static int tc23_calls=0;
+static int tc23_arg(){
+  return(++tc23_calls);
 }
-
-REGISTER_TEST(logger,tc2){
-  std::stringstream stream;
+REGISTER_TEST(logger,tc23){
+  locked_buffer text;
+  std::ostream out(&text);
   std::string line;
   LOGGER_BASEDIR;
   LOGGER_THREAD;
   LOGGER_SET(std::cerr,ict::logger::none);
   LOGGER_SET(std::cout,ict::logger::none);
   LOGGER_SET("test",ict::logger::none);
-  LOGGER_SET(stream);
+  LOGGER_SET(out);
   #include "enable-all.hpp"
-  LOGGER_CRIT<<__LOGGER__<<"Test "<<1<<std::endl;
-  LOGGER_ERR<<__LOGGER__<<"Test "<<2<<std::endl;
-  LOGGER_WARN<<__LOGGER__<<"Test "<<3<<std::endl;
-  LOGGER_NOTICE<<__LOGGER__<<"Test "<<4<<std::endl;
-  LOGGER_INFO<<__LOGGER__<<"Test "<<5<<std::endl;
-  LOGGER_DEBUG<<__LOGGER__<<"Test "<<6<<std::endl;
-  #include "disable-all.hpp"
-  LOGGER_CRIT<<__LOGGER__<<"Test "<<7<<std::endl;
-  LOGGER_ERR<<__LOGGER__<<"Test "<<8<<std::endl;
-  LOGGER_WARN<<__LOGGER__<<"Test "<<9<<std::endl;
-  LOGGER_NOTICE<<__LOGGER__<<"Test "<<10<<std::endl;
-  LOGGER_INFO<<__LOGGER__<<"Test "<<11<<std::endl;
-  LOGGER_DEBUG<<__LOGGER__<<"Test "<<12<<std::endl;
-  if (std::getline(stream,line)){
-    if (!std::regex_match(line,getRegex("CRITICAL",1))){
-      std::cout<<"line="<<line<<std::endl;
-      return(1); 
-    }
-  } else return(101);
-  if (std::getline(stream,line)){
-    if (!std::regex_match(line,getRegex("ERROR",2))){
+  LOGGER_INFO_F("user={} took {}us",7,uint64_t(125));
+  LOGGER_INFO<<__LOGGER__<<"user="<<7<<" took "<<125<<"us"<<std::endl;
+  LOGGER_WARN_F("{}|{}|{}|{}|{}|{}",int64_t(-42),0.25,true,'c',std::string("a\nb"),std::string_view("view"));
+  LOGGER_NOTICE_F("{{}} {{{}}}",1);
+  LOGGER_ERR_F("No arguments");
+  {
+    LOGGER_L(ict::logger::notices,ict::logger::nonotices,ict::logger::errors);
+    LOGGER_DEBUG_F("Buffered {}",42);
+    LOGGER_ERR_F("Dump {}",2);
+  }
+  {
+    LOGGER_L(ict::logger::notices,ict::logger::none,ict::logger::none);
+    LOGGER_DEBUG_F("Inactive {}",tc23_arg());//Argumenty nie są wyliczane.
+  }
+  LOGGER_SET(out,ict::logger::none);
+  if (tc23_calls!=0) return(1);
+  const std::string prefix("^\\d{4}-\\d{2}-\\d{2} \\d{2}:\\d{2}:\\d{2}\\([\\+\\-]\\d{4}\\) ");
+  const std::string site("logger\\.cpp:\\d+ \\(int test_tc23\\(\\)\\) ");
+  const std::vector<std::string> expected({
+    prefix+"INFO "+site+"user=7 took 125us$",
+    prefix+"INFO "+site+"user=7 took 125us$",
+    prefix+"WARNING "+site+"-42\\|0\\.25\\|true\\|c\\|a b\\|view$",
+    prefix+"NOTICE "+site+"\\{\\} \\{1\\}$",
+    prefix+"ERROR "+site+"No arguments$",
+    prefix+"ERROR "+site+"Dump 2$",
+    prefix+"\\| DEBUG "+site+"Buffered 42$"
+  });
+  std::istringstream lines(text.text());
+  for (const std::string & e: expected){
+    if (!std::getline(lines,line)) return(2);
+    if (!std::regex_match(line,std::regex(e))){
       std::cout<<"line="<<line<<std::endl;
-      return(2); 
+      return(3);
     }
-  } else return(102);
-  if (std::getline(stream,line)){
-    if (!std::regex_match(line,getRegex("WARNING",3))){
-      std::cout<<"line="<<line<<std::endl;
-      return(3); 
+  }
+  if (std::getline(lines,line)) return(4);
+  return(0);
+}
+REGISTER_TEST(logger,tc24){
+#ifdef LOGGER_ZLIB
+  const std::filesystem::path dir(std::filesystem::temp_directory_path()/("libict-logger-tc24-"+std::to_string(::getpid())));
+  const std::filesystem::path path(dir/"app.log");
+  const std::filesystem::path old(dir/"old.log");
+  const uint64_t compressed(ict::logger::stats().compressed);
+  ict::logger::output::file_options_t options;
+  std::vector<std::string> files;
+  std::string line;
+  int k(1);
+  auto pending=[](const std::vector<std::string> & files){
+    for (const std::string & f: files) if (f.compare(f.size()-3,3,".gz")!=0) return(true);
+    return(false);
+  };
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+  //Plik po rotacji pozostawiony przez poprzednie uruchomienie.
+  std::ofstream(old.native()+".20000101-000000")<<"Old"<<std::endl;
+  LOGGER_BASEDIR;
+  LOGGER_THREAD;
+  LOGGER_SET(std::cerr,ict::logger::none);
+  LOGGER_SET(std::cout,ict::logger::none);
+  LOGGER_SET("test",ict::logger::none);
+  #include "enable-all.hpp"
+  options.buffer=100;
+  options.max_size=400;
+  options.compress=1;
+  LOGGER_FILE(path.native(),ict::logger::all,options);
+  LOGGER_FILE(old.native(),ict::logger::critical,options);
+  for (int i=1;i<=30;i++) LOGGER_INFO<<__LOGGER__<<"Test "<<i<<std::endl;
+  LOGGER_FLUSH;
+  for (int i=0;(pending(tc12_files(path))||pending(tc12_files(old)))&&(i<100);i++) std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  LOGGER_FILE(path.native(),ict::logger::none);
+  LOGGER_FILE(old.native(),ict::logger::none);
+  files=tc12_files(path);
+  if (files.size()<3) return(1);
+  if (pending(files)) return(2);//Wszystkie pliki po rotacji są skompresowane.
+  std::sort(files.begin(),files.end(),[](const std::string & a,const std::string & b){//Kolejność nazw bez rozszerzenia.
+    return(a.substr(0,a.size()-3)<b.substr(0,b.size()-3));
+  });
+  for (const std::string & f: files){
+    char buffer[4096];
+    std::string text;
+    gzFile in(::gzopen(f.c_str(),"rb"));
+    if (!in) return(3);
+    for (int n;0<(n=::gzread(in,buffer,sizeof(buffer)));) text.append(buffer,n);
+    ::gzclose(in);
+    std::istringstream lines(text);
+    while (std::getline(lines,line)){
+      if (!std::regex_match(line,getRegex("INFO",k))){
+        std::cout<<"file="<<f<<" line="<<line<<std::endl;
+        return(4);
+      }
+      k++;
     }
-  } else return(103);
-  if (std::getline(stream,line)){
-    if (!std::regex_match(line,getRegex("NOTICE",4))){
-      std::cout<<"line="<<line<<std::endl;
-      return(4); 
+  }
+  std::ifstream in(path);
+  while (std::getline(in,line)) k++;
+  if (k!=31) return(5);
+  files=tc12_files(old);
+  if ((files.size()!=1)||pending(files)) return(6);//Kompresja pozostawionego pliku.
+  if (ict::logger::stats().compressed<(compressed+4)) return(7);
+  std::filesystem::remove_all(dir);
+#else
+  const std::filesystem::path path(std::filesystem::temp_directory_path()/("libict-logger-tc24-"+std::to_string(::getpid())+".log"));
+  ict::logger::output::file_options_t options;
+  options.compress=6;
+  LOGGER_FILE(path.native(),ict::logger::all,options);//Bez biblioteki zlib plik z kompresją jest odrzucany.
+  if (LOGGER_TEST_FILE(path.native())!=ict::logger::none) return(8);
+  std::filesystem::remove(path);
+#endif
+  return(0);
+}
+REGISTER_TEST(logger,tc25){
+  locked_buffer text;
+  std::ostream out(&text);
+  std::vector<std::string> lines[2];
+  std::string line;
+  LOGGER_BASEDIR;
+  LOGGER_THREAD;
+  LOGGER_SET(std::cerr,ict::logger::none);
+  LOGGER_SET(std::cout,ict::logger::none);
+  LOGGER_SET("test",ict::logger::none);
+  LOGGER_SET(out);
+  #include "enable-all.hpp"
+  for (int k=0;k<2;k++){//Linie odroczone i formatowane od razu muszą dać ten sam tekst.
+    LOGGER_DEFERRED(k==0);
+    text.clear();
+    {
+      LOGGER_L(ict::logger::notices,ict::logger::nonotices,ict::logger::errors);
+      {
+        std::string temp("a\tb\nc");
+        LOGGER_DEBUG_F("{} {} {} {} {} {} {} {} {{{}}}",int8_t(-8),uint16_t(65535),-1234567890123ll,1.5f,0.1,(long double)(0.25),true,'x',temp);
+        temp="changed";//Linia odroczona przechowuje kopię tekstu.
+      }
+      LOGGER_INFO_F("{}|{}|{}",std::string_view("view"),"literal",(const char *)nullptr);
+      LOGGER_DEBUG_F("No arguments");
+      LOGGER_ERR<<__LOGGER__<<"Dump"<<std::endl;
     }
-  } else return(104);
-  if (std::getline(stream,line)){
-    if (!std::regex_match(line,getRegex("INFO",5))){
-      std::cout<<"line="<<line<<std::endl;
-      return(5); 
+    {
+      LOGGER_L(ict::logger::notices,ict::logger::nonotices,ict::logger::errors,256);
+      LOGGER_DEBUG_F("Long {}",std::string(1000,'y'));//Nie mieści się w budżecie warstwy.
+      LOGGER_ERR<<__LOGGER__<<"Dump"<<std::endl;
     }
-  } else return(105);
-  if (std::getline(stream,line)){
-    if (!std::regex_match(line,getRegex("DEBUG",6))){
-      std::cout<<"line="<<line<<std::endl;
-      return(6); 
+    {
+      LOGGER_L(ict::logger::notices,ict::logger::nonotices,ict::logger::errors);
+      LOGGER_DEBUG_F("Discarded {}",1);
     }
-  } else return(106);
-  if (std::getline(stream,line)){
-    return(200);
+    std::istringstream in(text.text());
+    while (std::getline(in,line)) lines[k].push_back(line.substr(line.find(") ")));//Bez czasu.
+  }
+  LOGGER_DEFERRED(true);
+  LOGGER_SET(out,ict::logger::none);
+  if (lines[0]!=lines[1]) {
+    for (int k=0;k<2;k++) for (const std::string & l: lines[k]) std::cout<<k<<": "<<l<<std::endl;
+    return(1);
   }
+  if (lines[0].size()!=6) return(2);
+  if (lines[0][1]!=") | DEBUG logger.cpp:"+lines[0][1].substr(21,lines[0][1].find(' ',21)-21)+" (int test_tc25()) -8 65535 -1234567890123 1.5 0.1 0.25 true x {a b c}") {
+    std::cout<<lines[0][1]<<std::endl;
+    return(3);
+  }
+  if (lines[0][2].find(" view|literal|")==std::string::npos) return(4);
+  if (lines[0][3].find(" No arguments")==std::string::npos) return(5);
+  if ((lines[0][5].find(" Long yyy")==std::string::npos)||(256<lines[0][5].size())) return(6);
   return(0);
 }
-REGISTER_TEST(logger,tc3){
-  std::stringstream stream;
+//! Strumień, który wstrzymuje zapis, dopóki nie zostanie otwarty (wolne wyjście).
+class gated_buffer:public std::stringbuf {
+private:
+  //! Zapis znaków (xsputn) może wywołać overflow.
+  std::recursive_mutex mutex;
+  std::condition_variable_any wake;
+  bool opened=false;
+  //! Liczba wstrzymanych zapisów.
+  std::atomic<int> waiting{0};
+  void wait(std::unique_lock<std::recursive_mutex> & lock){
+    waiting++;
+    wake.wait(lock,[this]{return(opened);});
+    waiting--;
+  }
+public:
+  std::string text(){
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    return(str());
+  }
+  void open(){
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    opened=true;
+    wake.notify_all();
+  }
+  //! Czeka, aż zapis zostanie wstrzymany.
+  void blocked(){
+    while (!waiting.load()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+protected:
+  int overflow(int c){
+    std::unique_lock<std::recursive_mutex> lock(mutex);
+    wait(lock);
+    return(std::stringbuf::overflow(c));
+  }
+  std::streamsize xsputn(const char * s,std::streamsize n){
+    std::unique_lock<std::recursive_mutex> lock(mutex);
+    wait(lock);
+    return(std::stringbuf::xsputn(s,n));
+  }
+};
+REGISTER_TEST(logger,tc26){
+  gated_buffer slow;
+  std::ostream slow_out(&slow);
+  std::stringstream fast;
+  std::stringstream json;
+  std::stringstream metrics;
+  ict::logger::output::flush_policy_t policy;
+  std::vector<ict::logger::output::queue_stats_t> queues;
   std::string line;
+  int k(0);
   LOGGER_BASEDIR;
   LOGGER_THREAD;
   LOGGER_SET(std::cerr,ict::logger::none);
   LOGGER_SET(std::cout,ict::logger::none);
   LOGGER_SET("test",ict::logger::none);
-  LOGGER_SET(stream);
   #include "enable-all.hpp"
+  policy.queue=8;
+  LOGGER_SET(slow_out,ict::logger::all,policy);
+  LOGGER_SET(fast);
+  LOGGER_JSON(json,ict::logger::all,policy);
+  //Wolny strumień nie wstrzymuje wątku ani szybkiego strumienia.
+  for (int i=1;i<=5;i++) LOGGER_INFO<<__LOGGER__<<"Test "<<i<<std::endl;
   {
-    LOGGER_LAYER;
-    LOGGER_CRIT<<__LOGGER__<<"Test "<<1<<std::endl;
-    LOGGER_ERR<<__LOGGER__<<"Test "<<2<<std::endl;
-    LOGGER_WARN<<__LOGGER__<<"Test "<<3<<std::endl;
-    LOGGER_NOTICE<<__LOGGER__<<"Test "<<4<<std::endl;
-    LOGGER_INFO<<__LOGGER__<<"Test "<<5<<std::endl;
-    LOGGER_DEBUG<<__LOGGER__<<"Test "<<6<<std::endl;
+    LOGGER_L(ict::logger::notices,ict::logger::nonotices,ict::logger::errors);
+    LOGGER_DEBUG<<__LOGGER__<<"Test 6"<<std::endl;
+    LOGGER_ERR<<__LOGGER__<<"Test 7"<<std::endl;//Zrzut - jeden element kolejki.
   }
-  if (std::getline(stream,line)){
-    if (!std::regex_match(line,getRegex("CRITICAL",1))){
-      std::cout<<"line="<<line<<std::endl;
-      return(1); 
-    }
-  } else return(101);
-  if (std::getline(stream,line)){
-    if (!std::regex_match(line,getRegex("ERROR",2))){
-      std::cout<<"line="<<line<<std::endl;
-      return(2); 
-    }
-  } else return(102);
-  if (std::getline(stream,line)){
-    if (!std::regex_match(line,getRegex("WARNING",3))){
-      std::cout<<"line="<<line<<std::endl;
-      return(3); 
-    }
-  } else return(103);
-  if (std::getline(stream,line)){
-    if (!std::regex_match(line,getRegex("NOTICE",4))){
-      std::cout<<"line="<<line<<std::endl;
-      return(4); 
+  while (std::getline(fast,line)) k++;
+  if (k!=7) return(1);
+  const std::string first(fast.str());
+  if (slow.text().size()) return(2);
+  queues=ict::logger::output::queueStats();
+  if (queues.size()!=2) return(3);
+  if ((queues[0].depth!=7)||(queues[0].capacity!=8)||queues[0].lines||!queues[0].lag) return(4);
+  if (queues[0].output.compare(0,5,"text:")!=0) return(5);
+  ict::logger::output::writeStats(metrics);
+  if (metrics.str().find("ict_logger_queue_depth{output=\""+queues[0].output+"\"} 7\n")==std::string::npos) return(6);
+  //Pełna kolejka wstrzymuje wątek, który loguje.
+  std::thread writer([]{
+    LOGGER_THREAD;
+    for (int i=8;i<=10;i++) LOGGER_INFO<<__LOGGER__<<"Test "<<i<<std::endl;
+  });
+  for (int i=0;(ict::logger::output::queueStats()[0].full==0)&&(i<1000);i++) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  if (ict::logger::output::queueStats()[0].full==0) return(7);
+  slow.open();
+  writer.join();
+  LOGGER_FLUSH;
+  queues=ict::logger::output::queueStats();
+  if (queues[0].depth||(queues[0].lines!=10)||queues[0].lag) return(8);
+  if ((queues[1].output.compare(0,5,"json:")!=0)||(queues[1].lines!=10)) return(9);
+  //Usunięcie strumienia zapisuje linie z kolejki.
+  LOGGER_INFO<<__LOGGER__<<"Test 11"<<std::endl;
+  LOGGER_SET(slow_out,ict::logger::none);
+  LOGGER_SET(fast,ict::logger::none);
+  LOGGER_JSON(json,ict::logger::none);
+  if (ict::logger::output::queueStats().size()) return(10);
+  k=0;
+  for (int i=1;std::getline(json,line);i++){//Linie zrzutu mogą trafić po linii, która go spowodowała.
+    for (int j=1;j<=11;j++) if (line.find("\"msg\":\"Test "+std::to_string(j)+"\"")!=std::string::npos) k|=1<<j;
+    if ((7<i)&&(line.find("\"msg\":\"Test "+std::to_string(i)+"\"")==std::string::npos)) return(11);
+  }
+  if (k!=0xffe) return(12);
+  //Wolny strumień otrzymuje te same linie (w tej samej kolejności).
+  if (slow.text().compare(0,first.size(),first)!=0) return(13);
+  std::istringstream in(slow.text().substr(first.size()));
+  k=7;
+  while (std::getline(in,line)){
+    k++;
+    if (line.find(" Test "+std::to_string(k))==std::string::npos){
+      std::cout<<line<<std::endl;
+      return(14);
     }
-  } else return(104);
-  if (std::getline(stream,line)){
-    if (!std::regex_match(line,getRegex("INFO",5,true))){
-      std::cout<<"line="<<line<<std::endl;
-      return(5); 
+  }
+  if (k!=11) return(15);
+  return(0);
+}
+REGISTER_TEST(logger,tc27){
+  gated_buffer slow[3];
+  std::ostream severity_out(&slow[0]);
+  std::ostream oldest_out(&slow[1]);
+  std::ostream newest_out(&slow[2]);
+  std::stringstream metrics;
+  ict::logger::output::flush_policy_t policy;
+  std::vector<ict::logger::output::queue_stats_t> queues;
+  std::vector<std::string> lines[3];
+  std::string line;
+  std::atomic<bool> done(false);
+  const uint64_t dropped(ict::logger::stats().queue_dropped);
+  LOGGER_BASEDIR;
+  LOGGER_THREAD;
+  LOGGER_SET(std::cerr,ict::logger::none);
+  LOGGER_SET(std::cout,ict::logger::none);
+  LOGGER_SET("test",ict::logger::none);
+  #include "enable-all.hpp"
+  //Odrzucanie linii najniższych poziomów.
+  policy.queue=4;
+  policy.overload=ict::logger::output::overload_drop_severity;
+  LOGGER_SET(severity_out,ict::logger::all,policy);
+  LOGGER_DEBUG<<__LOGGER__<<"Test 1"<<std::endl;
+  slow[0].blocked();//Linia 1 jest zapisywana (poza kolejką).
+  LOGGER_INFO<<__LOGGER__<<"Test 2"<<std::endl;
+  LOGGER_INFO<<__LOGGER__<<"Test 3"<<std::endl;
+  LOGGER_NOTICE<<__LOGGER__<<"Test 4"<<std::endl;
+  LOGGER_DEBUG<<__LOGGER__<<"Test 5"<<std::endl;//Odrzucona - w kolejce nie ma linii niższego poziomu.
+  LOGGER_WARN<<__LOGGER__<<"Test 6"<<std::endl;//Zastępuje linię 2.
+  LOGGER_ERR<<__LOGGER__<<"Test 7"<<std::endl;//Zastępuje linię 3.
+  LOGGER_CRIT<<__LOGGER__<<"Test 8"<<std::endl;//Zastępuje linię 4.
+  LOGGER_ERR<<__LOGGER__<<"Test 9"<<std::endl;//Zastępuje linię 6.
+  std::thread writer([&done]{//Linia critical czeka na miejsce.
+    LOGGER_THREAD;
+    LOGGER_CRIT<<__LOGGER__<<"Test 10"<<std::endl;
+    done.store(true);
+  });
+  for (int i=0;(ict::logger::output::queueStats()[0].full<7)&&(i<1000);i++) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  const bool waited(!done.load());
+  queues=ict::logger::output::queueStats();
+  ict::logger::output::writeStats(metrics);
+  slow[0].open();
+  writer.join();
+  LOGGER_FLUSH;//Odrzucone linie nie są zapisywane.
+  if (!waited) return(1);
+  if ((queues.size()!=1)||(queues[0].dropped[0]+queues[0].dropped[1])) return(2);
+  if ((queues[0].dropped[2]!=1)||(queues[0].dropped[3]!=1)||(queues[0].dropped[4]!=2)||(queues[0].dropped[5]!=1)) return(3);
+  if (metrics.str().find("ict_logger_queue_dropped_total{output=\""+queues[0].output+"\",severity=\"info\"} 2\n")==std::string::npos) return(4);
+  LOGGER_SET(severity_out,ict::logger::none);
+  //Odrzucanie najstarszych linii.
+  policy.queue=2;
+  policy.overload=ict::logger::output::overload_drop_oldest;
+  LOGGER_SET(oldest_out,ict::logger::all,policy);
+  LOGGER_INFO<<__LOGGER__<<"Test 1"<<std::endl;
+  slow[1].blocked();
+  LOGGER_DEBUG<<__LOGGER__<<"Test 2"<<std::endl;
+  LOGGER_INFO<<__LOGGER__<<"Test 3"<<std::endl;//Zastępuje linię 2.
+  LOGGER_INFO<<__LOGGER__<<"Test 4"<<std::endl;//Zastępuje linię 3.
+  slow[1].open();
+  LOGGER_FLUSH;
+  LOGGER_SET(oldest_out,ict::logger::none);
+  //Odrzucanie wstawianych linii.
+  policy.overload=ict::logger::output::overload_drop_newest;
+  LOGGER_SET(newest_out,ict::logger::all,policy);
+  LOGGER_INFO<<__LOGGER__<<"Test 1"<<std::endl;
+  slow[2].blocked();
+  LOGGER_INFO<<__LOGGER__<<"Test 2"<<std::endl;
+  LOGGER_NOTICE<<__LOGGER__<<"Test 3"<<std::endl;
+  LOGGER_DEBUG<<__LOGGER__<<"Test 4"<<std::endl;
+  slow[2].open();
+  LOGGER_FLUSH;
+  LOGGER_SET(newest_out,ict::logger::none);
+  if (ict::logger::stats().queue_dropped!=(dropped+9)) return(5);
+  for (int k=0;k<3;k++){
+    std::istringstream in(slow[k].text());
+    while (std::getline(in,line)) lines[k].push_back(line);
+  }
+  const std::vector<std::string> expected[3]={
+    {" Test 1","(pominięto linie: 5; debug=1 info=2 notice=1 warning=1)!"," Test 7"," Test 8"," Test 9"," Test 10"},
+    {" Test 1","(pominięto linie: 2; debug=1 info=1)!"," Test 4"},
+    {" Test 1","(pominięto linie: 2; debug=1 notice=1)!"," Test 2"}
+  };
+  for (int k=0;k<3;k++){
+    if (lines[k].size()!=expected[k].size()) {
+      for (const std::string & l: lines[k]) std::cout<<l<<std::endl;
+      return(6+k);
     }
-  } else return(105);
-  if (std::getline(stream,line)){
-    if (!std::regex_match(line,getRegex("DEBUG",6,true))){
-      std::cout<<"line="<<line<<std::endl;
-      return(6); 
+    for (std::size_t i=0;i<lines[k].size();i++) if (lines[k][i].find(expected[k][i])==std::string::npos){
+      std::cout<<lines[k][i]<<std::endl;
+      return(9+k);
     }
-  } else return(106);
-  if (std::getline(stream,line)){
-    return(200);
+    if (lines[k][1].find(" WARNING Kolejka wyjścia text:")==std::string::npos) return(12);
   }
   return(0);
 }
-REGISTER_TEST(logger,tc4){
+REGISTER_TEST(logger,tc28){
   std::stringstream stream;
+  std::vector<std::string> lines;
   std::string line;
   LOGGER_BASEDIR;
   LOGGER_THREAD;
@@ -855,27 +6121,114 @@ REGISTER_TEST(logger,tc4){
   LOGGER_SET("test",ict::logger::none);
   LOGGER_SET(stream);
   #include "enable-all.hpp"
+  //Warstwa używana ponownie nie przejmuje stanu strumienia poprzedniej.
   {
     LOGGER_LAYER;
-    LOGGER_WARN<<__LOGGER__<<"Test "<<3<<std::endl;
-    LOGGER_NOTICE<<__LOGGER__<<"Test "<<4<<std::endl;
-    LOGGER_INFO<<__LOGGER__<<"Test "<<5<<std::endl;
-    LOGGER_DEBUG<<__LOGGER__<<"Test "<<6<<std::endl;
+    LOGGER_NOTICE<<std::hex<<std::showbase<<std::setfill('*')<<std::setw(6)<<255<<" "<<std::setprecision(2)<<3.14159<<std::endl;
+    LOGGER_NOTICE<<static_cast<const char *>(nullptr);//Ustawia badbit.
   }
-  if (std::getline(stream,line)){
-    if (!std::regex_match(line,getRegex("WARNING",3))){
-      std::cout<<"line="<<line<<std::endl;
-      return(3); 
-    }
-  } else return(103);
-  if (std::getline(stream,line)){
-    if (!std::regex_match(line,getRegex("NOTICE",4))){
-      std::cout<<"line="<<line<<std::endl;
-      return(4); 
-    }
-  } else return(104);
-  if (std::getline(stream,line)){
-    return(200);
+  {
+    LOGGER_LAYER;
+    LOGGER_NOTICE<<std::setw(6)<<255<<" "<<3.14159<<std::endl;
+  }
+  LOGGER_SET(stream,ict::logger::none);
+  while (std::getline(stream,line)) lines.push_back(line);
+  if (lines.size()!=2) return(1);
+  if (lines[0].find(" **0xff 3.1")==std::string::npos) return(2);
+  if (lines[1].find("    255 3.14159")==std::string::npos) return(3);
+  return(0);
+}
+//! Bufor strumienia liczący zapisy po usunięciu strumienia z wyjść.
+class tc29_buffer:public std::streambuf {
+public:
+  std::atomic<bool> removed{false};
+  std::atomic<int> late{0};
+protected:
+  int overflow(int c){
+    if (removed.load()) late++;
+    return(traits_type::not_eof(c));
+  }
+  std::streamsize xsputn(const char *,std::streamsize n){
+    if (removed.load()) late++;
+    return(n);
+  }
+};
+REGISTER_TEST(logger,tc29){
+  tc29_buffer buffer[3];
+  std::ostream text(&buffer[0]);
+  std::ostream binary(&buffer[1]);
+  std::ostream json(&buffer[2]);
+  std::vector<std::thread> threads;
+  std::atomic<bool> stop(false);
+  LOGGER_BASEDIR;
+  LOGGER_THREAD;
+  LOGGER_SET(std::cerr,ict::logger::none);
+  LOGGER_SET(std::cout,ict::logger::none);
+  LOGGER_SET("test",ict::logger::none);
+  #include "enable-all.hpp"
+  for (int k=0;k<4;k++) threads.emplace_back([&stop]{
+    LOGGER_THREAD;
+    while (!stop.load()) LOGGER_NOTICE<<__LOGGER__<<"Test"<<std::endl;
+  });
+  //Po usunięciu wyjścia żaden wątek nie zapisuje do jego strumienia (można go zniszczyć).
+  for (int i=0;i<100;i++){
+    for (tc29_buffer & b: buffer) b.removed.store(false);
+    LOGGER_SET(text);
+    LOGGER_BINARY(binary);
+    LOGGER_JSON(json);
+    std::this_thread::yield();
+    LOGGER_SET(text,ict::logger::none);
+    buffer[0].removed.store(true);
+    LOGGER_BINARY(binary,ict::logger::none);
+    buffer[1].removed.store(true);
+    LOGGER_JSON(json,ict::logger::none);
+    buffer[2].removed.store(true);
+    std::this_thread::yield();
+  }
+  stop.store(true);
+  for (std::thread & t: threads) t.join();
+  for (int k=0;k<3;k++) if (buffer[k].late.load()) {
+    std::cout<<"late["<<k<<"]="<<buffer[k].late.load()<<std::endl;
+    return(1+k);
+  }
+  //Usunięcie wyjścia nie czeka na wątek wstrzymany przez inne wyjście.
+  {
+    gated_buffer gate;
+    std::ostream gated(&gate);
+    buffer[0].removed.store(false);
+    LOGGER_SET(gated,ict::logger::notices);
+    LOGGER_SET(text,ict::logger::notices);
+    std::thread t([]{
+      LOGGER_THREAD;
+      LOGGER_NOTICE<<__LOGGER__<<"Test"<<std::endl;
+    });
+    gate.blocked();
+    LOGGER_SET(text,ict::logger::none);
+    buffer[0].removed.store(true);
+    gate.open();
+    t.join();
+    LOGGER_SET(gated,ict::logger::none);
+  }
+  if (buffer[0].late.load()) return(4);
+  //Zamykanie kolejki wstrzymanego strumienia nie blokuje zmian pozostałych wyjść.
+  {
+    gated_buffer gate;
+    std::ostream gated(&gate);
+    std::stringstream other;
+    ict::logger::output::flush_policy_t policy;
+    policy.queue=4;
+    LOGGER_SET(gated,ict::logger::notices,policy);
+    LOGGER_NOTICE<<__LOGGER__<<"Test"<<std::endl;
+    gate.blocked();
+    std::thread remover([&gated]{
+      LOGGER_SET(gated,ict::logger::none);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    LOGGER_SET(other,ict::logger::notices);
+    LOGGER_SET(other,ict::logger::none);
+    gate.open();
+    remover.join();
+    if (gate.text().find("Test")==std::string::npos) return(5);
   }
   return(0);
 }
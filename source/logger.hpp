@@ -36,8 +36,16 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef _ICT_LOGGER_HEADER
 #define _ICT_LOGGER_HEADER
 //============================================
+#include <string>
+#include <string_view>
+#include <vector>
 #include <cstdint>
+#include <cstddef>
+#include <type_traits>
+#include <charconv>
+#include <atomic>
 #include <ostream>
+#include <istream>
 #include "enable-all.hpp"
 #include "enable-layer.hpp"
 //============================================
@@ -47,18 +55,79 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define LOGGER_SET(stream,...) ict::logger::output::set(stream,##__VA_ARGS__)
 //! Makro sprawdzające ustawienia strumienia wyjściowego.
 #define LOGGER_TEST(stream) ict::logger::output::test(stream) 
+//! Makro włączające/wyłączające tryb asynchroniczny.
+#define LOGGER_ASYNC(...) ict::logger::output::setAsync(__VA_ARGS__)
+//! Makro czekające na zapisanie wszystkich linii loga.
+#define LOGGER_FLUSH ict::logger::output::flush()
+//! Makro ustawiające plik wyjściowy.
+#define LOGGER_FILE(path,...) ict::logger::output::setFile(path,##__VA_ARGS__)
+//! Makro sprawdzające ustawienia pliku wyjściowego.
+#define LOGGER_TEST_FILE(path) ict::logger::output::testFile(path)
+//! Makro ustawiające rejestrator (plik odwzorowany w pamięci).
+#define LOGGER_RECORDER(path,...) ict::logger::output::setRecorder(path,##__VA_ARGS__)
+//! Makro sprawdzające ustawienia rejestratora.
+#define LOGGER_TEST_RECORDER(path) ict::logger::output::testRecorder(path)
+//! Makro ustawiające wyjście do syslog (bezpośrednio do gniazda).
+#define LOGGER_SYSLOG(ident,...) ict::logger::output::setSyslog(ident,##__VA_ARGS__)
+//! Makro sprawdzające ustawienia wyjścia do syslog.
+#define LOGGER_TEST_SYSLOG(ident,...) ict::logger::output::testSyslog(ident,##__VA_ARGS__)
+//! Makro ustawiające binarny strumień wyjściowy.
+#define LOGGER_BINARY(stream,...) ict::logger::output::setBinary(stream,##__VA_ARGS__)
+//! Makro ustawiające strumień wyjściowy JSON Lines.
+#define LOGGER_JSON(stream,...) ict::logger::output::setJson(stream,##__VA_ARGS__)
+//! Makro sprawdzające strumień wyjściowy JSON Lines.
+#define LOGGER_TEST_JSON(stream) ict::logger::output::testJson(stream)
+//! Makro ustawiające liczbę cyfr ułamka sekundy w znaczniku czasu.
+#define LOGGER_PRECISION(digits) ict::logger::setPrecision(digits)
+//! Makro podające statystyki loggera.
+#define LOGGER_STATS ict::logger::stats()
+//! Makro włączające usuwanie powtórzeń linii.
+#define LOGGER_DEDUP(...) ict::logger::output::setDedup(__VA_ARGS__)
 //! Makro restartujące loggera (cały stos jest kasowany).
 #define LOGGER_RESTART ict::logger::restart()
 //! Makro ustawiające wartości domyślne dla warstw logowania.
 #define LOGGER_DEFAULT(...) ict::logger::input::setDefault(__VA_ARGS__)
+//! Makro ustawiające budżet pamięci linii buforowanych.
+#define LOGGER_BUDGET(...) ict::logger::input::setBudget(__VA_ARGS__)
+//! Makro włączające lub wyłączające odraczanie linii LOGGER_*_F w warstwach buforowanych.
+#define LOGGER_DEFERRED(...) ict::logger::input::setDeferred(__VA_ARGS__)
 //! Makro - Informacja o pliku.
 #define __LOGGER_FILE__ ict::logger::file(__FILE__)
 //! Makro - Informacja o linii w pliku.
 #define __LOGGER_LINE__ __LINE__
 //! Makro - Informacja o funkcji.
 #define __LOGGER_FUNCTION__ "("<<__PRETTY_FUNCTION__<<")"
+//! Makro - Długość katalogu bazowego w ścieżce pliku (wyliczana w czasie kompilacji, jeśli ustawiono LOGGER_SOURCE_DIR).
+#ifdef LOGGER_SOURCE_DIR
+#define __LOGGER_FILE_OFFSET__ std::integral_constant<std::size_t,ict::logger::prefix_size(__FILE__,LOGGER_SOURCE_DIR)>::value
+#else
+#define __LOGGER_FILE_OFFSET__ 0
+#endif
+//! Makro - Nazwa funkcji i jej długość (skrócona w czasie kompilacji, jeśli ustawiono LOGGER_SHORT_FUNCTION).
+#ifdef LOGGER_SHORT_FUNCTION
+#define __LOGGER_SITE_FUNCTION__ \
+  __PRETTY_FUNCTION__+std::integral_constant<std::size_t,ict::logger::function_begin(__PRETTY_FUNCTION__)>::value, \
+  std::integral_constant<std::size_t,ict::logger::function_size(__PRETTY_FUNCTION__)>::value
+#else
+#define __LOGGER_SITE_FUNCTION__ __PRETTY_FUNCTION__,sizeof(__PRETTY_FUNCTION__)-1
+#endif
 //! Makro ładujące informacje o miejscu w kodzie.
-#define __LOGGER__ __LOGGER_FILE__<<":"<<__LOGGER_LINE__<<" "<<__LOGGER_FUNCTION__<<" "
+#define __LOGGER__ ict::logger::site(__FILE__+__LOGGER_FILE_OFFSET__,(__LOGGER_FILE_OFFSET__)!=0,__LINE__,__LOGGER_SITE_FUNCTION__)
+//! Makro - Strumień wejściowy dla zadanego poziomu (całe wyrażenie jest pomijane, jeśli nikt nie odbierze linii).
+#define __LOGGER_STREAM__(severity) (!ict::logger::input::enabled(severity))?(void)0:ict::logger::input::voidify()&ict::logger::input::ostream(severity)
+//! Makro - Linia strukturalna dla zadanego poziomu (argumenty nie są wyliczane, jeśli nikt nie odbierze linii).
+#define __LOGGER_KV__(severity,...) (!ict::logger::input::enabled(severity))?(void)0:ict::logger::input::kv(severity,__LOGGER__,__VA_ARGS__)
+//! Makro - Linia z ciągiem formatującym dla zadanego poziomu (ciąg jest sprawdzany w czasie kompilacji, argumenty nie są wyliczane, jeśli nikt nie odbierze linii).
+#define __LOGGER_FORMAT__(severity,fmt,...) (!ict::logger::input::enabled(severity))?(void)0: \
+  ict::logger::input::format<ict::logger::input::format_placeholders(fmt),decltype(ict::logger::input::arg_count(__VA_ARGS__))::value>(severity,__LOGGER__,fmt,##__VA_ARGS__)
+//! Makro - Stan ograniczenia liczby linii (statyczny, osobny dla każdego miejsca w kodzie).
+#define __LOGGER_LIMITER__ ([]()->ict::logger::input::limiter_t &{static ict::logger::input::limiter_t limiter;return(limiter);}())
+//! Makro - Strumień wejściowy dla zadanego poziomu co n-te wywołanie (całe wyrażenie jest pomijane w pozostałych wywołaniach).
+#define __LOGGER_EVERY_N__(severity,n) (!ict::logger::input::enabled(severity)||!__LOGGER_LIMITER__.every(n))?(void)0:ict::logger::input::voidify()&ict::logger::input::ostream(severity)
+//! Makro - Strumień wejściowy dla zadanego poziomu tylko dla n pierwszych wywołań.
+#define __LOGGER_FIRST_N__(severity,n) (!ict::logger::input::enabled(severity)||!__LOGGER_LIMITER__.first(n))?(void)0:ict::logger::input::voidify()&ict::logger::input::ostream(severity)
+//! Makro - Strumień wejściowy dla zadanego poziomu z ograniczeniem liczby linii na sekundę.
+#define __LOGGER_RATE__(severity,per_sec) (!ict::logger::input::enabled(severity)||!__LOGGER_LIMITER__.rate(severity,per_sec,__LOGGER__))?(void)0:ict::logger::input::voidify()&ict::logger::input::ostream(severity)
 //============================================
 namespace ict { namespace logger {
 //===========================================
@@ -85,22 +154,124 @@ extern const flags_t none;
 extern const flags_t nodebug;
 extern const flags_t defaultValue;
 
+//! Typ wartości pola linii strukturalnej.
+enum field_type_t {
+  field_int,
+  field_uint,
+  field_double,
+  field_bool,
+  field_string
+};
+//! Pole linii strukturalnej (LOGGER_*_KV).
+struct field_t {
+  //! Nazwa pola - literał, który nie jest kopiowany (addFields() przyjmuje tylko tablice znaków).
+  const char * key;
+  //! Typ wartości.
+  field_type_t type;
+  //! Wartość (poza field_string).
+  union {
+    int64_t i;
+    uint64_t u;
+    double d;
+    bool b;
+  };
+  //! Wartość tekstowa (field_string).
+  std::string s;
+};
+//! Histogram czasów (w nanosekundach) o stałych przedziałach.
+struct histogram_t {
+  //! Liczba przedziałów.
+  static const std::size_t size=16;
+  //! Górne granice przedziałów (64 ns, 128 ns ... 1 ms) - ostatni przedział nie ma granicy.
+  static const uint64_t bounds[size-1];
+  //! Liczba pomiarów w przedziałach.
+  uint64_t buckets[size]={};
+  //! Liczba pomiarów.
+  uint64_t count=0;
+  //! Suma zmierzonych czasów.
+  uint64_t sum=0;
+};
+//! Statystyki loggera (sumy dla wszystkich wątków od uruchomienia procesu).
+struct stats_t {
+  //! Liczba linii według poziomu logowania (kolejno: critical, error, warning, notice, info, debug).
+  uint64_t lines[6]={};
+  //! Liczba linii zapisanych do buforów warstw.
+  uint64_t buffered=0;
+  //! Liczba linii buforowanych zapisanych przy zrzucie bufora.
+  uint64_t dumped=0;
+  //! Liczba linii buforowanych porzuconych przy zamknięciu warstwy bez zrzutu.
+  uint64_t discarded=0;
+  //! Liczba linii buforowanych nadpisanych po przekroczeniu budżetu warstwy.
+  uint64_t overwritten=0;
+  //! Liczba zrzutów buforów.
+  uint64_t dumps=0;
+  //! Liczba linii, które czekały na miejsce w pełnym pierścieniu (tryb asynchroniczny).
+  uint64_t ring_full=0;
+  //! Liczba powtórzeń linii pominiętych przez usuwanie powtórzeń.
+  uint64_t repeated=0;
+  //! Liczba skompresowanych plików po rotacji.
+  uint64_t compressed=0;
+  //! Rozmiar plików przed kompresją (w bajtach).
+  uint64_t compress_in=0;
+  //! Rozmiar plików po kompresji (w bajtach).
+  uint64_t compress_out=0;
+  //! Czas procesora zużyty przez kompresję (w nanosekundach).
+  uint64_t compress_cpu=0;
+  //! Liczba linii odrzuconych przez przepełnione kolejki wyjść (overload_t).
+  uint64_t queue_dropped=0;
+  //! Czas oczekiwania na muteks wyjścia.
+  histogram_t lock_wait;
+  //! Czas zapisu do wyjścia (pod jego muteksem).
+  histogram_t write;
+};
+
 //! Elementy pozwalające na podłączenie i manipulację wyjścia logowania.
 namespace output {
+  //! Zachowanie wyjścia z własnym wątkiem, gdy jego kolejka jest pełna.
+  enum overload_t {
+    //! Wątek, który loguje, czeka na miejsce w kolejce.
+    overload_block,
+    //! Wstawiane linie są odrzucane.
+    overload_drop_newest,
+    //! Najstarsze linie w kolejce są odrzucane.
+    overload_drop_oldest,
+    //! Odrzucane są linie najniższych poziomów (najpierw debug i info, potem notice i warning) - linie critical i error nie są odrzucane.
+    overload_drop_severity
+  };
+  //! Zasady opróżniania (flush) strumienia wyjściowego.
+  struct flush_policy_t {
+    //! Poziomy logowania, których linie powodują natychmiastowe opróżnienie strumienia (all - każda linia, none - żadna).
+    flags_t severity=all;
+    //! Liczba linii, po której strumień jest opróżniany (0 - bez limitu).
+    std::size_t lines=0;
+    //! Liczba bajtów, po której strumień jest opróżniany (0 - bez limitu).
+    std::size_t bytes=0;
+    //! Maksymalny czas (w milisekundach) od zapisu do opróżnienia strumienia (0 - bez limitu).
+    unsigned interval=0;
+    //! Pojemność kolejki (w liniach) własnego wątku strumienia (0 - zapis w wątku, który loguje).
+    std::size_t queue=0;
+    //! Zachowanie przy pełnej kolejce.
+    overload_t overload=overload_block;
+  };
   //!
   //! @brief Ustawia strumień wyjściowy dla logera.
   //!
   //! @param ostream Wskaźnik na strumień wyjściowy. 
   //! @param filter Filtr logów - zapisywane są tylko te, które mieszczą się w podanej masce. 
-  //!  Jeśli podana zostanie wartość 0x0, to strumień zostanie usunięty.
+  //!  Jeśli podana zostanie wartość 0x0, to strumień zostanie usunięty (po opróżnieniu).
+  //! @param policy Zasady opróżniania strumienia (domyślnie po każdej linii).
+  //!  Strumień jest też opróżniany przez flush() i przy usunięciu.
+  //!  Jeśli podano pojemność kolejki (queue), to strumień zapisuje własny wątek - wolny strumień nie wstrzymuje
+  //!  wątków, które logują, ani pozostałych wyjść, dopóki kolejka się nie zapełni (dalej decyduje overload).
   //!
-  void set(std::ostream & ostream,flags_t filter=all);
+  void set(std::ostream & ostream,flags_t filter=all,const flush_policy_t & policy=flush_policy_t());
   //!
   //! @brief Ustawia wyjście do syslog dla logera.
   //!
   //! @param ident String identyfikujący wpisy tej aplikacji w syslog.
   //! @param filter Filtr logów - zapisywane są tylko te, które mieszczą się w podanej masce. 
   //!  Jeśli podana zostanie wartość 0x0, to syslog zostanie usunięty.
+  //!  Zastępuje wszystkie wyjścia ustawione wcześniej przez set() lub setSyslog().
   //!
   void set(const std::string & ident,flags_t filter=all);
   //!
@@ -113,10 +284,261 @@ namespace output {
   //!
   //! @brief Sprawdza, czy syslog jest już ustawiony.
   //!
-  //! @return Ustawienia filtra dla syslog. Jeśli 0x0, to syslog nie jest ustawiony.
+  //! @return Suma filtrów wszystkich wyjść do syslog. Jeśli 0x0, to syslog nie jest ustawiony.
   //!
   flags_t test();
+  //! Format komunikatów syslog.
+  enum syslog_format_t {
+    //! Format BSD (RFC 3164): <PRI>Mmm dd hh:mm:ss ident[pid]: treść
+    rfc3164,
+    //! Format IETF (RFC 5424): <PRI>1 czas-ISO host ident pid - - treść
+    rfc5424
+  };
+  //! Ustawienia wyjścia do syslog.
+  struct syslog_options_t {
+    //! Ścieżka gniazda syslog (AF_UNIX, SOCK_DGRAM).
+    std::string path="/dev/log";
+    //! Format komunikatów.
+    syslog_format_t format=rfc3164;
+    //! Kod facility (1 - user, 16..23 - local0..local7).
+    unsigned facility=1;
+    //! Pojemność kolejki (w liniach) własnego wątku wyjścia (0 - wysyłanie w wątku, który loguje).
+    std::size_t queue=0;
+    //! Zachowanie przy pełnej kolejce.
+    overload_t overload=overload_block;
+  };
+  //! Liczniki wyjścia do syslog.
+  struct syslog_stats_t {
+    //! Liczba wysłanych komunikatów.
+    uint64_t sent=0;
+    //! Liczba komunikatów odrzuconych (pełne lub niedostępne gniazdo).
+    uint64_t dropped=0;
+  };
+  //!
+  //! @brief Ustawia wyjście do syslog o podanym identyfikatorze (obok już ustawionych).
+  //!
+  //! Komunikaty są wysyłane bezpośrednio do gniazda syslog (bez openlog/syslog), 
+  //! a linie zrzucanej warstwy - jednym wywołaniem sendmmsg.
+  //! Gniazdo działa w trybie nieblokującym - jeśli odbiorca nie nadąża, to komunikaty są odrzucane i liczone.
+  //!
+  //! @param ident String identyfikujący wpisy w syslog.
+  //! @param filter Filtr logów - zapisywane są tylko te, które mieszczą się w podanej masce. 
+  //!  Jeśli podana zostanie wartość 0x0, to wyjście zostanie usunięte.
+  //! @param options Ustawienia wyjścia (ścieżka gniazda, format, facility).
+  //!
+  void setSyslog(const std::string & ident,flags_t filter=all,const syslog_options_t & options=syslog_options_t());
+  //!
+  //! @brief Sprawdza, czy wyjście do syslog o podanym identyfikatorze jest już ustawione.
+  //!
+  //! @param ident String identyfikujący wpisy w syslog.
+  //! @param stats Jeśli podany, to zapisywane są w nim liczniki wyjścia.
+  //! @return Ustawienia filtra dla podanego wyjścia. Jeśli 0x0, to wyjście nie jest ustawione.
+  //!
+  flags_t testSyslog(const std::string & ident,syslog_stats_t * stats=nullptr);
+  //! Suma filtrów wszystkich wyjść (aktualizowana przy każdej zmianie wyjść).
+  extern std::atomic<flags_t> sinkMask;
+  //!
+  //! @brief Ustawia binarny strumień wyjściowy dla logera.
+  //!
+  //! Do strumienia binarnego trafiają tylko: identyfikator miejsca w kodzie, czas, poziom logowania i treść linii.
+  //! Postać tekstową odtwarza funkcja decode() (lub program libict-logger-decode).
+  //!
+  //! @param ostream Strumień wyjściowy (powinien być otwarty w trybie binarnym). 
+  //! @param filter Filtr logów - zapisywane są tylko te, które mieszczą się w podanej masce. 
+  //!  Jeśli podana zostanie wartość 0x0, to strumień zostanie usunięty (po opróżnieniu).
+  //! @param policy Zasady opróżniania strumienia (domyślnie po każdej linii).
+  //!
+  void setBinary(std::ostream & ostream,flags_t filter=all,const flush_policy_t & policy=flush_policy_t());
+  //!
+  //! @brief Sprawdza, czy podany wskaźnik binarnego strumienia jest już ustawiony.
+  //!
+  //! @param ostream Wskaźnik na strumień wyjściowy. 
+  //! @return Ustawienia filtra dla podanego strumienia. Jeśli 0x0, to strumień nie jest ustawiony.
+  //!
+  flags_t testBinary(std::ostream * ostream);
+  //!
+  //! @brief Ustawia strumień wyjściowy JSON Lines dla logera.
+  //!
+  //! Każda linia jest zapisywana jako jeden obiekt JSON: czas, poziom logowania, miejsce w kodzie, treść (msg)
+  //! oraz pola linii strukturalnej (LOGGER_*_KV) z zachowaniem ich typów.
+  //!
+  //! @param ostream Strumień wyjściowy.
+  //! @param filter Filtr logów - zapisywane są tylko te, które mieszczą się w podanej masce. 
+  //!  Jeśli podana zostanie wartość 0x0, to strumień zostanie usunięty (po opróżnieniu).
+  //! @param policy Zasady opróżniania strumienia (domyślnie po każdej linii).
+  //!
+  void setJson(std::ostream & ostream,flags_t filter=all,const flush_policy_t & policy=flush_policy_t());
+  //!
+  //! @brief Sprawdza, czy podany wskaźnik strumienia JSON Lines jest już ustawiony.
+  //!
+  //! @param ostream Wskaźnik na strumień wyjściowy. 
+  //! @return Ustawienia filtra dla podanego strumienia. Jeśli 0x0, to strumień nie jest ustawiony.
+  //!
+  flags_t testJson(std::ostream * ostream);
+  //! Ustawienia pliku wyjściowego.
+  struct file_options_t {
+    //! Rozmiar bufora w pamięci (w bajtach) - linie są zapisywane do pliku, gdy bufor się zapełni.
+    std::size_t buffer=64*1024;
+    //! Maksymalny czas (w milisekundach) przechowywania linii w buforze.
+    unsigned flush_interval=1000;
+    //! Rozmiar pliku (w bajtach), po przekroczeniu którego następuje rotacja (0 - bez rotacji według rozmiaru).
+    std::size_t max_size=0;
+    //! Okres (w sekundach, liczony od północy czasu lokalnego), po którym następuje rotacja (0 - bez rotacji według czasu).
+    unsigned max_age=0;
+    //! Liczba zachowywanych plików po rotacji (0 - wszystkie).
+    std::size_t keep=0;
+    //! Poziomy logowania, których linie powodują natychmiastowy zapis bufora do pliku (np. errors).
+    flags_t flush_severity=0x0;
+    //! Zapis linii w formacie JSON Lines (zamiast tekstowego).
+    bool json=false;
+    //! Poziom kompresji gzip (1-9) plików po rotacji (0 - bez kompresji). Wymaga biblioteki zlib (LOGGER_ZLIB) - bez niej plik z kompresją jest odrzucany.
+    unsigned compress=0;
+    //! Pojemność kolejki (w liniach) własnego wątku pliku (0 - zapis w wątku, który loguje).
+    std::size_t queue=0;
+    //! Zachowanie przy pełnej kolejce.
+    overload_t overload=overload_block;
+  };
+  //!
+  //! @brief Ustawia plik wyjściowy dla logera.
+  //!
+  //! Linie są zbierane w buforze w pamięci i zapisywane bezpośrednio do pliku (writev).
+  //! Przy rotacji bieżący plik otrzymuje nazwę z czasem rotacji (np. app.log.20210114-190724),
+  //! a jego miejsce zajmuje plik przygotowany wcześniej przez wątek porządkowy.
+  //! Jeśli ustawiono kompresję, to pliki po rotacji są kompresowane (app.log.20210114-190724.gz)
+  //! przez osobny wątek o najniższym priorytecie - zapis linii nigdy na niego nie czeka.
+  //!
+  //! @param path Ścieżka pliku.
+  //! @param filter Filtr logów - zapisywane są tylko te, które mieszczą się w podanej masce. 
+  //!  Jeśli podana zostanie wartość 0x0, to plik zostanie usunięty (zawartość bufora jest zapisywana).
+  //! @param options Ustawienia pliku (bufor, rotacja, liczba zachowywanych plików).
+  //!
+  void setFile(const std::string & path,flags_t filter=all,const file_options_t & options=file_options_t());
+  //!
+  //! @brief Sprawdza, czy podany plik wyjściowy jest już ustawiony.
+  //!
+  //! @param path Ścieżka pliku.
+  //! @return Ustawienia filtra dla podanego pliku. Jeśli 0x0, to plik nie jest ustawiony.
+  //!
+  flags_t testFile(const std::string & path);
+  //!
+  //! @brief Ustawia rejestrator dla logera.
+  //!
+  //! Rejestrator zapisuje linie tekstowe do pliku odwzorowanego w pamięci, używanego jako bufor cykliczny.
+  //! Zapis linii to kopiowanie do pamięci (bez wywołań systemowych), a zawartość pliku przetrwa zabicie procesu.
+  //! Linie buforowane są zapisywane w chwili powstania (nawet jeśli bufor nie zostanie opróżniony).
+  //! Zawartość odczytuje funkcja recover() (lub program libict-logger-recover).
+  //!
+  //! @param path Ścieżka pliku (jeśli plik ma ten sam rozmiar, to jego zawartość jest zachowywana).
+  //! @param filter Filtr logów - zapisywane są tylko te, które mieszczą się w podanej masce. 
+  //!  Jeśli podana zostanie wartość 0x0, to rejestrator zostanie usunięty.
+  //! @param size Pojemność bufora cyklicznego (w bajtach).
+  //!
+  void setRecorder(const std::string & path,flags_t filter=all,std::size_t size=16*1024*1024);
+  //!
+  //! @brief Sprawdza, czy podany rejestrator jest już ustawiony.
+  //!
+  //! @param path Ścieżka pliku.
+  //! @return Ustawienia filtra dla podanego rejestratora. Jeśli 0x0, to rejestrator nie jest ustawiony.
+  //!
+  flags_t testRecorder(const std::string & path);
+  //!
+  //! @brief Odczytuje linie zapisane przez rejestrator (od najstarszej).
+  //!
+  //! @param path Ścieżka pliku rejestratora.
+  //! @param out Strumień tekstowy.
+  //! @param limit Maksymalna liczba odczytanych bajtów od końca (0 - cała zawartość).
+  //! @return Wartość true, jeśli plik rejestratora został poprawnie odczytany.
+  //!
+  bool recover(const std::string & path,std::ostream & out,std::size_t limit=0);
+  //!
+  //! @brief Odtwarza postać tekstową logów zapisanych w strumieniu binarnym.
+  //!
+  //! @param in Strumień binarny.
+  //! @param out Strumień tekstowy.
+  //! @return Wartość true, jeśli cały strumień binarny został poprawnie odczytany.
+  //!
+  bool decode(std::istream & in,std::ostream & out);
+  //!
+  //! @brief Włącza lub wyłącza tryb asynchroniczny.
+  //!
+  //! W trybie asynchronicznym wątki logujące wkładają gotowe linie do własnych pierścieni,
+  //! a do strumieni wyjściowych i syslog zapisuje je osobny wątek.
+  //! Linie z jednego wątku są zapisywane w kolejności, w jakiej powstały.
+  //! Linie z różnych wątków nie mają wspólnego porządku.
+  //! Wyłączenie trybu zapisuje wszystkie oczekujące linie.
+  //!
+  //! @param enable Jeśli true, to tryb asynchroniczny jest włączany.
+  //! @param capacity Pojemność pierścienia (w liniach) dla każdego wątku.
+  //!
+  void setAsync(bool enable=true,std::size_t capacity=4096);
+  //!
+  //! @brief Sprawdza, czy tryb asynchroniczny jest włączony.
+  //!
+  //! @return Wartość true, jeśli tryb asynchroniczny jest włączony.
+  //!
+  bool testAsync();
+  //!
+  //! @brief Czeka, aż wszystkie linie zalogowane przed wywołaniem zostaną zapisane.
+  //!
+  //! Najpierw czeka na zapis linii z kolejek wyjść, które mają własny wątek.
+  //! Zawartość buforów plików wyjściowych jest zapisywana do plików, a strumienie wyjściowe są opróżniane.
+  //!
+  void flush();
+  //!
+  //! @brief Zapisuje statystyki loggera w formacie tekstowym Prometheus.
+  //!
+  //! @param out Strumień wyjściowy.
+  //!
+  void writeStats(std::ostream & out);
+  //! Stan kolejki wyjścia z własnym wątkiem.
+  struct queue_stats_t {
+    //! Nazwa wyjścia (np. file:/var/log/app.log, syslog:app, text:0x7f12...).
+    std::string output;
+    //! Liczba linii w kolejce (razem z zapisywanymi).
+    std::size_t depth=0;
+    //! Pojemność kolejki (w liniach).
+    std::size_t capacity=0;
+    //! Czas oczekiwania najstarszej linii w kolejce (w nanosekundach).
+    uint64_t lag=0;
+    //! Liczba linii zapisanych przez wątek wyjścia.
+    uint64_t lines=0;
+    //! Liczba linii, które czekały na miejsce w pełnej kolejce (lub zostały odrzucone).
+    uint64_t full=0;
+    //! Liczba linii odrzuconych przy pełnej kolejce według poziomu logowania (kolejno: critical, error, warning, notice, info, debug).
+    uint64_t dropped[6]={};
+  };
+  //!
+  //! @brief Podaje stan kolejek wyjść, które mają własny wątek (queue w ustawieniach wyjścia).
+  //!
+  //! @return Stan kolejek (kolejność jak w zestawie wyjść).
+  //!
+  std::vector<queue_stats_t> queueStats();
+  //!
+  //! @brief Włącza okresowy zapis statystyk loggera jako linii loga.
+  //!
+  //! @param interval Okres (w milisekundach) - 0 wyłącza zapis.
+  //! @param severity Poziom logowania linii ze statystykami.
+  //!
+  void setStats(unsigned interval,flags_t severity=info);
+  //!
+  //! @brief Włącza pomiar czasu oczekiwania na muteks wyjścia i czasu zapisu (histogramy lock_wait i write w stats_t).
+  //!
+  //! @param enable Informacja, czy czas jest mierzony (domyślnie tak) - wyłączenie oszczędza dwa odczyty zegara na każdy zapis do wyjścia.
+  //!
+  void setTiming(bool enable);
+  //!
+  //! @brief Włącza usuwanie powtórzeń linii przed zapisem do wyjść.
+  //!
+  //! Linia identyczna (poziom logowania, miejsce w kodzie i treść - bez czasu) z linią zapisaną w ciągu ostatniego okna jest pomijana.
+  //! Liczba pominiętych powtórzeń jest zapisywana w osobnej linii po upływie okna (lub przy pierwszej innej linii
+  //! w tym samym miejscu tablicy powtórzeń, przy LOGGER_FLUSH i przy zmianie ustawień). Linie buforowane nie są sprawdzane.
+  //!
+  //! @param window Okno (w milisekundach) - 0 wyłącza usuwanie powtórzeń.
+  //! @param filter Poziomy logowania, dla których powtórzenia są usuwane.
+  //!
+  void setDedup(unsigned window,flags_t filter=all);
 }
+struct site_struct;
 //! Elementy pozwalające na podłączenie się i manipulację do wejścia logowania.
 namespace input {
   //!
@@ -131,6 +553,25 @@ namespace input {
     ict::logger::flags_t buffered_in=ict::logger::nonotices,
     ict::logger::flags_t dump_in=ict::logger::errors
   );
+  //!
+  //! @brief Ustawia budżet pamięci linii buforowanych.
+  //!
+  //! Linie buforowane wszystkich warstw wątku są przechowywane w jednym obszarze pamięci (używanym ponownie przez kolejne warstwy).
+  //! Jeśli linie warstwy przekroczą budżet, to najstarsze z nich są nadpisywane (zachowywane są najnowsze linie przed zrzutem).
+  //!
+  //! @param [in] budget Domyślny budżet jednej warstwy (w bajtach).
+  //! @param [in] limit Limit pamięci linii buforowanych wszystkich wątków (w bajtach, 0 - bez limitu).
+  //!
+  void setBudget(std::size_t budget=64*1024,std::size_t limit=0);
+  //!
+  //! @brief Włącza lub wyłącza odraczanie linii z ciągiem formatującym (LOGGER_*_F) w warstwach buforowanych.
+  //!
+  //! Odroczona linia przechowuje w buforze warstwy wartości argumentów (a nie tekst), a tekst powstaje dopiero przy zrzucie bufora.
+  //! Linie porzucane bez zrzutu nie są więc w ogóle formatowane. Tekst zrzuconej linii jest taki sam jak bez odraczania.
+  //!
+  //! @param [in] on Wartość true - linie są odraczane (domyślnie), false - linie są formatowane od razu.
+  //!
+  void setDeferred(bool on=true);
   //! Obiekt tworzący warstwę logowania. Musi być utworzony co najmniej jeden w danym wątku, by logowanie było możliwe.
   class Layer {
   public:
@@ -140,11 +581,13 @@ namespace input {
     //! @param [in] direct_in Poziomy logowania bez buforowania na tej warstwie.
     //! @param [in] buffered_in Poziomy logowania z buforowaniem na tej warstwie.
     //! @param [in] dump_in Poziomy logowania, które powodują opróżnienie bufora na tej warstwie.
+    //! @param [in] budget_in Budżet linii buforowanych na tej warstwie (w bajtach, 0 - wartość domyślna).
     //!
     Layer(
       ict::logger::flags_t direct_in=ict::logger::defaultValue,
       ict::logger::flags_t buffered_in=ict::logger::defaultValue,
-      ict::logger::flags_t dump_in=ict::logger::defaultValue
+      ict::logger::flags_t dump_in=ict::logger::defaultValue,
+      std::size_t budget_in=0
     );
     //!
     //! @brief Destruktor.
@@ -161,7 +604,7 @@ namespace input {
   //! Strumień na niby.
   class dummy_stream  {//! Nic nie robi.
   public:
-    template <typename Any> dummy_stream & operator<<(Any a){return(*this);}
+    template <typename Any> dummy_stream & operator<<(const Any & a){return(*this);}
     dummy_stream & operator<<(std::ostream & (*f)(std::ostream&)){return(*this);}
     dummy_stream & operator<<(std::ios & (*f)(std::ios&)){return(*this);}
     dummy_stream & put (char c){return(*this);}
@@ -173,20 +616,433 @@ namespace input {
   };
   //! Strumień na niby.
   dummy_stream & dummy();
+  //! Poziomy logowania najwyższej warstwy logowania w danym wątku.
+  struct layer_mask_t {
+    //! Poziomy logowania, które są aktywne na tej warstwie.
+    flags_t active;
+    //! Poziomy logowania, które powodują opróżnienie bufora na tej warstwie.
+    flags_t dump;
+  };
+  //! Poziomy logowania najwyższej warstwy logowania w bieżącym wątku.
+  extern thread_local layer_mask_t layerMask;
+  //!
+  //! @brief Sprawdza, czy linia na zadanym poziomie logowania zostanie przez kogoś przetworzona.
+  //!
+  //! Linia jest potrzebna, jeśli poziom jest aktywny w najwyższej warstwie i przyjmuje go jakieś wyjście
+  //! albo jeśli poziom powoduje opróżnienie bufora w najwyższej warstwie.
+  //!
+  //! @param [in] severity Wskazanie poziomu logowania.
+  //! @return Wartość true, jeśli linia zostanie przetworzona.
+  //!
+  inline bool enabled(flags_t severity){
+    return(severity&((layerMask.active&output::sinkMask.load(std::memory_order_relaxed))|layerMask.dump));
+  }
+  //! Zamienia wyrażenie logujące na void (pozwala pominąć je w całości w __LOGGER_STREAM__).
+  struct voidify {
+    void operator&(std::ostream &){}
+    void operator&(dummy_stream &){}
+  };
+  //!
+  //! @brief Podaje bieżące okno ograniczenia liczby linii (numer sekundy zegara monotonicznego, od 1).
+  //!
+  uint64_t limiterWindow();
+  //!
+  //! @brief Zapisuje linię z liczbą linii pominiętych przez ograniczenie w danym miejscu w kodzie.
+  //!
+  //! @param [in] severity Wskazanie poziomu logowania.
+  //! @param [in] suppressed Liczba pominiętych linii.
+  //! @param [in] site Miejsce w kodzie.
+  //!
+  void logSuppressed(flags_t severity,uint64_t suppressed,const site_struct & site);
+  struct limiter_t;
+  //!
+  //! @brief Rejestruje ograniczenie, które pominęło linie (wątek porządkowy i LOGGER_FLUSH zgłaszają je, gdy nie ma kolejnych wywołań).
+  //!
+  //! @param [in] limiter Ograniczenie.
+  //! @param [in] severity Wskazanie poziomu logowania.
+  //! @param [in] site Miejsce w kodzie.
+  //!
+  void registerLimiter(limiter_t & limiter,flags_t severity,const site_struct & site);
+  //!
+  //! @brief Stan ograniczenia liczby linii w jednym miejscu w kodzie (bez blokad).
+  //!
+  //! Jest statyczny (inicjowany w czasie kompilacji) i współdzielony przez wszystkie wątki.
+  //!
+  struct limiter_t {
+    //! Liczba wywołań (dla every() i first()).
+    std::atomic<uint64_t> count{0};
+    //! Bieżące okno (starsze 32 bity) i liczba wywołań w nim (młodsze 32 bity) - zmieniane razem (dla rate()).
+    std::atomic<uint64_t> window{0};
+    //! Liczba pominiętych linii, które nie zostały jeszcze zgłoszone (dla rate()).
+    std::atomic<uint64_t> suppressed{0};
+    //! Informacja, że ograniczenie zostało zarejestrowane przez registerLimiter() (dla rate()).
+    std::atomic<bool> registered{false};
+    //!
+    //! @brief Przepuszcza co n-te wywołanie (pierwsze, n+1, 2n+1 ...).
+    //!
+    bool every(uint64_t n){
+      return((count.fetch_add(1,std::memory_order_relaxed)%(n?n:1))==0);
+    }
+    //!
+    //! @brief Przepuszcza n pierwszych wywołań.
+    //!
+    bool first(uint64_t n){
+      if (n<=count.load(std::memory_order_relaxed)) return(false);//Bez zapisu, gdy limit został już wyczerpany.
+      return(count.fetch_add(1,std::memory_order_relaxed)<n);
+    }
+    //!
+    //! @brief Przepuszcza co najwyżej per_sec wywołań w każdej sekundzie.
+    //!
+    //! Pierwsza linia przepuszczona w nowym oknie jest poprzedzona linią z liczbą linii pominiętych wcześniej.
+    //! Jeśli kolejnych wywołań nie ma, tę linię zapisuje wątek porządkowy po zakończeniu okna (lub LOGGER_FLUSH).
+    //!
+    //! @param [in] severity Wskazanie poziomu logowania.
+    //! @param [in] per_sec Limit linii na sekundę.
+    //! @param [in] site Miejsce w kodzie.
+    //!
+    bool rate(flags_t severity,uint64_t per_sec,const site_struct & site){
+      const uint64_t now(limiterWindow()<<32);
+      const uint64_t limit((per_sec<0xffffffff)?per_sec:0xffffffff);
+      uint64_t w(window.load(std::memory_order_relaxed));
+      for (;;){//Nowe okno zaczyna się od zera wywołań - licznik jest zerowany razem ze zmianą okna.
+        const uint64_t next(((w&~uint64_t(0xffffffff))==now)?(w+1):(now|1));
+        if (limit<(next&0xffffffff)){
+          if (!suppressed.fetch_add(1,std::memory_order_relaxed)&&!registered.load(std::memory_order_relaxed)) registerLimiter(*this,severity,site);
+          return(false);
+        }
+        if (window.compare_exchange_weak(w,next,std::memory_order_relaxed)) break;
+      }
+      if (suppressed.load(std::memory_order_relaxed)){
+        const uint64_t n(suppressed.exchange(0,std::memory_order_relaxed));
+        if (n) logSuppressed(severity,n,site);
+      }
+      return(true);
+    }
+  };
+  //! Pola linii strukturalnej przygotowywanej w bieżącym wątku.
+  std::vector<field_t> & fields();
+  //!
+  //! @brief Zapisuje linię strukturalną z polami przygotowanymi w fields() (w najwyższej warstwie logowania w danym wątku).
+  //!
+  //! @param [in] severity Wskazanie poziomu logowania.
+  //! @param [in] site Miejsce w kodzie.
+  //! @param [in] msg Treść linii.
+  //!
+  void logFields(flags_t severity,const site_struct & site,const char * msg);
+  inline void setField(field_t & f,bool v){
+    f.type=field_bool;
+    f.b=v;
+  }
+  template <typename T,typename std::enable_if<std::is_integral<T>::value&&std::is_signed<T>::value,int>::type=0>
+  inline void setField(field_t & f,T v){
+    f.type=field_int;
+    f.i=v;
+  }
+  template <typename T,typename std::enable_if<std::is_integral<T>::value&&std::is_unsigned<T>::value&&!std::is_same<T,bool>::value,int>::type=0>
+  inline void setField(field_t & f,T v){
+    f.type=field_uint;
+    f.u=v;
+  }
+  template <typename T,typename std::enable_if<std::is_floating_point<T>::value,int>::type=0>
+  inline void setField(field_t & f,T v){
+    f.type=field_double;
+    f.d=v;
+  }
+  inline void setField(field_t & f,const char * v){
+    f.type=field_string;
+    if (v) f.s.assign(v);
+  }
+  inline void setField(field_t & f,const std::string & v){
+    f.type=field_string;
+    f.s.assign(v);
+  }
+  inline void setField(field_t & f,std::string_view v){
+    f.type=field_string;
+    f.s.assign(v.data(),v.size());
+  }
+  inline void addFields(std::vector<field_t> &){}
+  //Nazwa pola jest literałem - wskaźnik na inny ciąg znaków mógłby przestać być ważny przed zapisem linii.
+  template <std::size_t N,typename T,typename... Args>
+  inline void addFields(std::vector<field_t> & out,const char (&key)[N],const T & value,const Args & ... args){
+    out.emplace_back();
+    out.back().key=key;
+    setField(out.back(),value);
+    addFields(out,args...);
+  }
+  //!
+  //! @brief Podaje liczbę miejsc na argumenty ({}) w ciągu formatującym (w czasie kompilacji).
+  //!
+  //! Znaki {{ i }} oznaczają pojedyncze nawiasy.
+  //!
+  //! @param [in] fmt Ciąg formatujący.
+  //! @return Liczba miejsc na argumenty lub -1, jeśli nawias nie ma pary.
+  //!
+  constexpr int format_placeholders(const char * fmt){
+    int n=0;
+    for (;*fmt;fmt++){
+      if (*fmt=='{'){
+        if (fmt[1]=='{') fmt++;
+        else if (fmt[1]=='}') {fmt++;n++;}
+        else return(-1);
+      } else if (*fmt=='}'){
+        if (fmt[1]=='}') fmt++;
+        else return(-1);
+      }
+    }
+    return(n);
+  }
+  //! Podaje liczbę argumentów (używana tylko w decltype).
+  template <typename... Args>
+  std::integral_constant<std::size_t,sizeof...(Args)> arg_count(const Args & ...);
+  //!
+  //! @brief Rozpoczyna linię z ciągiem formatującym w najwyższej warstwie logowania w danym wątku.
+  //!
+  //! @param [in] severity Wskazanie poziomu logowania.
+  //! @param [in] site Miejsce w kodzie.
+  //! @param [in] fmt Ciąg formatujący.
+  //! @param [out] deferred Informacja, że linia jest odroczona - należy dopisać wartości argumentów (captureOut), a nie tekst.
+  //! @return Tekst linii, do którego należy dopisać treść, lub nullptr, jeśli poziom nie jest aktywny.
+  //!
+  std::string * beginFormat(flags_t severity,const site_struct & site,const char * fmt,bool & deferred);
+  //!
+  //! @brief Kończy linię rozpoczętą przez beginFormat() (znaki sterujące są zamieniane na spacje).
+  //!
+  void endFormat();
+  inline void formatArg(std::string & out,bool v){
+    out+=(v?"true":"false");
+  }
+  inline void formatArg(std::string & out,char v){
+    out+=v;
+  }
+  template <typename T,typename std::enable_if<std::is_arithmetic<T>::value&&!std::is_same<T,bool>::value&&!std::is_same<T,char>::value,int>::type=0>
+  inline void formatArg(std::string & out,T v){
+    char buffer[32];
+    const std::to_chars_result r(std::to_chars(buffer,buffer+sizeof(buffer),v));
+    out.append(buffer,r.ptr-buffer);
+  }
+  inline void formatArg(std::string & out,const char * v){
+    if (v) out+=v;
+  }
+  inline void formatArg(std::string & out,const std::string & v){
+    out+=v;
+  }
+  inline void formatArg(std::string & out,std::string_view v){
+    out+=v;
+  }
+  //Dopisuje tekst ciągu formatującego do najbliższego miejsca na argument (lub do końca) i podaje, gdzie się zatrzymano.
+  inline const char * formatText(std::string & out,const char * fmt){
+    for (;*fmt;fmt++){
+      if ((fmt[0]=='{')&&(fmt[1]=='}')) return(fmt+2);
+      if (((fmt[0]=='{')||(fmt[0]=='}'))&&(fmt[1]==fmt[0])) fmt++;
+      out+=*fmt;
+    }
+    return(fmt);
+  }
+  inline void formatOut(std::string & out,const char * fmt){
+    formatText(out,fmt);
+  }
+  template <typename T,typename... Args>
+  inline void formatOut(std::string & out,const char * fmt,const T & value,const Args & ... args){
+    fmt=formatText(out,fmt);
+    formatArg(out,value);
+    formatOut(out,fmt,args...);
+  }
+  //! Typy wartości argumentów linii odroczonej.
+  enum capture_type_t {
+    capture_int,
+    capture_uint,
+    capture_float,
+    capture_double,
+    capture_long_double,
+    capture_bool,
+    capture_char,
+    capture_string
+  };
+  //Dopisuje typ i wartość argumentu linii odroczonej.
+  template <typename T>
+  inline void capturePut(std::string & out,capture_type_t type,const T & v){
+    out+=char(type);
+    out.append(reinterpret_cast<const char *>(&v),sizeof(v));
+  }
+  inline void captureArg(std::string & out,bool v){
+    capturePut(out,capture_bool,v);
+  }
+  inline void captureArg(std::string & out,char v){
+    capturePut(out,capture_char,v);
+  }
+  template <typename T,typename std::enable_if<std::is_arithmetic<T>::value&&!std::is_same<T,bool>::value&&!std::is_same<T,char>::value,int>::type=0>
+  inline void captureArg(std::string & out,T v){
+    if constexpr (std::is_same<T,float>::value) capturePut(out,capture_float,v);
+    else if constexpr (std::is_same<T,double>::value) capturePut(out,capture_double,v);
+    else if constexpr (std::is_same<T,long double>::value) capturePut(out,capture_long_double,v);
+    else if constexpr (std::is_signed<T>::value) capturePut(out,capture_int,int64_t(v));
+    else capturePut(out,capture_uint,uint64_t(v));
+  }
+  inline void captureArg(std::string & out,std::string_view v){
+    capturePut(out,capture_string,uint32_t(v.size()));
+    out.append(v.data(),v.size());
+  }
+  inline void captureArg(std::string & out,const char * v){
+    captureArg(out,v?std::string_view(v):std::string_view());
+  }
+  inline void captureArg(std::string & out,const std::string & v){
+    captureArg(out,std::string_view(v));
+  }
+  inline void captureOut(std::string &){}
+  template <typename T,typename... Args>
+  inline void captureOut(std::string & out,const T & value,const Args & ... args){
+    captureArg(out,value);
+    captureOut(out,args...);
+  }
+  //!
+  //! @brief Zapisuje linię z ciągiem formatującym (LOGGER_*_F).
+  //!
+  //! @param [in] severity Wskazanie poziomu logowania.
+  //! @param [in] site Miejsce w kodzie.
+  //! @param [in] fmt Ciąg formatujący - {} oznacza miejsce na kolejny argument.
+  //! @param [in] args Argumenty (liczby, bool, znaki i teksty).
+  //!
+  template <int placeholders,std::size_t count,typename... Args>
+  void format(flags_t severity,const site_struct & site,const char * fmt,const Args & ... args){
+    static_assert(0<=placeholders,"LOGGER_*_F: unmatched { or } in the format string (use {{ and }})");
+    static_assert(std::size_t(placeholders)==count,"LOGGER_*_F: the number of {} placeholders does not match the number of arguments");
+    bool deferred(false);
+    std::string * line(beginFormat(severity,site,fmt,deferred));
+    if (!line) return;
+    if (deferred) captureOut(*line,args...); else formatOut(*line,fmt,args...);
+    endFormat();
+  }
+  //!
+  //! @brief Zapisuje linię strukturalną (LOGGER_*_KV).
+  //!
+  //! @param [in] severity Wskazanie poziomu logowania.
+  //! @param [in] site Miejsce w kodzie.
+  //! @param [in] msg Treść linii.
+  //! @param [in] args Pary: nazwa pola (literał) i wartość (liczba, bool lub tekst).
+  //!
+  template <typename... Args>
+  void kv(flags_t severity,const site_struct & site,const char * msg,const Args & ... args){
+    static_assert((sizeof...(Args)%2)==0,"LOGGER_*_KV expects a message and key/value pairs");
+    std::vector<field_t> & f(fields());
+    f.clear();
+    addFields(f,args...);
+    logFields(severity,site,msg);
+  }
 }
 //!
 //! @brief Restartuje loggera (cały stos jest kasowany).
 //!
+//! Stos bieżącego wątku jest kasowany od razu, a stosy pozostałych wątków przy ich najbliższym użyciu loggera.
+//!
 void restart();
 //!
 //! @brief Ustawia bazowy katalog do ścieżek plików w logerze.
 //!
 void setBaseDir(const std::string & file);
+//!
+//! @brief Ustawia precyzję znacznika czasu.
+//!
+//! @param digits Liczba cyfr ułamka sekundy: 0 (domyślnie), 3 (ms), 6 (us) lub 9 (ns).
+//!
+void setPrecision(unsigned digits=0);
+//!
+//! @brief Podaje statystyki loggera.
+//!
+//! Liczniki są prowadzone osobno przez każdy wątek i sumowane dopiero przy odczycie.
+//!
+//! @return Statystyki (sumy dla wszystkich wątków).
+//!
+stats_t stats();
 //! Wskaźnik do nazwy pliku.
 struct file_struct{const char * path;};
 inline file_struct file(const char * path){return {path};}
 //! Ładuje nazwę pliku
 std::ostream & operator<<(std::ostream & os,file_struct f);
+//! Miejsce w kodzie (plik, linia, funkcja).
+struct site_struct{
+  //! Ścieżka pliku.
+  const char * file;
+  //! Informacja, czy ścieżka jest już względna (wyliczona w czasie kompilacji).
+  bool relative;
+  //! Linia w pliku.
+  unsigned line;
+  //! Nazwa funkcji (bez znaku końca).
+  const char * function;
+  //! Długość nazwy funkcji.
+  std::size_t function_size;
+};
+inline site_struct site(const char * file,bool relative,unsigned line,const char * function,std::size_t function_size){
+  return {file,relative,line,function,function_size};
+}
+//!
+//! @brief Podaje długość katalogu bazowego na początku ścieżki (w czasie kompilacji).
+//!
+//! @param path Ścieżka pliku.
+//! @param base Katalog bazowy (zakończony znakiem '/').
+//! @return Długość katalogu bazowego lub 0, jeśli ścieżka nie zaczyna się od niego.
+//!
+constexpr std::size_t prefix_size(const char * path,const char * base){
+  std::size_t k=0;
+  for (;base[k];k++) if (path[k]!=base[k]) return(0);
+  return(k);
+}
+//!
+//! @brief Podaje długość elementu nazwy, którego nie należy interpretować (np. "(anonymous namespace)", "operator()").
+//!
+constexpr std::size_t function_token(const char * f,std::size_t k){
+  const char * tokens[]={"(anonymous namespace)","{anonymous}","operator"};
+  for (const char * t:tokens){
+    std::size_t n=0;
+    while (t[n]&&(f[k+n]==t[n])) n++;
+    if (t[n]) continue;
+    if (t[0]=='o'){//Operator - pomiń jego symbol aż do listy parametrów.
+      if ((f[k+n]=='(')&&(f[k+n+1]==')')) return(n+2);
+      while (f[k+n]&&(f[k+n]!='(')) n++;
+    }
+    return(n);
+  }
+  return(0);
+}
+//!
+//! @brief Podaje pozycję końca nazwy funkcji (początek listy parametrów) w __PRETTY_FUNCTION__.
+//!
+constexpr std::size_t function_end(const char * f){
+  int depth=0;
+  std::size_t k=0;
+  while (f[k]){
+    if (std::size_t n=function_token(f,k)) {k+=n;continue;}
+    if (f[k]=='<') depth++;
+    if ((f[k]=='>')&&depth) depth--;
+    if ((f[k]=='(')&&!depth) break;
+    k++;
+  }
+  return(k);
+}
+//!
+//! @brief Podaje pozycję początku nazwy funkcji (bez typu zwracanego) w __PRETTY_FUNCTION__.
+//!
+constexpr std::size_t function_begin(const char * f){
+  const std::size_t end=function_end(f);
+  std::size_t begin=0;
+  int depth=0;
+  std::size_t k=0;
+  while (k<end){
+    if (std::size_t n=function_token(f,k)) {k+=n;continue;}
+    if (f[k]=='<') depth++;
+    if ((f[k]=='>')&&depth) depth--;
+    if ((f[k]==' ')&&!depth) begin=k+1;
+    k++;
+  }
+  return(begin);
+}
+//!
+//! @brief Podaje długość nazwy funkcji (bez typu zwracanego i parametrów) w __PRETTY_FUNCTION__.
+//!
+constexpr std::size_t function_size(const char * f){
+  return(function_end(f)-function_begin(f));
+}
+//! Ładuje informacje o miejscu w kodzie (w logerze zapamiętywane przy linii, a nie jako tekst).
+std::ostream & operator<<(std::ostream & os,const site_struct & s);
 //===========================================
 } }
 //===========================================
@@ -0,0 +1,62 @@
+//! @file
+//! @brief Logger module - Flight recorder reader.
+//! @author Mariusz Ornowski (mariusz.ornowski@ict-project.pl)
+//! @version 1.0
+//! @date 2012-2021
+//! @copyright ICT-Project Mariusz Ornowski (ict-project.pl)
+/* **************************************************************
+Copyright (c) 2012-2021, ICT-Project Mariusz Ornowski (ict-project.pl)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+1. Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+3. Neither the name of the ICT-Project Mariusz Ornowski nor the names
+of its contributors may be used to endorse or promote products
+derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**************************************************************/
+//============================================
+#include "logger.hpp"
+#include <iostream>
+#include <string>
+#include <cstdlib>
+//============================================
+//! Wypisuje linie zapisane przez rejestrator (z plików podanych w argumentach, opcja -n ogranicza odczyt do ostatnich N MB).
+int main(int argc,const char **argv){
+  std::size_t limit(0);
+  int k(1);
+  if ((k+1<argc)&&(std::string(argv[k])=="-n")){
+    limit=std::strtoull(argv[k+1],nullptr,10)*1024*1024;
+    k+=2;
+  }
+  if (argc<=k) {
+    std::cerr<<"usage: "<<argv[0]<<" [-n MB] file..."<<std::endl;
+    return(2);
+  }
+  for (;k<argc;k++){
+    if (!ict::logger::output::recover(argv[k],std::cout,limit)) {
+      std::cerr<<argv[k]<<": cannot open file or invalid recorder file"<<std::endl;
+      return(1);
+    }
+  }
+  return(0);
+}
+//===========================================